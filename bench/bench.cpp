@@ -0,0 +1,99 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <numeric>
+
+namespace bench {
+
+    namespace {
+
+        std::map<std::string, Suite>& suites() {
+            static std::map<std::string, Suite> registered;
+            return registered;
+        }
+
+        volatile uint64_t gSink = 0u;
+
+        // a timing in the unit that keeps it short
+        void formatNanoseconds(char* out, size_t size, double ns) {
+            if (ns < 1e3) { std::snprintf(out, size, "%.1f ns", ns); }
+            else if (ns < 1e6) { std::snprintf(out, size, "%.2f us", ns / 1e3); }
+            else if (ns < 1e9) { std::snprintf(out, size, "%.3f ms", ns / 1e6); }
+            else { std::snprintf(out, size, "%.3f s", ns / 1e9); }
+        }
+    }
+
+    bool Runner::wants(const std::string& name) const noexcept {
+        return mOptions.filter.empty() || name.find(mOptions.filter) != std::string::npos;
+    }
+
+    const Result* Runner::find(const std::string& name) const noexcept {
+        for (const Result& result : mResults) {
+            if (result.name == name) { return &result; }
+        }
+        return nullptr;
+    }
+
+    void Runner::value(const std::string& name, double value, const char* unit, bool higherIsBetter) {
+        if (!wants(name)) { return; }
+
+        mResults.push_back({ name, unit, value, value, value, 1u, 1u, higherIsBetter });
+        std::printf("%-44s %14.2f %s\n", name.c_str(), value, unit);
+        std::fflush(stdout);
+    }
+
+    void Runner::record(const std::string& name, uint64_t items) {
+        std::sort(mSamples.begin(), mSamples.end());
+
+        const size_t count = mSamples.size();
+        const double median = count % 2u == 1u ? mSamples[count / 2u] : (mSamples[count / 2u - 1u] + mSamples[count / 2u]) / 2.0;
+        const double mean = std::accumulate(mSamples.begin(), mSamples.end(), 0.0) / static_cast<double>(count);
+        mResults.push_back({ name, "ns", median, mSamples.front(), mean, static_cast<uint32_t>(count), items, false });
+
+        char time[32], perItem[32];
+        formatNanoseconds(time, sizeof(time), median);
+        formatNanoseconds(perItem, sizeof(perItem), median / static_cast<double>(std::max<uint64_t>(items, 1u)));
+        std::printf("%-44s %14s %14s/item %6u samples\n", name.c_str(), time, perItem, static_cast<unsigned>(count));
+        std::fflush(stdout);
+    }
+
+    int registerSuite(const char* name, Suite suite) noexcept {
+        suites()[name] = suite;
+        return static_cast<int>(suites().size());
+    }
+
+    void runSuites(Runner& runner) {
+        for (const auto& suite : suites()) {
+            suite.second(runner);
+        }
+    }
+
+    std::vector<std::string> suiteNames() {
+        std::vector<std::string> names;
+        for (const auto& suite : suites()) {
+            names.push_back(suite.first);
+        }
+        return names;
+    }
+
+    std::string label(const char* name, uint64_t size) {
+        std::string text = name;
+        text += '/';
+        if (size >= 1000000u && size % 1000000u == 0u) {
+            text += std::to_string(size / 1000000u) + "M";
+        }
+        else if (size >= 1000u && size % 1000u == 0u) {
+            text += std::to_string(size / 1000u) + "k";
+        }
+        else {
+            text += std::to_string(size);
+        }
+        return text;
+    }
+
+    void keep(uint64_t value) noexcept {
+        gSink = gSink + value;
+    }
+}
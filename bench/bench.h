@@ -0,0 +1,135 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* A small benchmark harness : suites register themselves with BENCH_SUITE, and time their cases through a Runner.
+* Every case is run once to warm up, then sampled (one call per sample) until it has run for Options::minTimeMs,
+* and reported by the median of its samples, which a few slow samples (the OS, a page fault) do not move
+*/
+namespace bench {
+
+    struct Options {
+        // only the cases whose name contains it, everything when empty
+        std::string filter;
+        // how long each case is sampled for
+        double minTimeMs = 200.0;
+        uint32_t minSamples = 5u;
+        uint32_t maxSamples = 1000u;
+    };
+
+    /**
+    * One case : a timing in nanoseconds per call, or a value measured once (bytes, a percentage...)
+    */
+    struct Result {
+        std::string name;
+        std::string unit;
+        double median;
+        double min;
+        double mean;
+        uint32_t samples;
+        // the work items one call handles, timings are also reported per item
+        uint64_t items;
+        // values like a throughput get better as they grow, timings and sizes as they shrink
+        bool higherIsBetter;
+    };
+
+    class Runner final {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        explicit Runner(const Options& options) : mOptions(options) {}
+
+        /**
+        * @return true if the case passes the filter, for suites to skip setting up what would not be run
+        */
+        bool wants(const std::string& name) const noexcept;
+
+        /**
+        * @brief Times f, with setup run (untimed) before every call
+        * @param items - The work items one call of f handles
+        */
+        template<typename S, typename F>
+        void time(const std::string& name, uint64_t items, S&& setup, F&& f) {
+            if (!wants(name)) { return; }
+
+            setup();
+            f();
+
+            mSamples.clear();
+            const Clock::time_point begin = Clock::now();
+            while (mSamples.size() < mOptions.maxSamples && (mSamples.size() < mOptions.minSamples ||
+                std::chrono::duration<double, std::milli>(Clock::now() - begin).count() < mOptions.minTimeMs)) {
+                setup();
+                const Clock::time_point start = Clock::now();
+                f();
+                mSamples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            }
+            record(name, items);
+        }
+
+        template<typename F>
+        void time(const std::string& name, uint64_t items, F&& f) {
+            time(name, items, []() {}, f);
+        }
+
+        /**
+        * @brief Reports a value that is not a timing
+        */
+        void value(const std::string& name, double value, const char* unit, bool higherIsBetter = false);
+
+        inline const std::vector<Result>& results() const noexcept {
+            return mResults;
+        }
+
+        /**
+        * @return The result of the case, or null if it was not run
+        */
+        const Result* find(const std::string& name) const noexcept;
+
+    private:
+
+        // sorts the samples into a result and prints it
+        void record(const std::string& name, uint64_t items);
+
+        Options mOptions;
+        std::vector<double> mSamples;
+        std::vector<Result> mResults;
+    };
+
+    using Suite = void(*)(Runner& runner);
+
+    /**
+    * @brief Adds a suite, suites run in the order of their names
+    */
+    int registerSuite(const char* name, Suite suite) noexcept;
+
+    /**
+    * @brief Runs every registered suite
+    */
+    void runSuites(Runner& runner);
+
+    std::vector<std::string> suiteNames();
+
+    /**
+    * @return The name of a case with a size in it : label("quadtree/insert", 100000) is "quadtree/insert/100k"
+    */
+    std::string label(const char* name, uint64_t size);
+
+    /**
+    * @brief Keeps the compiler from optimizing away the work behind a result nobody reads
+    */
+    void keep(uint64_t value) noexcept;
+}
+
+#define BENCH_SUITE(name) \
+    static void benchSuite_##name(bench::Runner& runner); \
+    static const int benchSuiteRegistered_##name = bench::registerSuite(#name, &benchSuite_##name); \
+    static void benchSuite_##name(bench::Runner& runner)
+
+#endif // !BENCH_H_
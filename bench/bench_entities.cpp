@@ -0,0 +1,303 @@
+#include "bench.h"
+#include "fixtures.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "../src/core/level/level.h"
+#include "../src/core/level/entity/entity_pkg.h"
+#include "../src/core/level/collider/tile_collision.h"
+
+namespace {
+
+    /**
+    * The way entities used to be simulated, kept here as the baseline of the SoA kernels : one heap allocated object
+    * per entity, updated through a virtual call
+    */
+    class VirtualEntity {
+    public:
+        virtual ~VirtualEntity() = default;
+        virtual void update() noexcept = 0;
+
+        glm::vec2 position;
+        glm::vec2 velocity;
+        bool hitWall;
+    };
+
+    class VirtualGoomba final : public VirtualEntity {
+    public:
+        void update() noexcept override {
+            if (hitWall) { velocity.x = -velocity.x; }
+            velocity.y = std::max(velocity.y - GRAVITY, -TERMINAL_VELOCITY);
+            position += velocity;
+        }
+    };
+
+    // count goombas both ways, the SoA ones all in the one block
+    void virtualVsSoA(bench::Runner& runner, uint32_t count) {
+        std::mt19937 random(3u);
+
+        // allocated in one go then shuffled, the way objects spawned over a level's lifetime end up in memory
+        std::vector<std::unique_ptr<VirtualEntity>> objects;
+        objects.reserve(count);
+        for (uint32_t i = 0u; i < count; i++) {
+            objects.push_back(std::make_unique<VirtualGoomba>());
+            objects.back()->position = { static_cast<float>(i % 2000u), 4.0f };
+            objects.back()->velocity = { -goomba::SPEED, 0.0f };
+            objects.back()->hitWall = i % 64u == 0u;
+        }
+        std::shuffle(objects.begin(), objects.end(), random);
+
+        runner.time(bench::label("entity/virtual", count), count, [&]() {
+            for (const std::unique_ptr<VirtualEntity>& object : objects) {
+                object->update();
+            }
+        });
+
+        EntityStore store;
+        EntityBlock& block = store.block(EntityType::GOOMBA);
+        block.reserve(count);
+        for (uint32_t i = 0u; i < count; i++) {
+            const EntityHandle handle = store.resolve(store.spawn(EntityType::GOOMBA, { static_cast<float>(i % 2000u), 4.0f }));
+            kernels::spawn(block, handle.index(), 0u);
+        }
+
+        uint32_t tick = 0u;
+        runner.time(bench::label("entity/soa", count), count, [&]() {
+            tick++;
+            kernels::update(block, 0u, block.awake, tick);
+            motion::integrate(block.position.data(), block.velocity.data(), block.awake, kernels::motionParams(block.type));
+        });
+    }
+
+    // kills and respawns half of the entities of a full pool every call
+    void poolChurn(bench::Runner& runner, uint32_t count) {
+        EntityStore store;
+        store.reserve(count);
+        EntityBlock& block = store.block(EntityType::GOOMBA);
+        for (uint32_t i = 0u; i < count; i++) {
+            goomba::spawn(block, block.push({ static_cast<float>(i), 2.0f }, { 0.0f, 0.0f }, { 1.0f, 1.0f }), 0u);
+        }
+
+        runner.time(bench::label("entity/churn", count), count, [&]() {
+            for (uint32_t i = 0u; i < block.size(); i += 2u) {
+                block.flags[i] = 0u;
+                block.clip[i] = Clips::NONE;
+            }
+            const uint32_t removed = store.compact();
+            for (uint32_t i = 0u; i < removed; i++) {
+                goomba::spawn(block, block.push({ static_cast<float>(i), 2.0f }, { 0.0f, 0.0f }, { 1.0f, 1.0f }), 0u);
+            }
+        });
+    }
+
+    void integrateIsas(bench::Runner& runner, uint32_t count) {
+        std::vector<glm::vec2> position(count, glm::vec2{ 0.0f, 10.0f });
+        std::vector<glm::vec2> velocity(count, glm::vec2{ 0.01f, 0.0f });
+        const motion::MotionParams params = kernels::motionParams(EntityType::BULLET_BILL);
+
+        const motion::Isa best = motion::detectIsa();
+        for (const motion::Isa isa : { motion::Isa::SCALAR, motion::Isa::SSE2, motion::Isa::AVX }) {
+            if (isa > best) { break; }
+
+            motion::setIsa(isa);
+            const std::string name = std::string("motion/integrate/") + motion::isaName(isa);
+            runner.time(bench::label(name.c_str(), count), count, [&]() {
+                motion::integrate(position.data(), velocity.data(), count, params);
+            });
+        }
+        motion::setIsa(best);
+    }
+
+    void levelTick(bench::Runner& runner, uint32_t count) {
+        const std::string name = bench::label("level/tick", count);
+        if (!runner.wants(name) && !runner.wants(bench::label("level/hash", count))) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, fixtures::widthFor(count), count);
+        fixtures::wakeEverything(level);
+
+        runner.time(name, count, [&]() {
+            level.update();
+        });
+
+        runner.time(bench::label("level/hash", count), count, [&]() {
+            uint64_t hash = 0u;
+            level.entities.forEachBlock([&hash](EntityBlock& block) {
+                hash ^= block.hashAwake(0u, block.awake);
+            });
+            bench::keep(hash);
+        });
+
+        runner.value(bench::label("level/memory", count), static_cast<double>(level.getMemoryUsage()), "bytes");
+    }
+
+    // on a machine with fewer cores than threads, the extra threads only add overhead
+    void threadScaling(bench::Runner& runner, uint32_t count) {
+        double single = 0.0, best = 0.0;
+        for (const uint32_t threads : { 1u, 2u, 4u, 8u, 16u }) {
+            const std::string name = bench::label(("level/threads/" + std::to_string(threads)).c_str(), count);
+            if (!runner.wants(name)) { continue; }
+
+            jobs::JobSystem jobSystem(threads);
+            Level level;
+            fixtures::buildLevel(level, fixtures::widthFor(count), count);
+            fixtures::wakeEverything(level);
+            level.jobSystem = &jobSystem;
+
+            runner.time(name, count, [&]() {
+                level.update();
+            });
+
+            const bench::Result* result = runner.find(name);
+            if (result == nullptr) { continue; }
+            single = threads == 1u ? result->median : single;
+            best = best == 0.0 ? result->median : std::min(best, result->median);
+        }
+
+        if (single > 0.0) {
+            runner.value(bench::label("level/threads/speedup", count), single / best, "x", true);
+        }
+    }
+
+    void tileCollision(bench::Runner& runner, uint32_t count) {
+        const std::string name = bench::label("collision/sweep", count);
+        if (!runner.wants(name)) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, fixtures::widthFor(count), 0u);
+
+        std::mt19937 random(5u);
+        std::uniform_real_distribution<float> column(1.0f, static_cast<float>(level.width - 2));
+        std::uniform_real_distribution<float> row(1.5f, 6.0f);
+        std::uniform_real_distribution<float> speed(-0.2f, 0.2f);
+        std::vector<glm::vec2> startPosition(count), startVelocity(count);
+        for (uint32_t i = 0u; i < count; i++) {
+            startPosition[i] = { column(random), row(random) };
+            startVelocity[i] = { speed(random), speed(random) - 0.1f };
+        }
+
+        std::vector<glm::vec2> position, velocity;
+        const glm::vec2 dimensions{ 1.0f, 1.0f };
+        runner.time(name, count, [&]() {
+            position = startPosition;
+            velocity = startVelocity;
+        }, [&]() {
+            uint64_t hits = 0u;
+            for (uint32_t i = 0u; i < count; i++) {
+                hits += collision::sweep(level, position[i], velocity[i], dimensions, i);
+            }
+            bench::keep(hits);
+        });
+    }
+
+    void tileScans(bench::Runner& runner, int width) {
+        if (!runner.wants("tiles/")) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, width, 0u);
+
+        const uint64_t tiles = static_cast<uint64_t>(level.width) * level.height;
+        runner.time(bench::label("tiles/scan/level", tiles), tiles, [&]() {
+            uint64_t solid = 0u;
+            level.forEachTile(0, 0, level.width - 1, level.height - 1, [&solid](int, int, const Tile& tile) {
+                solid += tile.solid();
+            });
+            bench::keep(solid);
+        });
+
+        // what a camera sees
+        const int columns = 32;
+        const uint64_t window = static_cast<uint64_t>(columns) * level.height;
+        runner.time(bench::label("tiles/scan/camera", window), window, [&]() {
+            uint64_t solid = 0u;
+            level.forEachTile(level.width / 2, 0, level.width / 2 + columns - 1, level.height - 1, [&solid](int, int, const Tile& tile) {
+                solid += tile.solid();
+            });
+            bench::keep(solid);
+        });
+
+        // the broad test of a sweep : is anything solid around an entity, by tiles and by the solid mask
+        const uint32_t queries = 100000u;
+        std::vector<glm::ivec2> around(queries);
+        std::mt19937 random(9u);
+        for (glm::ivec2& corner : around) {
+            corner = { static_cast<int>(random() % static_cast<uint32_t>(level.width)), static_cast<int>(random() % 8u) };
+        }
+        runner.time(bench::label("tiles/any-solid/tiles", queries), queries, [&]() {
+            uint64_t hits = 0u;
+            for (const glm::ivec2& corner : around) {
+                bool any = false;
+                level.forEachTile(corner.x, corner.y, corner.x + 1, corner.y + 2, [&any](int, int, const Tile& tile) {
+                    any |= tile.solid();
+                });
+                hits += any;
+            }
+            bench::keep(hits);
+        });
+        runner.time(bench::label("tiles/any-solid/mask", queries), queries, [&]() {
+            uint64_t hits = 0u;
+            for (const glm::ivec2& corner : around) {
+                hits += level.solidMask.anySolid(corner.x, corner.y, corner.x + 1, corner.y + 2);
+            }
+            bench::keep(hits);
+        });
+
+        runner.value(bench::label("tiles/memory", tiles), static_cast<double>(tiles * sizeof(Tile) + level.solidMask.memoryUsage()), "bytes");
+    }
+
+    void snapshots(bench::Runner& runner, uint32_t count) {
+        if (!runner.wants("snapshot/")) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, fixtures::widthFor(count), count);
+        fixtures::wakeEverything(level);
+
+        SnapshotRing ring(64u);
+        runner.time(bench::label("snapshot/capture", count), count, [&]() {
+            level.update();
+        }, [&]() {
+            ring.capture(level);
+        });
+        runner.value(bench::label("snapshot/delta-bytes", count), static_cast<double>(ring.getNewestFrameBytes()), "bytes");
+
+        // halfway between two keyframes, the most deltas a restore walks
+        const uint64_t back = SnapshotRing::KEYFRAME_INTERVAL / 2u;
+        level.snapshots = &ring;
+        runner.time(bench::label("snapshot/restore", count), count, [&]() {
+            for (uint64_t t = 0u; t < back; t++) {
+                level.update();
+            }
+        }, [&]() {
+            ring.restore(level, level.tick - back);
+        });
+        level.snapshots = nullptr;
+    }
+}
+
+BENCH_SUITE(entities)
+{
+    if (runner.wants("entity/")) {
+        virtualVsSoA(runner, 100000u);
+        poolChurn(runner, 10000u);
+    }
+
+    if (runner.wants("motion/")) {
+        for (const uint32_t count : { 1000u, 100000u, 1000000u }) {
+            integrateIsas(runner, count);
+        }
+    }
+
+    for (const uint32_t count : { 1000u, 10000u, 100000u }) {
+        levelTick(runner, count);
+    }
+    threadScaling(runner, 100000u);
+
+    tileCollision(runner, 100000u);
+    tileScans(runner, 20000);
+
+    for (const uint32_t count : { 1000u, 10000u }) {
+        snapshots(runner, count);
+    }
+}
@@ -0,0 +1,60 @@
+#include "bench.h"
+#include "fixtures.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "../src/core/level/generator.h"
+#include "../src/core/level/level.h"
+#include "../src/core/serializer.h"
+
+namespace {
+
+    void saveLoad(bench::Runner& runner, const std::string& path) {
+        if (!runner.wants("serializer/")) { return; }
+
+        // the levels have no entities, so they are measured by their width
+        for (const int width : { 200, 2000, 20000 }) {
+            Level level;
+            fixtures::buildLevel(level, width, 0u);
+            const uint64_t tiles = static_cast<uint64_t>(level.width) * level.height;
+
+            runner.time(bench::label("serializer/save", width), tiles, [&]() {
+                serializer::saveLevel(&level, path);
+            });
+
+            // saved again in case the save case was filtered out
+            serializer::saveLevel(&level, path);
+            Level loaded;
+            runner.time(bench::label("serializer/load", width), tiles, [&]() {
+                serializer::loadLevel(&loaded, path);
+            });
+
+            runner.value(bench::label("serializer/file-bytes", width), static_cast<double>(std::filesystem::file_size(path)), "bytes");
+        }
+    }
+
+    // a level streamed straight into a file, the size the generator is meant for
+    void generate(bench::Runner& runner, const std::string& path, int width) {
+        const std::string name = bench::label("generator/write", width);
+        if (!runner.wants(name)) { return; }
+
+        generator::GeneratorOptions options;
+        options.width = width;
+        runner.time(name, static_cast<uint64_t>(width) * options.height, [&]() {
+            generator::writeLevel(options, path);
+        });
+    }
+}
+
+BENCH_SUITE(io)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "platformer_bench.lvl").string();
+
+    saveLoad(runner, path);
+    generate(runner, path, 1000000);
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,96 @@
+#include "bench.h"
+#include "fixtures.h"
+
+#include "../src/app/server.h"
+#include "../src/core/level/level.h"
+#include "../src/core/net/replication.h"
+
+namespace {
+
+    // what a rollback costs : going back a few ticks and simulating them again, every one captured
+    void rollback(bench::Runner& runner, uint32_t count, uint32_t depth) {
+        const std::string name = bench::label(("rollback/depth-" + std::to_string(depth)).c_str(), count);
+        if (!runner.wants(name)) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, fixtures::widthFor(count), count);
+        fixtures::wakeEverything(level);
+
+        SnapshotRing ring(64u);
+        level.snapshots = &ring;
+        for (uint32_t t = 0u; t <= depth; t++) {
+            level.update();
+        }
+
+        runner.time(name, depth, [&]() {
+            ring.restore(level, level.tick - depth);
+            for (uint32_t t = 0u; t < depth; t++) {
+                level.update();
+            }
+        });
+        level.snapshots = nullptr;
+    }
+
+    void replication(bench::Runner& runner, uint32_t count) {
+        if (!runner.wants("replication/")) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, fixtures::widthFor(count), count);
+        fixtures::wakeEverything(level);
+        level.update();
+
+        net::ReplicationEncoder encoder;
+        std::vector<uint8_t> message;
+
+        // a new spectator, everything is sent
+        runner.time(bench::label("replication/encode-full", count), count, [&]() {
+            encoder.reset();
+        }, [&]() {
+            encoder.encode(level, message);
+        });
+        runner.value(bench::label("replication/full-bytes", count), static_cast<double>(message.size()), "bytes");
+
+        // a spectator that acknowledged the last tick, only what changed since is sent
+        encoder.reset();
+        encoder.encode(level, message);
+        runner.time(bench::label("replication/encode-delta", count), count, [&]() {
+            encoder.acknowledge(level.tick);
+            level.update();
+        }, [&]() {
+            encoder.encode(level, message);
+        });
+        runner.value(bench::label("replication/delta-bytes", count), static_cast<double>(message.size()), "bytes");
+    }
+
+    // one tick of every match of a server, on every hardware thread
+    void server(bench::Runner& runner, uint32_t matches) {
+        const std::string name = bench::label("server/step", matches);
+        if (!runner.wants(name)) { return; }
+
+        LevelServer levels;
+        const double tickRate = 60.0;
+        for (uint32_t m = 0u; m < matches; m++) {
+            levels.addMatch(nullptr, tickRate, 1000.0 / tickRate);
+        }
+
+        // the server's clock moves a tick per call whatever the time, so every match ticks exactly once
+        const LevelServer::Clock::duration period = std::chrono::duration_cast<LevelServer::Clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+        LevelServer::Clock::time_point now = LevelServer::Clock::now();
+        runner.time(name, matches, [&]() {
+            now += period;
+            levels.step(now);
+        });
+    }
+}
+
+BENCH_SUITE(net)
+{
+    for (const uint32_t count : { 1000u, 10000u }) {
+        rollback(runner, count, 8u);
+        replication(runner, count);
+    }
+
+    for (const uint32_t matches : { 10u, 100u }) {
+        server(runner, matches);
+    }
+}
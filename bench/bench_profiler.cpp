@@ -0,0 +1,43 @@
+#include "bench.h"
+
+#include "../src/core/profiler/alloc_tracker.h"
+#include "../src/core/profiler/profiler.h"
+
+namespace {
+
+    // fewer than a thread's ring holds, so none are dropped
+    constexpr uint32_t SCOPES = 4000u;
+
+    void scopes() noexcept {
+        for (uint32_t i = 0u; i < SCOPES; i++) {
+            PROFILE_SCOPE("bench scope");
+        }
+    }
+}
+
+BENCH_SUITE(profiler)
+{
+    if (!runner.wants("profiler/")) { return; }
+
+    // the other suites run with the profiler off
+    profiler::setEnabled(true);
+
+    runner.time(bench::label("profiler/scope/on", SCOPES), SCOPES, []() {
+        profiler::endFrame();
+    }, scopes);
+
+    profiler::setAllocTracking(true);
+    runner.time(bench::label("profiler/scope/tracking", SCOPES), SCOPES, []() {
+        profiler::endFrame();
+    }, scopes);
+    profiler::setAllocTracking(false);
+
+    runner.time(bench::label("profiler/end-frame", SCOPES), SCOPES, scopes, []() {
+        profiler::endFrame();
+    });
+
+    profiler::setEnabled(false);
+    runner.time(bench::label("profiler/scope/off", SCOPES), SCOPES, scopes);
+
+    profiler::clearHistory();
+}
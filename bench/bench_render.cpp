@@ -0,0 +1,150 @@
+#include "bench.h"
+#include "fixtures.h"
+
+#include <algorithm>
+#include <random>
+
+#include "../src/app/frame_pipeline.h"
+#include "../src/core/level/level.h"
+#include "../src/graphics/particle.h"
+#include "../src/graphics/recording_backend.h"
+#include "../src/graphics/sprite_atlas.h"
+#include "../src/graphics/sprite_batch.h"
+
+namespace {
+
+    void batches(bench::Runner& runner, uint32_t count) {
+        if (!runner.wants("batch/")) { return; }
+
+        const SpriteAtlas& atlas = fixtures::atlas();
+        std::mt19937 random(17u);
+        std::uniform_real_distribution<float> column(0.0f, 64.0f);
+        std::uniform_real_distribution<float> row(0.0f, 26.0f);
+
+        RenderList still;
+        RenderList animated;
+        for (uint32_t i = 0u; i < count; i++) {
+            const glm::vec2 position{ column(random), row(random) };
+            still.buffer(position, 1u + i % 16u);
+            animated.bufferClip(position, static_cast<uint16_t>(Clips::GOOMBA_WALK + i % (Clips::COUNT - 1u)), i % 60u);
+        }
+
+        SpriteBatch batch;
+        runner.time(bench::label("batch/static", count), count, [&]() {
+            batch.build(still, atlas);
+        });
+        runner.time(bench::label("batch/animated", count), count, [&]() {
+            batch.build(animated, atlas);
+        });
+    }
+
+    void renderList(bench::Runner& runner, uint32_t count) {
+        const std::string name = bench::label("level/render-list", count);
+        if (!runner.wants(name)) { return; }
+
+        Level level;
+        fixtures::buildLevel(level, fixtures::widthFor(count), count);
+        level.animations = &fixtures::atlas().getAnimations();
+
+        // the whole level, every tile and entity
+        RenderList list;
+        runner.time(name, count, [&]() {
+            list.clear();
+            level.buildRenderList(list, 0.0f, static_cast<float>(level.width));
+        });
+    }
+
+    void particles(bench::Runner& runner, uint32_t count) {
+        if (!runner.wants("particles/")) { return; }
+
+        ParticleSystem system(count / PARTICLE_TYPE_COUNT);
+        std::mt19937 random(19u);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+        uint32_t tick = 0u;
+        const auto emitAll = [&]() {
+            for (uint32_t i = 0u; i < count; i++) {
+                const ParticleType type = static_cast<ParticleType>(i % PARTICLE_TYPE_COUNT);
+                system.emit(type, { 100.0f + offset(random), 10.0f }, { offset(random) * 0.1f, 0.1f }, tick);
+            }
+        };
+        // every call starts on a later tick, emitting into an older one is ignored
+        const auto nextTick = [&]() {
+            tick += 2u;
+            system.clear();
+        };
+
+        runner.time(bench::label("particles/emit", count), count, nextTick, emitAll);
+        runner.time(bench::label("particles/update", count), count, [&]() {
+            nextTick();
+            emitAll();
+        }, [&]() {
+            system.update(tick + 1u);
+        });
+
+        RenderList list;
+        runner.time(bench::label("particles/draw", count), count, [&]() {
+            list.clear();
+            system.draw(list);
+        });
+    }
+
+    // one frame of the headless pipeline, with the simulation run inline or overlapped with the render
+    void pipeline(bench::Runner& runner, uint32_t count) {
+        if (!runner.wants("pipeline/")) { return; }
+
+        const SpriteAtlas& atlas = fixtures::atlas();
+        jobs::JobSystem jobSystem;
+        double serialMs = 0.0;
+
+        for (jobs::JobSystem* workers : { static_cast<jobs::JobSystem*>(nullptr), &jobSystem }) {
+            Level level;
+            fixtures::buildLevel(level, fixtures::widthFor(count), count);
+            fixtures::wakeEverything(level);
+            level.animations = &atlas.getAnimations();
+            level.jobSystem = workers;
+
+            RecordingBackend backend(&atlas.getClipTable());
+            FramePipeline frames(&level, &atlas, &backend, workers);
+            Camera camera;
+
+            const std::string name = bench::label(workers == nullptr ? "pipeline/frame/serial" : "pipeline/frame/jobs", count);
+            runner.time(name, count, [&]() {
+                frames.frame(&camera);
+            });
+
+            const bench::Result* result = runner.find(name);
+            if (result == nullptr) { continue; }
+            if (workers == nullptr) {
+                serialMs = result->median;
+                continue;
+            }
+            const double overlappedMs = result->median;
+
+            // how much of the render the simulation hid, the way FramePipeline::report counts it
+            double simulate = 0.0, render = 0.0, wall = 0.0;
+            for (const FrameTiming& timing : frames.getTimings()) {
+                simulate += timing.simulate;
+                render += timing.render;
+                wall += timing.wall;
+            }
+            const double shorter = std::min(simulate, render);
+            const double hidden = shorter > 0.0 ? std::min(100.0, 100.0 * std::max(0.0, simulate + render - wall) / shorter) : 0.0;
+            runner.value(bench::label("pipeline/hidden", count), hidden, "%", true);
+
+            if (serialMs > 0.0) {
+                runner.value(bench::label("pipeline/speedup", count), serialMs / overlappedMs, "x", true);
+            }
+        }
+    }
+}
+
+BENCH_SUITE(render)
+{
+    for (const uint32_t count : { 1000u, 10000u, 100000u }) {
+        batches(runner, count);
+    }
+    renderList(runner, 100000u);
+    particles(runner, 200000u);
+    pipeline(runner, 10000u);
+}
@@ -0,0 +1,113 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <random>
+
+#include "../src/core/level/level.h"
+
+namespace {
+
+    constexpr float WIDTH = 2000.0f;
+    constexpr float HEIGHT = 26.0f;
+
+    std::vector<EntityRef> randomRefs(uint32_t count) {
+        std::mt19937 random(11u);
+        std::uniform_real_distribution<float> x(0.0f, WIDTH - 1.0f);
+        std::uniform_real_distribution<float> y(0.0f, HEIGHT - 1.0f);
+
+        std::vector<EntityRef> refs(count);
+        for (uint32_t i = 0u; i < count; i++) {
+            refs[i] = { { x(random), y(random) }, nullptr, i };
+        }
+        return refs;
+    }
+
+    std::vector<Quad> randomQuads(uint32_t count) {
+        std::mt19937 random(13u);
+        std::uniform_real_distribution<float> x(0.0f, 64.0f);
+        std::uniform_real_distribution<float> size(0.5f, 2.0f);
+
+        std::vector<Quad> quads(count);
+        for (Quad& quad : quads) {
+            const glm::vec2 bottomLeft{ x(random), x(random) * 0.25f };
+            quad = Quad(bottomLeft, bottomLeft + glm::vec2{ size(random), size(random) });
+        }
+        return quads;
+    }
+}
+
+BENCH_SUITE(spatial)
+{
+    const uint32_t QUADS = 1000000u;
+    if (runner.wants("quad/")) {
+        const std::vector<Quad> a = randomQuads(QUADS);
+        std::vector<Quad> b = a;
+        std::rotate(b.begin(), b.begin() + 1, b.end());
+
+        runner.time(bench::label("quad/intersects", QUADS), QUADS, [&]() {
+            uint64_t hits = 0u;
+            for (uint32_t i = 0u; i < QUADS; i++) {
+                hits += a[i].intersectsQuad(b[i]);
+            }
+            bench::keep(hits);
+        });
+        runner.time(bench::label("quad/overlaps", QUADS), QUADS, [&]() {
+            uint64_t hits = 0u;
+            for (uint32_t i = 0u; i < QUADS; i++) {
+                hits += a[i].overlapsQuad(b[i]);
+            }
+            bench::keep(hits);
+        });
+    }
+
+    for (const uint32_t count : { 1000u, 10000u, 100000u }) {
+        if (!runner.wants("quadtree/")) { break; }
+
+        std::vector<EntityRef> refs = randomRefs(count);
+        Quadtree<EntityRef> tree({ 0.0f, 0.0f }, { WIDTH, HEIGHT });
+        tree.reserve(count);
+
+        // in spawn order, the entities all over the level
+        runner.time(bench::label("quadtree/insert", count), count, [&]() {
+            tree.clear();
+            for (EntityRef& ref : refs) {
+                tree.insert(&ref);
+            }
+        });
+
+        // what the level does every tick : sorted left to right, then inserted
+        std::vector<EntityRef> sorted;
+        sorted.reserve(count);
+        const auto byColumn = [](const EntityRef& a, const EntityRef& b) {
+            return a.position.x < b.position.x;
+        };
+        runner.time(bench::label("quadtree/rebuild", count), count, [&]() {
+            sorted.assign(refs.begin(), refs.end());
+            std::sort(sorted.begin(), sorted.end(), byColumn);
+            tree.clear();
+            for (EntityRef& ref : sorted) {
+                tree.insert(&ref);
+            }
+        });
+
+        // the narrow phase's query, a block around every entity
+        sorted.assign(refs.begin(), refs.end());
+        std::sort(sorted.begin(), sorted.end(), byColumn);
+        tree.clear();
+        for (EntityRef& ref : sorted) {
+            tree.insert(&ref);
+        }
+
+        std::vector<EntityRef*> nearby;
+        nearby.reserve(64u);
+        runner.time(bench::label("quadtree/query", count), count, [&]() {
+            uint64_t found = 0u;
+            for (const EntityRef& ref : sorted) {
+                nearby.clear();
+                tree.query({ ref.position - glm::vec2{ 1.0f, 1.0f }, ref.position + glm::vec2{ 2.0f, 2.0f } }, &nearby);
+                found += nearby.size();
+            }
+            bench::keep(found);
+        });
+    }
+}
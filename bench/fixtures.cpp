@@ -0,0 +1,61 @@
+#include "fixtures.h"
+
+#include <algorithm>
+#include <random>
+
+#include "../src/app/headless.h"
+#include "../src/core/level/level.h"
+#include "../src/core/level/entity/entity_pkg.h"
+#include "../src/graphics/sprite_atlas.h"
+#include "../src/graphics/sprite_ids.h"
+
+namespace fixtures {
+
+    int widthFor(uint32_t entities) noexcept {
+        return std::max(200, static_cast<int>(entities / 5u));
+    }
+
+    void buildLevel(Level& level, int width, uint32_t entities, uint32_t seed) {
+
+        level.resizeTiles(width, 26);
+
+        for (int x = 0; x < width; x++) {
+            level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1), x, 0);
+            level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1), x, 1);
+
+            if (x % 24 == 0) {
+                for (int y = 2; y < 5; y++) {
+                    level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::STONE), x, y);
+                }
+            }
+            else if (x % 7 == 0) {
+                level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::STONE), x, 2);
+            }
+        }
+
+        // no type gets more than 40% of the entities, so each block stays well under EntityBlock::MAX_SLOTS
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> column(1.0f, static_cast<float>(width - 2));
+        std::uniform_real_distribution<float> row(3.0f, 12.0f);
+        for (uint32_t e = 0u; e < entities; e++) {
+            const uint32_t kind = e % 5u;
+            const EntityType type = kind < 2u ? EntityType::GOOMBA : koopa::getType(kind == 2u || (kind == 4u && e % 2u == 0u), kind == 4u);
+            level.addEntity(type, { column(random), row(random) });
+        }
+
+        level.play = true;
+    }
+
+    void wakeEverything(Level& level) noexcept {
+        // a single sector, which the player's window always overlaps
+        level.activation.resize(1);
+        level.entities.wakeAll();
+    }
+
+    const SpriteAtlas& atlas() {
+        static SpriteAtlas loaded;
+        static bool once = (loadHeadlessAtlas(loaded), true);
+        (void)once;
+        return loaded;
+    }
+}
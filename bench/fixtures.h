@@ -0,0 +1,38 @@
+#ifndef BENCH_FIXTURES_H_
+#define BENCH_FIXTURES_H_
+
+#include <cstdint>
+
+class Level;
+class SpriteAtlas;
+
+/**
+* What the suites run on : levels built from a few numbers instead of level files, so a case does the same work
+* on every machine and every build
+*/
+namespace fixtures {
+
+    /**
+    * @return A width that spreads that many entities about as thinly as a hand made level does, at least 200 columns
+    */
+    int widthFor(uint32_t entities) noexcept;
+
+    /**
+    * @brief Resizes the level to width columns, lays a ground with a wall every 24 columns and a step every 7, and
+    * spawns the entities at random over it : 40% goombas, the rest koopas of every color, with and without wings.
+    * The same arguments always build the same level
+    */
+    void buildLevel(Level& level, int width, uint32_t entities, uint32_t seed = 7u);
+
+    /**
+    * @brief Keeps every entity of the level awake however far it is from the player, so a tick simulates them all
+    */
+    void wakeEverything(Level& level) noexcept;
+
+    /**
+    * @return The game's atlas, loaded the first time (see loadHeadlessAtlas, run from the repository's root)
+    */
+    const SpriteAtlas& atlas();
+}
+
+#endif // !BENCH_FIXTURES_H_
@@ -0,0 +1,200 @@
+#include "bench.h"
+
+#include "../src/core/json.h"
+#include "../src/core/level/entity/motion.h"
+#include "../src/core/profiler/profiler.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+
+namespace {
+
+    bool writeJson(const std::string& path, const std::vector<bench::Result>& results) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << __FUNCTION__ << " Could not open \"" << path << "\"\n";
+            return false;
+        }
+
+        nlohmann::json context;
+        context["threads"] = std::thread::hardware_concurrency();
+        context["isa"] = motion::isaName(motion::detectIsa());
+#ifdef NDEBUG
+        context["build"] = "release";
+#else
+        context["build"] = "debug";
+#endif
+#if defined(_MSC_VER)
+        context["compiler"] = "msvc " + std::to_string(_MSC_VER);
+#elif defined(__clang__)
+        context["compiler"] = "clang " __clang_version__;
+#elif defined(__GNUC__)
+        context["compiler"] = "gcc " __VERSION__;
+#endif
+
+        nlohmann::json benchmarks = nlohmann::json::array();
+        for (const bench::Result& result : results) {
+            nlohmann::json entry;
+            entry["name"] = result.name;
+            entry["unit"] = result.unit;
+            entry["median"] = result.median;
+            entry["min"] = result.min;
+            entry["mean"] = result.mean;
+            entry["samples"] = result.samples;
+            entry["items"] = result.items;
+            entry["per_item"] = result.median / static_cast<double>(result.items > 0u ? result.items : 1u);
+            entry["higher_is_better"] = result.higherIsBetter;
+            benchmarks.push_back(entry);
+        }
+
+        nlohmann::json root;
+        root["context"] = context;
+        root["benchmarks"] = benchmarks;
+        file << root.dump(2) << "\n";
+        return true;
+    }
+
+    bool readJson(const char* path, std::vector<bench::Result>& results) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << __FUNCTION__ << " Could not open \"" << path << "\"\n";
+            return false;
+        }
+
+        // a missing or renamed key throws too, the whole file is rejected
+        try {
+            nlohmann::json root;
+            file >> root;
+            for (const auto& entry : root.at("benchmarks")) {
+                bench::Result result;
+                result.name = entry.at("name").get<std::string>();
+                result.unit = entry.at("unit").get<std::string>();
+                result.median = entry.at("median").get<double>();
+                result.min = entry.at("min").get<double>();
+                result.mean = entry.at("mean").get<double>();
+                result.samples = entry.at("samples").get<uint32_t>();
+                result.items = entry.at("items").get<uint64_t>();
+                result.higherIsBetter = entry.at("higher_is_better").get<bool>();
+                results.push_back(result);
+            }
+        }
+        catch (const nlohmann::json::exception& e) {
+            std::cerr << __FUNCTION__ << " \"" << path << "\" is not a results file : " << e.what() << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Compares the medians of two result files, case by case
+    * @return 1 if a case got worse by more than threshold percent, 0 otherwise
+    */
+    int compare(const char* basePath, const char* newPath, double threshold) {
+        std::vector<bench::Result> base, current;
+        if (!readJson(basePath, base) || !readJson(newPath, current)) {
+            return 2;
+        }
+
+        std::map<std::string, const bench::Result*> byName;
+        for (const bench::Result& result : base) {
+            byName[result.name] = &result;
+        }
+
+        uint32_t regressions = 0u, improvements = 0u;
+        std::printf("%-44s %14s %14s %9s\n", "case", "base", "new", "change");
+        for (const bench::Result& result : current) {
+            const auto found = byName.find(result.name);
+            if (found == byName.end()) {
+                std::printf("%-44s %14s %14.1f %9s  new\n", result.name.c_str(), "-", result.median, "");
+                continue;
+            }
+
+            const bench::Result& old = *found->second;
+            byName.erase(found);
+            if (old.median <= 0.0) {
+                std::printf("%-44s %14.1f %14.1f %9s\n", result.name.c_str(), old.median, result.median, "");
+                continue;
+            }
+
+            const double change = (result.median - old.median) / old.median * 100.0;
+            const double worse = result.higherIsBetter ? -change : change;
+            const char* verdict = "";
+            if (worse > threshold) {
+                verdict = "  REGRESSION";
+                regressions++;
+            }
+            else if (worse < -threshold) {
+                verdict = "  improved";
+                improvements++;
+            }
+            std::printf("%-44s %14.1f %14.1f %+8.1f%%%s\n", result.name.c_str(), old.median, result.median, change, verdict);
+        }
+        for (const auto& missing : byName) {
+            std::printf("%-44s %14.1f %14s %9s  missing\n", missing.first.c_str(), missing.second->median, "-", "");
+        }
+
+        std::printf("\n%u regressions, %u improvements beyond %.1f%%\n", regressions, improvements, threshold);
+        return regressions > 0u ? 1 : 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // platformer_bench --compare base.json new.json [--threshold percent]
+    if (argc > 3 && std::strcmp(argv[1], "--compare") == 0) {
+        double threshold = 5.0;
+        if (argc > 5 && std::strcmp(argv[4], "--threshold") == 0) {
+            threshold = std::atof(argv[5]);
+        }
+        return compare(argv[2], argv[3], threshold);
+    }
+
+    // platformer_bench [--filter text] [--json results.json] [--min-time ms] [--quick] [--list]
+    bench::Options options;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minTimeMs = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--quick") == 0) {
+            // a smoke run, the numbers are noisy
+            options.minTimeMs = 10.0;
+            options.minSamples = 1u;
+        }
+        else if (std::strcmp(argv[i], "--list") == 0) {
+            for (const std::string& name : bench::suiteNames()) {
+                std::printf("%s\n", name.c_str());
+            }
+            return 0;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argv[i] << "\"\n";
+            return 2;
+        }
+    }
+
+    std::printf("%u hardware threads, %s\n\n", std::thread::hardware_concurrency(), motion::isaName(motion::detectIsa()));
+
+    // the engine's scopes would be timed with everything else, the profiler suite measures them on their own
+    profiler::setEnabled(false);
+
+    bench::Runner runner(options);
+    bench::runSuites(runner);
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, runner.results())) {
+        return 2;
+    }
+    return 0;
+}
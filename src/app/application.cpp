@@ -1,5 +1,7 @@
 #include "application.h"
 
+// ticks of play mode that can be rewound, 10 seconds
+#define HISTORY_LENGTH (600u)
 
 Application::Application(int width, int height, const char* appTitle) : mWidth(width), mHeight(height), 
 mCursorX(0.0), mCursorY(0.0), mCursorLastX(0.0), mCursorLastY(0.0), mState(ApplicationState::HOME)
@@ -40,10 +42,21 @@ mCursorX(0.0), mCursorY(0.0), mCursorLastX(0.0), mCursorLastY(0.0), mState(Appli
 
 Application::~Application() noexcept
 {
+    if (mPipeline) {
+        mPipeline->report(std::cout);
+    }
+
+    if (mLevel && !mRecordPath.empty()) {
+        mLevel->saveInputRecording(mRecordPath);
+    }
+
+    delete mPipeline;
     delete mRenderer;
     delete mLineRenderer;
     delete mEditor;
     delete mLevel;
+    delete mHistory;
+    delete mJobSystem;
     glfwTerminate();
     std::cout << "Exited succesfully\n";
 }
@@ -52,27 +65,54 @@ void Application::start() noexcept
 {
     if (this->error) return;
 
+    profiler::setThreadName("main");
+    mJobSystem = new jobs::JobSystem();
     mLevel = new Level();
+    mLevel->jobSystem = mJobSystem;
+    mHistory = new SnapshotRing(HISTORY_LENGTH);
+    mLevel->snapshots = mHistory;
     mRenderer = new Renderer();
     mLineRenderer = new LineRenderer();
+    mLineRenderer->gpuTimer = &mRenderer->getGpuTimer();
     mEditor = new Editor(this);
     mEditor->activate();
     mEditor->setLevelForEditing(mLevel);
+    mPipeline = new FramePipeline(mLevel, &mRenderer->getAtlas(), mRenderer, mJobSystem);
+
+    if (!mReplayPath.empty()) {
+        mLevel->loadInputReplay(mReplayPath);
+    }
+    if (!mRecordPath.empty()) {
+        mLevel->startInputRecording();
+    }
 
     while (!glfwWindowShouldClose(mWindow))
     {
         glClear(GL_COLOR_BUFFER_BIT);
 
-        mLevel->draw(mRenderer);
-        mRenderer->render(mEditor->mCamera);
+        // simulates the next tick on the workers while the last one is drawn
+        mPipeline->frame(mEditor->mCamera);
 
+        // the level is only edited between frames
         mEditor->draw();
 
         glfwSwapBuffers(mWindow);
         glfwPollEvents();
+        mLevel->pollInput();
+
+        mRenderer->getGpuTimer().endFrame();
+        profiler::endFrame();
     }
 }
 
+void Application::recordInput(const char* intoFile) noexcept {
+    mRecordPath = intoFile;
+}
+
+void Application::replayInput(const char* fromFile) noexcept {
+    mReplayPath = fromFile;
+}
+
 void Application::draw() noexcept {
 
     ImGui_ImplOpenGL3_NewFrame();
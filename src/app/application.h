@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <string>
 
 #include <glad/glad.h>
 
@@ -12,6 +13,9 @@
 #include "../editor/editor.h"
 
 #include "../core/level/level.h"
+#include "../core/jobs/job_system.h"
+#include "../core/profiler/profiler.h"
+#include "frame_pipeline.h"
 #include "../graphics/renderer.h"
 #include "../graphics/line_renderer.h"
 
@@ -35,6 +39,16 @@ public:
 
     void start(void) noexcept;
 
+    /**
+    * @brief Records the players' input from the first tick, and saves it into the file on exit. Call before start
+    */
+    void recordInput(const char* intoFile) noexcept;
+
+    /**
+    * @brief Plays the players' input back from the file instead of the gamepads. Call before start
+    */
+    void replayInput(const char* fromFile) noexcept;
+
     void onMouseEvent(GLFWwindow*, int, int, int) noexcept;
     void onKeyboardEvent(GLFWwindow*, int, int, int, int) noexcept;
     void onScrollEvent(GLFWwindow*, double, double) noexcept;
@@ -49,6 +63,10 @@ public:
     Renderer* mRenderer = nullptr;
     LineRenderer* mLineRenderer = nullptr;
     Level* mLevel = nullptr;
+    jobs::JobSystem* mJobSystem = nullptr;
+    FramePipeline* mPipeline = nullptr;
+    // the last ticks of play mode, for rewinding
+    SnapshotRing* mHistory = nullptr;
 
 private:
 
@@ -62,4 +80,7 @@ private:
 
     int error = 0;
     Editor* mEditor = nullptr;
+
+    std::string mRecordPath;
+    std::string mReplayPath;
 };
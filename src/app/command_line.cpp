@@ -0,0 +1,158 @@
+#include "command_line.h"
+#include "desync.h"
+#include "netplay.h"
+#include "server.h"
+#include "../core/level/generator.h"
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+
+bool runCommandLine(int argc, char** argv, HeadlessOptions& options, int& exitCode) noexcept
+{
+    // --compare-hashes a.log b.log
+    if (argc > 3 && std::strcmp(argv[1], "--compare-hashes") == 0) {
+        exitCode = desync::compareHashLogs(argv[2], argv[3]);
+        return true;
+    }
+
+    // --generate out.lvl [width] [--height h] [--seed s] [--enemies perColumn]
+    if (argc > 2 && std::strcmp(argv[1], "--generate") == 0) {
+        generator::GeneratorOptions generate;
+        for (int i = 3; i < argc; i++) {
+            if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+                generate.height = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+                generate.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+            }
+            else if (std::strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+                generate.enemyDensity = std::atof(argv[++i]);
+            }
+            else if (std::atoi(argv[i]) > 0) {
+                generate.width = std::atoi(argv[i]);
+            }
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        if (generator::writeLevel(generate, argv[2]) != 0) {
+            exitCode = 1;
+            return true;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Generated " << argv[2] << " : " << generate.width << " columns, seed " << generate.seed
+            << ", in " << seconds << " s\n";
+        exitCode = 0;
+        return true;
+    }
+
+    // --server [matches] [level.lvl] [--replay input.inp] [--seconds s] [--rate hz] [--threads n]
+    //          [--budget ms] [--trace trace.json]
+    if (argc > 1 && std::strcmp(argv[1], "--server") == 0) {
+        ServerOptions server;
+        for (int i = 2; i < argc; i++) {
+            if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+                server.replayPath = argv[++i];
+            }
+            else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+                server.seconds = std::atof(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+                server.tickRate = std::atof(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+                server.threads = (uint32_t)std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+                server.budgetMs = std::atof(argv[++i]);
+            }
+            else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+                server.tracePath = argv[++i];
+            }
+            else if (std::atoi(argv[i]) > 0) {
+                server.matchCount = std::atoi(argv[i]);
+            }
+            else {
+                server.levelPath = argv[i];
+            }
+        }
+        exitCode = runServer(server);
+        return true;
+    }
+
+    // --netplay player localPort remoteHost remotePort [ticks] [level.lvl] [--replay input.inp]
+    int netplayArgs = 0;
+    if (argc > 5 && std::strcmp(argv[1], "--netplay") == 0) {
+        netplayArgs = 4;
+    }
+
+    // [--headless | --desync | --rollback | --spectate] [ticks] [level.lvl] [--record input.inp]
+    //     [--replay input.inp] [--hash-log hashes.log] [--trace trace.json] [--alloc-budget n] [--threads a b]
+    //     [--latency ms] [--jitter ms] [--loss percent] [--entities n]
+    const bool headless = argc > 1 && std::strcmp(argv[1], "--headless") == 0;
+    const bool desyncCheck = argc > 1 && std::strcmp(argv[1], "--desync") == 0;
+    const bool rollback = argc > 1 && std::strcmp(argv[1], "--rollback") == 0;
+    const bool spectate = argc > 1 && std::strcmp(argv[1], "--spectate") == 0;
+    const bool offline = headless || desyncCheck || rollback || spectate || netplayArgs > 0;
+    uint32_t threadsA = 1u, threadsB = 0u;
+    net::LoopbackConfig link;
+    int entityCount = 100;
+
+    for (int i = offline ? 2 + netplayArgs : 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options.replayPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--hash-log") == 0 && i + 1 < argc) {
+            options.hashLogPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--alloc-budget") == 0 && i + 1 < argc) {
+            options.allocBudget = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 2 < argc) {
+            threadsA = (uint32_t)std::atoi(argv[++i]);
+            threadsB = (uint32_t)std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            link.latencyMs = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            link.jitterMs = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--loss") == 0 && i + 1 < argc) {
+            link.loss = (float)std::atof(argv[++i]) / 100.0f;
+        }
+        else if (std::strcmp(argv[i], "--entities") == 0 && i + 1 < argc) {
+            entityCount = std::atoi(argv[++i]);
+        }
+        else if (offline && options.ticks == 0 && std::atoi(argv[i]) > 0) {
+            options.ticks = std::atoi(argv[i]);
+        }
+        else if (offline) {
+            options.levelPath = argv[i];
+        }
+    }
+
+    if (headless) {
+        exitCode = runHeadless(options);
+    }
+    else if (desyncCheck) {
+        exitCode = desync::runDesyncCheck(options, threadsA, threadsB);
+    }
+    else if (rollback) {
+        exitCode = netplay::runLoopback(options, link);
+    }
+    else if (spectate) {
+        exitCode = netplay::runSpectator(options, link, entityCount);
+    }
+    else if (netplayArgs > 0) {
+        exitCode = netplay::runUdp(options, std::atoi(argv[2]), (uint16_t)std::atoi(argv[3]), argv[4], (uint16_t)std::atoi(argv[5]));
+    }
+
+    return offline;
+}
@@ -0,0 +1,16 @@
+#ifndef COMMAND_LINE_H_
+#define COMMAND_LINE_H_
+
+#include "headless.h"
+
+/**
+* @brief Reads the command line into options, then runs the mode it names if that mode needs no window :
+* --compare-hashes, --generate, --server, --netplay, --headless, --desync, --rollback or --spectate.
+* Every executable shares it, the game only opens its window when this returns false
+* @param options - Filled from the arguments either way, the game uses --record, --replay and --trace
+* @param exitCode - The exit code of the mode that ran, untouched when none did
+* @return true if a mode ran
+*/
+bool runCommandLine(int argc, char** argv, HeadlessOptions& options, int& exitCode) noexcept;
+
+#endif // !COMMAND_LINE_H_
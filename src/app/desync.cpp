@@ -0,0 +1,224 @@
+#include "desync.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../core/level/level.h"
+#include "../core/jobs/job_system.h"
+
+namespace desync {
+
+    namespace {
+
+        // the parts of a hash line after the tick, in the order writeHash writes them
+        constexpr size_t PART_COUNT = 3u + ENTITY_TYPE_COUNT;
+
+        std::string partName(size_t part) {
+            switch (part) {
+            case 0u: return "total";
+            case 1u: return "tiles";
+            case 2u: return "players";
+            default: return "entity type " + std::to_string(part - 3u);
+            }
+        }
+
+        bool readLine(std::istream& in, uint64_t& tick, std::vector<uint64_t>& parts) {
+            std::string line;
+            if (!std::getline(in, line)) { return false; }
+
+            std::istringstream fields(line);
+            fields >> std::hex >> tick;
+            parts.assign(PART_COUNT, 0u);
+            for (uint64_t& part : parts) {
+                fields >> part;
+            }
+            return !fields.fail();
+        }
+
+        void printEntity(std::ostream& out, const char* run, const EntityBlock& block, uint32_t i) {
+            out << "  " << run << " : position (" << block.position[i].x << ", " << block.position[i].y
+                << ") velocity (" << block.velocity[i].x << ", " << block.velocity[i].y
+                << ") flags " << static_cast<unsigned>(block.flags[i]) << " clip " << block.clip[i] << " from tick " << block.clipStart[i]
+                << (i < block.awake ? " awake" : " sleeping") << "\n";
+        }
+    }
+
+    void writeHash(std::ostream& out, const StateHash& hash) noexcept {
+
+        out << std::hex << hash.tick << ' ' << hash.total << ' ' << hash.tiles << ' ' << hash.players;
+        for (const uint64_t block : hash.blocks) {
+            out << ' ' << block;
+        }
+        out << std::dec << '\n';
+    }
+
+    int compareHashLogs(const char* pathA, const char* pathB) noexcept {
+
+        std::ifstream a(pathA), b(pathB);
+        if (!a.is_open() || !b.is_open()) {
+            std::cerr << "Could not open the hash logs [ " << pathA << " ] and [ " << pathB << " ]\n";
+            return -1;
+        }
+
+        uint64_t tickA = 0u, tickB = 0u, lines = 0u;
+        std::vector<uint64_t> partsA, partsB;
+        while (true) {
+            const bool moreA = readLine(a, tickA, partsA);
+            const bool moreB = readLine(b, tickB, partsB);
+
+            if (!moreA || !moreB) {
+                std::cout << "No divergence in " << lines << " ticks";
+                if (moreA != moreB) {
+                    std::cout << ", " << (moreA ? pathB : pathA) << " ends first";
+                }
+                std::cout << "\n";
+                return 0;
+            }
+
+            if (tickA != tickB) {
+                std::cerr << "The logs are out of step at line " << lines + 1u << " (ticks " << tickA << " and " << tickB << ")\n";
+                return -1;
+            }
+
+            if (partsA[0] != partsB[0]) {
+                std::cout << "Diverged at tick " << tickA << " :";
+                for (size_t p = 1u; p < PART_COUNT; p++) {
+                    if (partsA[p] != partsB[p]) { std::cout << " [" << partName(p) << "]"; }
+                }
+                std::cout << "\n";
+                return 1;
+            }
+
+            lines++;
+        }
+    }
+
+    bool reportDifference(const Level& a, const Level& b, std::ostream& out) noexcept {
+
+        const StateHash& hashA = a.getStateHash();
+        const StateHash& hashB = b.getStateHash();
+
+        if (hashA.tiles != hashB.tiles) {
+            const int firstColumn = std::max(a.tileHash.firstDifference(b.tileHash), 0);
+            for (int x = firstColumn; x < std::min(a.width, b.width); x++) {
+                for (int y = 0; y < std::min(a.height, b.height); y++) {
+                    if (a.getTile(x, y).mData != b.getTile(x, y).mData) {
+                        out << "Tile (" << x << ", " << y << ") differs : " << a.getTile(x, y).mData << " and "
+                            << b.getTile(x, y).mData << "\n";
+                        return true;
+                    }
+                }
+            }
+            out << "The tiles differ (level sizes " << a.width << "x" << a.height << " and " << b.width << "x" << b.height << ")\n";
+            return true;
+        }
+
+        if (hashA.players != hashB.players) {
+            for (int p = 0; p < std::min(a.playerCount, b.playerCount); p++) {
+                const Player* pa = a.getPlayer(p);
+                const Player* pb = b.getPlayer(p);
+                out << "Player " << p << " : position (" << pa->position.x << ", " << pa->position.y << ") and ("
+                    << pb->position.x << ", " << pb->position.y << "), velocity (" << pa->velocity.x << ", "
+                    << pa->velocity.y << ") and (" << pb->velocity.x << ", " << pb->velocity.y << ")\n";
+            }
+            return true;
+        }
+
+        for (size_t t = 0u; t < ENTITY_TYPE_COUNT; t++) {
+            if (hashA.blocks[t] == hashB.blocks[t]) { continue; }
+
+            const EntityBlock& blockA = a.entities.block(static_cast<EntityType>(t));
+            const EntityBlock& blockB = b.entities.block(static_cast<EntityType>(t));
+
+            // the first entity of a run that is missing or different in the other one
+            for (uint32_t i = 0u; i < blockA.size(); i++) {
+                const EntityId id = blockA.id(i);
+                const uint32_t j = blockB.find(id);
+
+                if (j == EntityBlock::NO_SLOT) {
+                    out << "Entity type " << t << " slot " << id.slot() << " generation " << id.generation()
+                        << " only exists in the first run\n";
+                    printEntity(out, "first", blockA, i);
+                    return true;
+                }
+
+                if (blockA.hash(i) != blockB.hash(j) || (i < blockA.awake) != (j < blockB.awake)) {
+                    out << "Entity type " << t << " slot " << id.slot() << " generation " << id.generation() << " differs\n";
+                    printEntity(out, "first", blockA, i);
+                    printEntity(out, "second", blockB, j);
+                    return true;
+                }
+            }
+
+            for (uint32_t j = 0u; j < blockB.size(); j++) {
+                const EntityId id = blockB.id(j);
+                if (blockA.find(id) == EntityBlock::NO_SLOT) {
+                    out << "Entity type " << t << " slot " << id.slot() << " generation " << id.generation()
+                        << " only exists in the second run\n";
+                    printEntity(out, "second", blockB, j);
+                    return true;
+                }
+            }
+
+            out << "Entity type " << t << " differs, but every entity matches (a sleeping entity was changed outside of the simulation)\n";
+            return true;
+        }
+
+        return hashA.total != hashB.total;
+    }
+
+    int runDesyncCheck(const HeadlessOptions& options, uint32_t threadsA, uint32_t threadsB) noexcept {
+
+        jobs::JobSystem systemA(threadsA);
+        jobs::JobSystem systemB(threadsB);
+
+        Level a, b;
+        Level* levels[2] = { &a, &b };
+        jobs::JobSystem* systems[2] = { &systemA, &systemB };
+
+        int ticks = options.ticks;
+        for (int r = 0; r < 2; r++) {
+            Level& level = *levels[r];
+            if (!loadHeadlessLevel(level, options.levelPath)) {
+                return 1;
+            }
+            level.play = true;
+            level.jobSystem = systems[r];
+
+            if (options.replayPath != nullptr) {
+                const int replayTicks = level.loadInputReplay(options.replayPath);
+                if (replayTicks < 0) {
+                    return 1;
+                }
+                ticks = ticks > 0 ? ticks : replayTicks;
+            }
+            else {
+                for (int p = 0; p < level.playerCount; p++) {
+                    level.getPlayer(p)->getController().setSource(Controller::Source::NONE);
+                }
+            }
+        }
+        ticks = ticks > 0 ? ticks : 600;
+
+        std::cout << "Comparing " << ticks << " ticks on " << systemA.threadCount() << " and " << systemB.threadCount() << " threads\n";
+
+        for (int i = 0; i < ticks; i++) {
+            for (Level* level : levels) {
+                level->pollInput();
+                level->update();
+            }
+
+            if (a.getStateHash() != b.getStateHash()) {
+                std::cout << "Diverged at tick " << a.getStateHash().tick << "\n";
+                reportDifference(a, b, std::cout);
+                return 1;
+            }
+        }
+
+        std::cout << "No divergence, final state hash " << std::hex << a.getStateHash().total << std::dec << "\n";
+        return 0;
+    }
+}
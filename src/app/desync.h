@@ -0,0 +1,45 @@
+#ifndef DESYNC_H_
+#define DESYNC_H_
+
+#include <cstdint>
+#include <ostream>
+
+#include "headless.h"
+#include "../core/level/state_hash.h"
+
+class Level;
+
+/**
+* Tools to find where two runs that should be identical diverge
+*/
+namespace desync {
+
+    /**
+    * @brief Writes one line of a hash log : the tick, the total, then every part of the hash, in hex
+    */
+    void writeHash(std::ostream& out, const StateHash& hash) noexcept;
+
+    /**
+    * @brief Compares two hash logs (of two builds, or two machines) and prints the first tick they differ at and
+    * which parts of the state differ
+    * @return 0 if the logs match, 1 if they diverge, -1 if they could not be read
+    */
+    int compareHashLogs(const char* pathA, const char* pathB) noexcept;
+
+    /**
+    * @brief Prints the first difference between the states of two levels : the first tile, the players, or the
+    * first entity whose state differs, with both versions of it
+    * @return false if there was no difference
+    */
+    bool reportDifference(const Level& a, const Level& b, std::ostream& out) noexcept;
+
+    /**
+    * @brief Simulates the same level and input twice in lockstep, with threadsA and threadsB threads (0 for every
+    * hardware thread), comparing the state hashes after every tick. Stops at the first tick they differ and reports
+    * the diverging entity
+    * @return The exit code : 0 if the runs stayed identical
+    */
+    int runDesyncCheck(const HeadlessOptions& options, uint32_t threadsA, uint32_t threadsB) noexcept;
+}
+
+#endif // !DESYNC_H_
@@ -0,0 +1,139 @@
+#include "frame_pipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#include "../core/profiler/profiler.h"
+
+// how many columns either side of the camera make it into the render list
+#define RENDER_HALF_WIDTH (13.0f)
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    inline double millisecondsSince(Clock::time_point start) noexcept {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+FramePipeline::FramePipeline(Level* level, const SpriteAtlas* atlas, RenderBackend* backend, jobs::JobSystem* jobSystem) noexcept :
+    mLevel(level), mAtlas(atlas), mBackend(backend), mJobSystem(jobSystem)
+{
+    // the level animates its tiles with the atlas's clips
+    mLevel->animations = &mAtlas->getAnimations();
+    mLevel->particles = &mParticles;
+    mTimings.reserve(TIMING_HISTORY);
+}
+
+void FramePipeline::simulateJob(void* data, uint32_t, uint32_t) noexcept
+{
+    static_cast<FramePipeline*>(data)->simulate();
+}
+
+void FramePipeline::simulate() noexcept
+{
+    PROFILE_SCOPE("FramePipeline::simulate");
+    const Clock::time_point start = Clock::now();
+
+    mLevel->update();
+    mLevel->buildRenderList(mLists[mFront ^ 1u], mLeft, mRight);
+
+    mSimulateMs = millisecondsSince(start);
+}
+
+void FramePipeline::frame(const Camera* camera) noexcept
+{
+    PROFILE_SCOPE("FramePipeline::frame");
+    const Clock::time_point start = Clock::now();
+
+    const glm::vec2 center = camera->getPosition2D();
+    mLeft = center.x - RENDER_HALF_WIDTH;
+    mRight = center.x + RENDER_HALF_WIDTH;
+
+    // Kick off the next tick
+    jobs::Counter counter;
+    if (mJobSystem != nullptr) {
+        mJobSystem->submit(counter, jobs::Job{ &FramePipeline::simulateJob, this, 0u, 0u, nullptr });
+    }
+
+    // Render the last tick while it runs
+    const Clock::time_point renderStart = Clock::now();
+    mBatch.build(mLists[mFront], *mAtlas);
+    mBackend->submit(mBatch, camera);
+    const double renderMs = millisecondsSince(renderStart);
+    PROFILE_COUNTER("quads submitted", mBatch.getQuadCount());
+
+    // Join, helping out with the simulation's jobs
+    if (mJobSystem != nullptr) {
+        PROFILE_SCOPE("join");
+        mJobSystem->wait(counter);
+    }
+    else {
+        simulate();
+    }
+
+    mFront ^= 1u;
+    PROFILE_COUNTER("particles", mParticles.size());
+
+    const FrameTiming timing{ mSimulateMs, renderMs, millisecondsSince(start) };
+    if (mTimings.size() < TIMING_HISTORY) {
+        mTimings.push_back(timing);
+    }
+    else {
+        mTimings[mNextTiming] = timing;
+    }
+    mNextTiming = (mNextTiming + 1u) % TIMING_HISTORY;
+    mFrameCount++;
+}
+
+std::vector<FrameTiming> FramePipeline::getTimings() const
+{
+    if (mTimings.size() < TIMING_HISTORY) {
+        return mTimings;
+    }
+
+    // unroll the ring
+    std::vector<FrameTiming> timings(mTimings.begin() + mNextTiming, mTimings.end());
+    timings.insert(timings.end(), mTimings.begin(), mTimings.begin() + mNextTiming);
+    return timings;
+}
+
+void FramePipeline::report(std::ostream& out) const
+{
+    if (mTimings.empty()) {
+        out << "No frames recorded\n";
+        return;
+    }
+
+    FrameTiming total{ 0.0, 0.0, 0.0 };
+    FrameTiming worst{ 0.0, 0.0, 0.0 };
+    for (const FrameTiming& t : mTimings) {
+        total.simulate += t.simulate;
+        total.render += t.render;
+        total.wall += t.wall;
+        worst.simulate = std::max(worst.simulate, t.simulate);
+        worst.render = std::max(worst.render, t.render);
+        worst.wall = std::max(worst.wall, t.wall);
+    }
+
+    const double n = static_cast<double>(mTimings.size());
+    const double simulate = total.simulate / n;
+    const double render = total.render / n;
+    const double wall = total.wall / n;
+
+    // the time saved compared to running both one after the other, out of the most that could be saved
+    const double overlap = std::max(0.0, simulate + render - wall);
+    const double shorter = std::min(simulate, render);
+    const double hidden = shorter > 0.0 ? std::min(100.0, 100.0 * overlap / shorter) : 0.0;
+
+    out << std::fixed << std::setprecision(3);
+    out << "Frame timings over the last " << mTimings.size() << " of " << mFrameCount << " frames (ms)\n";
+    out << "             avg        max\n";
+    out << "  simulate " << std::setw(8) << simulate << "   " << std::setw(8) << worst.simulate << "\n";
+    out << "  render   " << std::setw(8) << render << "   " << std::setw(8) << worst.render << "\n";
+    out << "  wall     " << std::setw(8) << wall << "   " << std::setw(8) << worst.wall << "\n";
+    out << "  serial   " << std::setw(8) << simulate + render << "   (simulate + render)\n";
+    out << "  overlap  " << std::setw(8) << overlap << "   (" << std::setprecision(1) << hidden << "% of the shorter stage hidden)\n";
+    out << std::defaultfloat;
+}
@@ -0,0 +1,90 @@
+#ifndef FRAME_PIPELINE_H_
+#define FRAME_PIPELINE_H_
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "../core/level/level.h"
+#include "../core/jobs/job_system.h"
+#include "../graphics/particle.h"
+#include "../graphics/render_list.h"
+#include "../graphics/sprite_batch.h"
+#include "../graphics/render_backend.h"
+
+/**
+* How long the parts of one frame took, in milliseconds
+*/
+struct FrameTiming {
+    // the tick simulated on the job system (and its render list)
+    double simulate;
+    // building and submitting the sprite batch of the last tick, on the calling thread
+    double render;
+    // the whole frame
+    double wall;
+};
+
+/**
+* Overlaps the simulation with rendering. Each frame, tick N + 1 is simulated on the job system and written into the
+* back RenderList, while the calling thread builds the sprite batch of tick N from the front list and submits it.
+* The frame then waits for the simulation and swaps the lists, so a frame takes about max(simulate, render) instead
+* of their sum, at the cost of showing the level one tick late.
+*
+* Nothing else may touch the level while frame() runs; input and editing happen between frames
+*/
+class FramePipeline final {
+public:
+
+    static constexpr uint32_t TIMING_HISTORY = 600u;
+
+    /**
+    * @param jobSystem - Where the simulation runs, when null it runs on the calling thread after rendering
+    */
+    FramePipeline(Level* level, const SpriteAtlas* atlas, RenderBackend* backend, jobs::JobSystem* jobSystem) noexcept;
+
+    /**
+    * @brief Simulates the next tick while rendering the last one, then swaps
+    * @param camera - What the render list covers, and the projection the batch is drawn with
+    */
+    void frame(const Camera* camera) noexcept;
+
+    /**
+    * @return The timings of the last TIMING_HISTORY frames, oldest first
+    */
+    std::vector<FrameTiming> getTimings() const;
+
+    /**
+    * @brief Writes the average and worst times of the recorded frames, and how much of the work was overlapped
+    */
+    void report(std::ostream& out) const;
+
+private:
+
+    static void simulateJob(void* data, uint32_t, uint32_t) noexcept;
+    void simulate() noexcept;
+
+    Level* mLevel;
+    const SpriteAtlas* mAtlas;
+    RenderBackend* mBackend;
+    jobs::JobSystem* mJobSystem;
+
+    // the front list is rendered while the back one (mFront ^ 1) is written by the simulation
+    RenderList mLists[2];
+    uint32_t mFront{ 0u };
+    SpriteBatch mBatch;
+
+    // the level's particles, only something that draws the level needs them
+    ParticleSystem mParticles;
+
+    // the columns the next render list covers, copied from the camera before the simulation starts
+    float mLeft{ 0.0f };
+    float mRight{ 0.0f };
+    double mSimulateMs{ 0.0 };
+
+    // ring buffer of the last frames
+    std::vector<FrameTiming> mTimings;
+    uint32_t mNextTiming{ 0u };
+    uint64_t mFrameCount{ 0u };
+};
+
+#endif // !FRAME_PIPELINE_H_
@@ -0,0 +1,183 @@
+#include "headless.h"
+
+#include <fstream>
+#include <iostream>
+
+#include <stb_image.h>
+
+#include "desync.h"
+#include "frame_pipeline.h"
+#include "../core/serializer.h"
+#include "../core/profiler/profiler.h"
+#include "../core/profiler/alloc_tracker.h"
+#include "../core/level/entity/entity_pkg.h"
+#include "../graphics/recording_backend.h"
+
+namespace {
+
+    // The frames the level and the profiler have to grow their buffers to their steady size, before the allocation
+    // budget applies. Each of the profiler's history slots gets its buffers the first time it is written, so it is
+    // the whole history
+    constexpr int ALLOC_WARMUP_FRAMES = static_cast<int>(profiler::FRAME_HISTORY);
+
+    // A flat stage with a few walls and enemies, for when no level is given
+    void buildTestStage(Level& level) noexcept {
+
+        level.resizeTiles(level.width, level.height);
+
+        for (int x = 0; x < level.width; x++) {
+            level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1), x, 0);
+            level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1), x, 1);
+
+            if (x % 24 == 0) {
+                level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::STONE), x, 2);
+            }
+        }
+
+        for (int x = 4; x < level.width - 4; x += 3) {
+            level.addEntity(x % 2 ? EntityType::GOOMBA : EntityType::GREEN_KOOPA, { (float)x, 2.0f });
+        }
+    }
+}
+
+bool loadHeadlessLevel(Level& level, const char* levelPath) noexcept
+{
+    if (levelPath != nullptr) {
+        return serializer::loadLevel(&level, levelPath) == 0;
+    }
+
+    buildTestStage(level);
+    return true;
+}
+
+void loadHeadlessAtlas(SpriteAtlas& atlas) noexcept
+{
+    // The sprites only need the size of the sheet, not the texture
+    int sheetWidth = 0, sheetHeight = 0, channels = 0;
+    if (!stbi_info("resources/sprites/smb1_sprites.png", &sheetWidth, &sheetHeight, &channels)) {
+        std::cerr << "Could not read the sprite sheet, sprites will have no texture coordinates\n";
+        sheetWidth = sheetHeight = 1;
+    }
+
+    atlas.load("resources/files/texture_atlas.json", sheetWidth, sheetHeight);
+}
+
+int runHeadless(const HeadlessOptions& options) noexcept
+{
+    SpriteAtlas atlas;
+    loadHeadlessAtlas(atlas);
+
+    Level level;
+    if (!loadHeadlessLevel(level, options.levelPath)) {
+        return 1;
+    }
+    level.play = true;
+
+    // There are no gamepads without a window, the players either replay a file or stand still
+    int ticks = options.ticks;
+    if (options.replayPath != nullptr) {
+        const int replayTicks = level.loadInputReplay(options.replayPath);
+        if (replayTicks < 0) {
+            return 1;
+        }
+        ticks = ticks > 0 ? ticks : replayTicks;
+    }
+    else {
+        for (int p = 0; p < level.playerCount; p++) {
+            level.getPlayer(p)->getController().setSource(Controller::Source::NONE);
+        }
+    }
+    ticks = ticks > 0 ? ticks : 600;
+
+    if (options.recordPath != nullptr) {
+        level.startInputRecording();
+    }
+
+    jobs::JobSystem jobSystem;
+    level.jobSystem = &jobSystem;
+
+    RecordingBackend backend(&atlas.getClipTable());
+    backend.reserve(static_cast<size_t>(ticks));
+    FramePipeline pipeline(&level, &atlas, &backend, &jobSystem);
+
+    std::ofstream hashLog;
+    if (options.hashLogPath != nullptr) {
+        hashLog.open(options.hashLogPath);
+        if (!hashLog.is_open()) {
+            std::cerr << "Could not open the hash log " << options.hashLogPath << "\n";
+            return 1;
+        }
+    }
+
+    profiler::setThreadName("main");
+    if (options.tracePath != nullptr && !profiler::startCapture(options.tracePath)) {
+        std::cerr << "Could not create the trace " << options.tracePath << "\n";
+        return 1;
+    }
+
+    const bool trackAllocations = options.allocBudget >= 0;
+    if (trackAllocations && !ENABLE_ALLOC_TRACKING) {
+        std::cerr << "This build does not track allocations (ENABLE_ALLOC_TRACKING is 0)\n";
+        return 1;
+    }
+    profiler::setAllocTracking(trackAllocations);
+    int framesOverBudget = 0;
+
+    Camera camera;
+    for (int i = 0; i < ticks; i++) {
+        // the whole frame is counted, input and the profiler's bookkeeping included
+        const profiler::AllocCount before = profiler::allocations();
+
+        level.pollInput();
+        pipeline.frame(&camera);
+
+        backend.getGpuTimer().endFrame();
+        profiler::endFrame();
+
+        // the tick the pipeline just finished
+        if (hashLog.is_open()) {
+            desync::writeHash(hashLog, level.getStateHash());
+        }
+
+        const profiler::AllocCount after = profiler::allocations();
+        const uint64_t allocated = after.allocations - before.allocations;
+        if (trackAllocations && i >= ALLOC_WARMUP_FRAMES && allocated > static_cast<uint64_t>(options.allocBudget)) {
+            // the first few are enough to go on, the report has the scopes
+            if (framesOverBudget++ < 10) {
+                std::cout << "Frame " << i << " allocated " << allocated << " times (" << after.bytes - before.bytes
+                    << " bytes), over the budget of " << options.allocBudget << "\n";
+            }
+        }
+    }
+
+    profiler::stopCapture();
+
+    if (options.recordPath != nullptr && level.saveInputRecording(options.recordPath) != 0) {
+        return 1;
+    }
+
+    pipeline.report(std::cout);
+    if (trackAllocations) {
+        profiler::setAllocTracking(false);
+        profiler::writeAllocationReport(std::cout, 0.0);
+    }
+
+    uint64_t quads = 0u;
+    for (const RecordedFrame& frame : backend.getFrames()) {
+        quads += frame.quadCount;
+    }
+    std::cout << "Recorded " << backend.getFrames().size() << " frames, " << quads << " quads, "
+        << level.getActiveEntityCount() << " active / " << level.getSleepingEntityCount() << " sleeping entities\n";
+    if (!backend.getFrames().empty()) {
+        std::cout << "Last frame : tick " << backend.getFrames().back().tick << ", checksum " << std::hex
+            << backend.getFrames().back().checksum << std::dec << "\n";
+    }
+    std::cout << "State hash : tick " << level.getStateHash().tick << ", " << std::hex << level.getStateHash().total
+        << std::dec << "\n";
+
+    if (framesOverBudget > 0) {
+        std::cout << framesOverBudget << " frames went over the allocation budget of " << options.allocBudget << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef HEADLESS_H_
+#define HEADLESS_H_
+
+/**
+* What a headless run plays, see runHeadless
+*/
+struct HeadlessOptions {
+    // The number of frames to run, 0 runs until the replay ends (or 600 frames without one)
+    int ticks = 0;
+    // A .lvl file to load, or null for a generated test stage
+    const char* levelPath = nullptr;
+    // An input file to play the players' input back from, or null for no input
+    const char* replayPath = nullptr;
+    // Where to save the input that was played, or null
+    const char* recordPath = nullptr;
+    // Where to write the state hash of every tick, for --compare-hashes, or null
+    const char* hashLogPath = nullptr;
+    // Where to write a Chrome trace of every frame, or null
+    const char* tracePath = nullptr;
+    // The allocations a frame may make once the level has warmed up, -1 does not track allocations. The run fails
+    // when a frame goes over, 0 asserts the steady state never allocates
+    int allocBudget = -1;
+};
+
+class Level;
+class SpriteAtlas;
+
+/**
+* @brief Loads the level of a headless run, or builds the generated test stage when there is no path
+* @return false if the level could not be loaded
+*/
+bool loadHeadlessLevel(Level& level, const char* levelPath) noexcept;
+
+/**
+* @brief Loads the sprites and animations of the atlas without a GL context, only the size of the sprite sheet is read
+*/
+void loadHeadlessAtlas(SpriteAtlas& atlas) noexcept;
+
+/**
+* @brief Runs the level through the frame pipeline without a window or a GPU, rendering into a RecordingBackend,
+* then prints the frame timing report and what was drawn. Replaying the same input on the same level gives the
+* same checksums on every build, so two builds can be compared by their timings alone
+* @return The exit code
+*/
+int runHeadless(const HeadlessOptions& options) noexcept;
+
+#endif // !HEADLESS_H_
@@ -0,0 +1,37 @@
+#include "command_line.h"
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// The entry point of the executables that never open a window : PlatformerHeadless runs every windowless mode of
+// the game, PlatformerServer (built with PLATFORMER_SERVER) is PlatformerHeadless --server. Neither links the game,
+// the editor or ImGui, and neither needs a GL context
+int main(int argc, char** argv)
+{
+    std::srand((unsigned int)std::time(0));
+
+    std::vector<char*> args(argv, argv + argc);
+#ifdef PLATFORMER_SERVER
+    // PlatformerServer [matches] [level.lvl] [--replay input.inp] ...
+    static char serverMode[] = "--server";
+    if (argc < 2 || std::strcmp(argv[1], serverMode) != 0) {
+        args.insert(args.begin() + 1, serverMode);
+    }
+#endif
+
+    HeadlessOptions options;
+    int exitCode = 0;
+    if (runCommandLine(static_cast<int>(args.size()), args.data(), options, exitCode)) {
+        return exitCode;
+    }
+
+    std::cerr << "Usage : " << argv[0] << " <mode> ...\n"
+        << "  --headless | --desync | --rollback | --spectate [ticks] [level.lvl] [--replay input.inp] ...\n"
+        << "  --server [matches] [level.lvl] [--seconds s] ...\n"
+        << "  --netplay player localPort remoteHost remotePort [ticks] [level.lvl]\n"
+        << "  --generate out.lvl [width] [--height h] [--seed s] [--enemies perColumn]\n"
+        << "  --compare-hashes a.log b.log\n";
+    return 1;
+}
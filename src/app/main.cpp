@@ -1,13 +1,24 @@
 #include "application.h"
+#include "command_line.h"
 #include <ctime>
-#include <random>
-#include <chrono>
+#include <cstdlib>
 
-int main()
+int main(int argc, char** argv)
 {
     std::srand((unsigned int)std::time(0));
+
+    HeadlessOptions options;
+    int exitCode = 0;
+    if (runCommandLine(argc, argv, options, exitCode)) {
+        return exitCode;
+    }
+
     Application app(1280, 720, "Platformer");
+    if (options.recordPath) { app.recordInput(options.recordPath); }
+    if (options.replayPath) { app.replayInput(options.replayPath); }
+    if (options.tracePath) { profiler::startCapture(options.tracePath); }
     app.start();
+    profiler::stopCapture();
 
     return 0;
 }
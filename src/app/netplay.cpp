@@ -0,0 +1,285 @@
+#include "netplay.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "../core/level/level.h"
+#include "../core/level/snapshot.h"
+#include "../core/profiler/profiler.h"
+#include "../core/level/entity/entity_pkg.h"
+#include "../graphics/render_list.h"
+#include "../graphics/sprite_atlas.h"
+#include "../core/net/rollback.h"
+#include "../core/net/spectator.h"
+#include "../core/net/udp_transport.h"
+
+namespace netplay {
+
+    namespace {
+
+        constexpr double TICK_MS = 1000.0 / 60.0;
+        // more than the deepest rollback the session allows
+        constexpr uint32_t SNAPSHOT_TICKS = 2u * net::RollbackSession::MAX_PREDICTION;
+
+        // buttons held for a random number of ticks, like a player would
+        std::vector<InputState> randomInput(uint32_t seed, int ticks) {
+
+            constexpr uint16_t CHOICES[] = { 0u, INPUT_LEFT, INPUT_RIGHT, INPUT_UP, INPUT_DOWN,
+                INPUT_LEFT | INPUT_UP, INPUT_RIGHT | INPUT_UP, INPUT_RIGHT | INPUT_RUN };
+
+            std::mt19937 random(seed);
+            std::vector<InputState> frames;
+            while ((int)frames.size() < ticks) {
+                const InputState state{ CHOICES[random() % (sizeof(CHOICES) / sizeof(CHOICES[0]))] };
+                frames.insert(frames.end(), 4u + random() % 40u, state);
+            }
+            frames.resize(ticks);
+            return frames;
+        }
+
+        /**
+        * @brief Loads a level with two players whose controllers replay the input file, or random input
+        * @return The number of ticks to play, -1 if something could not be loaded
+        */
+        int setupLevel(Level& level, const HeadlessOptions& options) noexcept {
+
+            if (!loadHeadlessLevel(level, options.levelPath)) {
+                return -1;
+            }
+            level.addPlayer(new Player());
+            level.play = true;
+
+            int ticks = options.ticks;
+            if (options.replayPath != nullptr) {
+                const int replayTicks = level.loadInputReplay(options.replayPath);
+                if (replayTicks < 0) {
+                    return -1;
+                }
+                return ticks > 0 ? ticks : replayTicks;
+            }
+
+            ticks = ticks > 0 ? ticks : 600;
+            for (int p = 0; p < level.playerCount; p++) {
+                level.getPlayer(p)->getController().replay(randomInput(p + 1u, ticks));
+            }
+            return ticks;
+        }
+
+        /**
+        * @brief Advances the session with the local player's next input, which is only polled once the last one
+        * was used
+        */
+        inline void advance(net::RollbackSession& session, Controller& controller) noexcept {
+            if (session.advance(controller.getState())) {
+                controller.poll();
+            }
+        }
+    }
+
+    int runLoopback(const HeadlessOptions& options, const net::LoopbackConfig& config) noexcept {
+
+        jobs::JobSystem jobSystem;
+        Level levels[2];
+        SnapshotRing snapshots[2] = { SnapshotRing(SNAPSHOT_TICKS), SnapshotRing(SNAPSHOT_TICKS) };
+
+        int ticks = 0;
+        for (Level& level : levels) {
+            ticks = setupLevel(level, options);
+            if (ticks < 0) {
+                return 1;
+            }
+            level.jobSystem = &jobSystem;
+        }
+
+        net::LoopbackLink link(config);
+        net::RollbackSession sessions[2] = { { levels[0], snapshots[0], 0 }, { levels[1], snapshots[1], 1 } };
+        sessions[0].addPeer(&link.a(), 1);
+        sessions[1].addPeer(&link.b(), 0);
+
+        Controller* controllers[2] = { &levels[0].getPlayer(0)->getController(), &levels[1].getPlayer(1)->getController() };
+        for (Controller* controller : controllers) {
+            controller->poll();
+        }
+
+        std::cout << "Playing " << ticks << " ticks over a loopback link : " << config.latencyMs << " ms latency, "
+            << config.jitterMs << " ms jitter, " << config.loss * 100.0f << "% loss\n";
+
+        // until both sides have confirmed every tick, or gave up after 10 seconds more
+        const uint64_t end = static_cast<uint64_t>(ticks);
+        for (int frame = 0; frame < ticks + 600; frame++) {
+            if (sessions[0].getConfirmedTick() >= end && sessions[1].getConfirmedTick() >= end) { break; }
+
+            for (int s = 0; s < 2; s++) {
+                advance(sessions[s], *controllers[s]);
+            }
+            link.advance(TICK_MS);
+        }
+
+        std::cout << "Link : " << link.getSentCount() << " packets sent, " << link.getDroppedCount() << " dropped\n";
+        for (int s = 0; s < 2; s++) {
+            std::cout << "Player " << s << " ";
+            sessions[s].report(std::cout);
+        }
+
+        uint64_t hashes[2];
+        if (!sessions[0].getConfirmedHash(end - 1u, hashes[0]) || !sessions[1].getConfirmedHash(end - 1u, hashes[1])) {
+            std::cout << "The sessions never confirmed tick " << end - 1u << "\n";
+            return 1;
+        }
+
+        const bool same = hashes[0] == hashes[1];
+        std::cout << (same ? "Same" : "Different") << " state at tick " << end - 1u << " : " << std::hex << hashes[0]
+            << " / " << hashes[1] << std::dec << "\n";
+        return same && sessions[0].getStats().desyncs == 0u && sessions[1].getStats().desyncs == 0u ? 0 : 1;
+    }
+
+    int runUdp(const HeadlessOptions& options, int localPlayer, uint16_t localPort, const char* remoteHost,
+        uint16_t remotePort) noexcept {
+
+        if (localPlayer < 0 || localPlayer > 1) {
+            std::cerr << "The local player has to be 0 or 1\n";
+            return 1;
+        }
+
+        jobs::JobSystem jobSystem;
+        Level level;
+        const int ticks = setupLevel(level, options);
+        if (ticks < 0) {
+            return 1;
+        }
+        level.jobSystem = &jobSystem;
+
+        net::UdpTransport transport;
+        if (!transport.open(localPort, remoteHost, remotePort)) {
+            return 1;
+        }
+
+        SnapshotRing snapshots(SNAPSHOT_TICKS);
+        net::RollbackSession session(level, snapshots, localPlayer);
+        session.addPeer(&transport, 1 - localPlayer);
+
+        Controller& controller = level.getPlayer(localPlayer)->getController();
+        controller.poll();
+
+        std::cout << "Playing " << ticks << " ticks as player " << localPlayer << " on port " << localPort << "\n";
+
+        // one tick every 1/60 s, until every tick is confirmed or the peer has been gone for 10 seconds
+        using Clock = std::chrono::steady_clock;
+        const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(TICK_MS));
+        Clock::time_point next = Clock::now();
+        for (int frame = 0; frame < ticks + 600 && session.getConfirmedTick() < static_cast<uint64_t>(ticks); frame++) {
+            advance(session, controller);
+            profiler::endFrame();
+            next += tickDuration;
+            std::this_thread::sleep_until(next);
+        }
+
+        session.report(std::cout);
+
+        uint64_t hash;
+        if (session.getConfirmedHash(static_cast<uint64_t>(ticks) - 1u, hash)) {
+            std::cout << "State at tick " << ticks - 1 << " : " << std::hex << hash << std::dec << "\n";
+        }
+        return session.getConfirmedTick() >= static_cast<uint64_t>(ticks) && session.getStats().desyncs == 0u ? 0 : 1;
+    }
+
+    int runSpectator(const HeadlessOptions& options, const net::LoopbackConfig& config, int entityCount) noexcept {
+
+        Level level;
+        Level view;
+        if (!loadHeadlessLevel(level, options.levelPath)) {
+            return 1;
+        }
+        level.play = true;
+
+        // more entities, spread over the level
+        std::mt19937 random(7u);
+        const EntityType types[] = { EntityType::GOOMBA, EntityType::GREEN_KOOPA, EntityType::RED_PARAKOOPA };
+        for (int e = static_cast<int>(level.getEntityCount()); e < entityCount; e++) {
+            const float x = 4.0f + static_cast<float>(random() % 10000u) / 10000.0f * (level.width - 8);
+            const float y = 2.0f + static_cast<float>(random() % (level.height - 4));
+            level.addEntity(types[random() % 3u], { x, y });
+        }
+
+        int ticks = options.ticks;
+        if (options.replayPath != nullptr) {
+            const int replayTicks = level.loadInputReplay(options.replayPath);
+            if (replayTicks < 0) {
+                return 1;
+            }
+            ticks = ticks > 0 ? ticks : replayTicks;
+        }
+        else {
+            ticks = ticks > 0 ? ticks : 600;
+            level.getPlayer(0)->getController().replay(randomInput(1u, ticks));
+        }
+
+        // both sides draw animated tiles by clip too
+        SpriteAtlas atlas;
+        loadHeadlessAtlas(atlas);
+        level.animations = &atlas.getAnimations();
+        view.animations = &atlas.getAnimations();
+
+        net::LoopbackLink link(config);
+        net::SpectatorServer server(&link.a());
+        net::SpectatorClient client(&link.b(), view);
+
+        std::cout << "Replicating " << ticks << " ticks of " << level.getEntityCount() << " entities over a loopback link : "
+            << config.latencyMs << " ms latency, " << config.jitterMs << " ms jitter, " << config.loss * 100.0f << "% loss\n";
+
+        for (int i = 0; i < ticks; i++) {
+            level.pollInput();
+            level.update();
+            server.send(level);
+            link.advance(TICK_MS);
+            client.receive();
+        }
+
+        // the level stops, the spectator catches up to its last tick
+        for (int i = 0; i < 600 && client.getDecoder().lastTick() != level.tick; i++) {
+            server.send(level);
+            link.advance(TICK_MS);
+            client.receive();
+        }
+
+        const double messages = static_cast<double>(std::max<uint64_t>(server.getMessageCount(), 1u));
+        const double decoded = static_cast<double>(std::max<uint64_t>(client.getDecodedCount(), 1u));
+        std::cout << "Sent " << server.getSentBytes() << " bytes, " << server.getSentBytes() / std::max(ticks, 1)
+            << " per tick, " << server.getFullStateCount() << " full states, " << level.getActiveEntityCount()
+            << " entities awake at the end\n";
+        std::cout << "Encode " << server.getEncodeMs() / messages << " ms per message, decode "
+            << client.getDecodeMs() / decoded << " ms per message, " << client.getDecodedCount() << " decoded\n";
+
+        if (client.getDecoder().lastTick() != level.tick) {
+            std::cout << "The spectator never caught up\n";
+            return 1;
+        }
+
+        // both draw the whole level, in a different order and with quantized positions
+        const auto drawn = [](const Level& from) {
+            RenderList list;
+            from.buildRenderList(list, 0.0f, (float)from.width);
+            std::vector<std::array<int64_t, 5>> sprites;
+            for (uint32_t i = 0u; i < list.size(); i++) {
+                const SpriteInstance& sprite = list.data()[i];
+                sprites.push_back({ sprite.sprite, sprite.clip, sprite.start,
+                    std::lround(sprite.position.x * net::replication::POSITION_SCALE),
+                    std::lround(sprite.position.y * net::replication::POSITION_SCALE) });
+            }
+            std::sort(sprites.begin(), sprites.end());
+            return sprites;
+        };
+        const auto expected = drawn(level);
+        const auto actual = drawn(view);
+        const bool same = expected == actual;
+
+        std::cout << "The spectator draws " << (same ? "the same" : "differently") << " at tick " << level.tick << " ("
+            << actual.size() << " / " << expected.size() << " sprites)\n";
+        return same ? 0 : 1;
+    }
+}
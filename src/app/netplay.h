@@ -0,0 +1,40 @@
+#ifndef NETPLAY_H_
+#define NETPLAY_H_
+
+#include <cstdint>
+
+#include "headless.h"
+#include "../core/net/loopback_transport.h"
+
+/**
+* Headless runs of the rollback netcode, see net::RollbackSession
+*/
+namespace netplay {
+
+    /**
+    * @brief Plays a two player session between two levels in this process over a LoopbackLink, each level
+    * controlling one player, with the replay's input (or random input) and 60 ticks per second of link time. Once
+    * both have confirmed every tick, prints the link's losses, each session's rollback costs, and whether both
+    * levels ended in the same state
+    * @return The exit code : 0 if the levels ended identical without a desync
+    */
+    int runLoopback(const HeadlessOptions& options, const net::LoopbackConfig& link) noexcept;
+
+    /**
+    * @brief Plays one side of a two player session over UDP in real time, against another process running this
+    * with the other player and the ports swapped. The local player replays the input file, or random input
+    * @return The exit code
+    */
+    int runUdp(const HeadlessOptions& options, int localPlayer, uint16_t localPort, const char* remoteHost,
+        uint16_t remotePort) noexcept;
+
+    /**
+    * @brief Replicates a level to a spectator over a LoopbackLink, the level with at least entityCount entities and
+    * player 0 on random input (or the replay's). Prints the bytes sent per tick and the encode and decode costs,
+    * then checks the spectator's level draws the same as the level itself
+    * @return The exit code : 0 if the spectator caught up and draws the same
+    */
+    int runSpectator(const HeadlessOptions& options, const net::LoopbackConfig& link, int entityCount) noexcept;
+}
+
+#endif // !NETPLAY_H_
@@ -0,0 +1,235 @@
+#include "server.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "headless.h"
+#include "../core/level/level.h"
+#include "../core/level/entity/entity_pkg.h"
+#include "../core/profiler/profiler.h"
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+    #define NOMINMAX
+    #endif
+    #include <Windows.h>
+    #include <psapi.h>
+#elif defined(__linux__)
+    #include <unistd.h>
+#endif
+
+namespace {
+
+    using Clock = LevelServer::Clock;
+
+    inline double millisecondsSince(Clock::time_point start) noexcept {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // the players a replay is loaded for, a file with more only plays its first ones
+    constexpr uint32_t REPLAY_PLAYERS = 4u;
+
+    // The memory the process holds, 0 where it cannot be read
+    size_t residentBytes() noexcept {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.WorkingSetSize : 0u;
+#elif defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0u, resident = 0u;
+        statm >> pages >> resident;
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        return 0u;
+#endif
+    }
+}
+
+LevelServer::LevelServer(uint32_t threadCount) : mJobs(threadCount) {
+}
+
+LevelServer::~LevelServer() noexcept = default;
+
+bool LevelServer::loadReplay(const char* path) noexcept {
+
+    mReplays.assign(REPLAY_PLAYERS, Controller());
+    std::vector<Controller*> controllers;
+    for (Controller& controller : mReplays) {
+        controllers.push_back(&controller);
+    }
+
+    if (input::loadReplay(path, controllers.data(), REPLAY_PLAYERS) < 0) {
+        mReplays.clear();
+        return false;
+    }
+    return true;
+}
+
+int LevelServer::addMatch(const char* levelPath, double tickRate, double budgetMs) noexcept {
+
+    std::unique_ptr<Level> level = std::make_unique<Level>();
+    if (!loadHeadlessLevel(*level, levelPath)) {
+        return -1;
+    }
+    level->play = true;
+
+    // the thread pool is shared by whole matches, not by the passes of one
+    level->jobSystem = nullptr;
+
+    for (int p = 0; p < level->playerCount; p++) {
+        Controller& controller = level->getPlayer(p)->getController();
+        if (static_cast<size_t>(p) < mReplays.size()) {
+            controller = mReplays[p];
+        }
+        else {
+            controller.setSource(Controller::Source::NONE);
+        }
+    }
+
+    Match match;
+    match.level = std::move(level);
+    match.period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+    match.next = Clock::now();
+    match.budgetMs = budgetMs;
+    mMatches.push_back(std::move(match));
+
+    return static_cast<int>(mMatches.size()) - 1;
+}
+
+void LevelServer::tick(Match& match, Clock::time_point now) noexcept {
+
+    Level& level = *match.level;
+
+    for (uint32_t ran = 0u; ran < MAX_CATCH_UP && match.next <= now; ran++) {
+        // the replays start over once they end
+        for (int p = 0; p < level.playerCount && static_cast<size_t>(p) < mReplays.size(); p++) {
+            Controller& controller = level.getPlayer(p)->getController();
+            if (controller.isReplayFinished() && !mReplays[p].isReplayFinished()) {
+                controller = mReplays[p];
+            }
+        }
+
+        const Clock::time_point start = Clock::now();
+        level.pollInput();
+        level.update();
+        const double ms = millisecondsSince(start);
+
+        MatchStats& stats = match.stats;
+        stats.ticks++;
+        stats.totalMs += ms;
+        stats.maxMs = std::max(stats.maxMs, ms);
+        stats.overruns += ms > match.budgetMs ? 1u : 0u;
+
+        match.next += match.period;
+    }
+
+    // too far behind to catch up, the ticks in between are dropped
+    if (match.next <= now) {
+        const auto behind = static_cast<uint64_t>((now - match.next) / match.period) + 1u;
+        match.stats.skipped += behind;
+        match.next += match.period * behind;
+    }
+}
+
+Clock::time_point LevelServer::step(Clock::time_point now) noexcept {
+
+    mDue.clear();
+    Clock::time_point next = now + std::chrono::seconds(1);
+    for (Match& match : mMatches) {
+        if (match.next <= now) {
+            mDue.push_back(&match);
+        }
+        else {
+            next = std::min(next, match.next);
+        }
+    }
+
+    jobs::parallelFor(&mJobs, static_cast<uint32_t>(mDue.size()), 1u, [this, now](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            tick(*mDue[i], now);
+        }
+    });
+
+    for (const Match* match : mDue) {
+        next = std::min(next, match->next);
+    }
+    return next;
+}
+
+void LevelServer::run(double seconds) noexcept {
+
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+    for (Clock::time_point now = Clock::now(); now < end; now = Clock::now()) {
+        const Clock::time_point next = step(now);
+        profiler::endFrame();
+        std::this_thread::sleep_until(std::min(next, end));
+    }
+}
+
+void LevelServer::report(std::ostream& out, bool perMatch) const {
+
+    MatchStats total;
+    size_t memory = 0u;
+
+    for (size_t m = 0u; m < mMatches.size(); m++) {
+        const Match& match = mMatches[m];
+        const MatchStats& stats = match.stats;
+        const size_t bytes = match.level->getMemoryUsage();
+
+        total.ticks += stats.ticks;
+        total.overruns += stats.overruns;
+        total.skipped += stats.skipped;
+        total.totalMs += stats.totalMs;
+        total.maxMs = std::max(total.maxMs, stats.maxMs);
+        memory += bytes;
+
+        if (perMatch) {
+            out << "Match " << m << " : " << stats.ticks << " ticks, " << (stats.ticks > 0u ? stats.totalMs / stats.ticks : 0.0)
+                << " ms average, " << stats.maxMs << " ms max, " << stats.overruns << " over the "
+                << match.budgetMs << " ms budget, " << stats.skipped << " skipped, " << bytes / 1024u << " KiB\n";
+        }
+    }
+
+    const size_t count = std::max<size_t>(mMatches.size(), 1u);
+    out << mMatches.size() << " matches on " << mJobs.threadCount() << " threads : " << total.ticks << " ticks, "
+        << (total.ticks > 0u ? total.totalMs / total.ticks : 0.0) << " ms average, " << total.maxMs << " ms max\n";
+    out << "  " << total.overruns << " ticks over budget, " << total.skipped << " ticks skipped\n";
+    out << "  " << memory / count / 1024u << " KiB per match, " << memory / (1024u * 1024u) << " MiB for every level, "
+        << residentBytes() / (1024u * 1024u) << " MiB resident\n";
+}
+
+int runServer(const ServerOptions& options) noexcept {
+
+    LevelServer server(options.threads);
+    if (options.replayPath != nullptr && !server.loadReplay(options.replayPath)) {
+        return 1;
+    }
+
+    // a fair share : every thread's time, split between the matches
+    const double budgetMs = options.budgetMs > 0.0 ? options.budgetMs
+        : 1000.0 * server.threadCount() / (options.tickRate * std::max(options.matchCount, 1));
+
+    for (int m = 0; m < options.matchCount; m++) {
+        if (server.addMatch(options.levelPath, options.tickRate, budgetMs) < 0) {
+            return 1;
+        }
+    }
+
+    std::cout << "Hosting " << server.matchCount() << " matches at " << options.tickRate << " Hz on "
+        << server.threadCount() << " threads for " << options.seconds << " s, " << budgetMs << " ms budget per tick\n";
+
+    profiler::setThreadName("main");
+    if (options.tracePath != nullptr && !profiler::startCapture(options.tracePath)) {
+        std::cerr << "Could not create the trace " << options.tracePath << "\n";
+        return 1;
+    }
+
+    server.run(options.seconds);
+    profiler::stopCapture();
+    server.report(std::cout, server.matchCount() <= 16u);
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#ifndef SERVER_H_
+#define SERVER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "../core/controller.h"
+#include "../core/jobs/job_system.h"
+
+class Level;
+
+/**
+* What a server run hosts, see runServer
+*/
+struct ServerOptions {
+    // The number of matches, each a copy of the level
+    int matchCount = 100;
+    // A .lvl file to load, or null for the generated test stage
+    const char* levelPath = nullptr;
+    // An input file every match replays, over and over, or null for no input
+    const char* replayPath = nullptr;
+    double tickRate = 60.0;
+    // How long to run, in seconds
+    double seconds = 10.0;
+    // 0 for every hardware thread
+    uint32_t threads = 0u;
+    // The milliseconds a tick may take before it counts as an overrun, 0 for a fair share of the threads
+    double budgetMs = 0.0;
+    // Where to write a Chrome trace of the run, every server step is a frame, or null
+    const char* tracePath = nullptr;
+};
+
+/**
+* Runs many independent levels (matches) in one process without a window or a GPU, each at its own fixed tick rate.
+*
+* Every step, the matches whose next tick is due are ticked across the thread pool, one match per job; a match
+* only ever runs on one thread at a time and runs its own entity passes inline, so hundreds of small matches keep
+* every thread busy without splitting each tick further. A match that falls behind catches up a few ticks at once
+* and then drops the rest, so one slow match does not make every other match late
+*/
+class LevelServer final {
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    // the ticks a late match may run in one step before it skips ahead
+    static constexpr uint32_t MAX_CATCH_UP = 4u;
+
+    /**
+    * @param threadCount - 0 for every hardware thread
+    */
+    explicit LevelServer(uint32_t threadCount = 0u);
+    ~LevelServer() noexcept;
+
+    /**
+    * @brief Loads the players' replays once, every match added after this replays them from the start, and again
+    * whenever they end
+    * @return false if the file could not be read
+    */
+    bool loadReplay(const char* path) noexcept;
+
+    /**
+    * @brief Loads a level as a new match, ticking tickRate times per second from now
+    * @param budgetMs - The milliseconds a tick may take before it counts as an overrun
+    * @return The index of the match, -1 if the level could not be loaded
+    */
+    int addMatch(const char* levelPath, double tickRate, double budgetMs) noexcept;
+
+    /**
+    * @brief Ticks every match that is due at the time
+    * @return When the next match is due
+    */
+    Clock::time_point step(Clock::time_point now) noexcept;
+
+    /**
+    * @brief Steps and sleeps until the time is up
+    */
+    void run(double seconds) noexcept;
+
+    inline size_t matchCount() const noexcept {
+        return mMatches.size();
+    }
+
+    inline uint32_t threadCount() const noexcept {
+        return mJobs.threadCount();
+    }
+
+    /**
+    * @brief Prints the tick times, overruns and memory of every match and their totals
+    * @param perMatch - Prints a line per match too
+    */
+    void report(std::ostream& out, bool perMatch) const;
+
+private:
+
+    struct MatchStats {
+        uint64_t ticks{ 0u };
+        // ticks that took longer than the budget
+        uint64_t overruns{ 0u };
+        // ticks dropped for being too late to catch up
+        uint64_t skipped{ 0u };
+        double totalMs{ 0.0 };
+        double maxMs{ 0.0 };
+    };
+
+    struct Match {
+        std::unique_ptr<Level> level;
+        Clock::duration period;
+        Clock::time_point next;
+        double budgetMs;
+        MatchStats stats;
+    };
+
+    void tick(Match& match, Clock::time_point now) noexcept;
+
+    jobs::JobSystem mJobs;
+    std::vector<Match> mMatches;
+    // the matches due this step
+    std::vector<Match*> mDue;
+    // the players' replays, copied into every match's controllers
+    std::vector<Controller> mReplays;
+};
+
+/**
+* @brief Hosts options.matchCount copies of the level on a LevelServer for options.seconds, then prints the report
+* @return The exit code
+*/
+int runServer(const ServerOptions& options) noexcept;
+
+#endif // !SERVER_H_
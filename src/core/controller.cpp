@@ -0,0 +1,196 @@
+#include "controller.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <GLFW/glfw3.h>
+
+namespace {
+
+    // file meta data and constants
+    constexpr uint32_t FILE_IDENTITY = 'I' | ('N' << 8) | ('P' << 16);
+    constexpr uint32_t FILE_VERSION = 1u;
+
+    #pragma pack(1)
+
+    struct FileHeader {
+        uint32_t identity;
+        uint32_t version;
+        uint32_t playerCount;
+        uint32_t tickCount;
+    };
+
+    static_assert(sizeof(FileHeader) == 16);
+
+    // a button state held for length ticks
+    struct Run {
+        uint16_t buttons;
+        uint16_t length;
+    };
+
+    static_assert(sizeof(Run) == 4);
+
+    #pragma pack()
+
+    InputState readGamepad(int gamepad) noexcept {
+
+        InputState state;
+
+        GLFWgamepadstate pad;
+        if (!glfwGetGamepadState(gamepad, &pad)) {
+            return state;
+        }
+
+        const auto map = [&pad, &state](int button, InputButton to) {
+            if (pad.buttons[button]) { state.buttons |= to; }
+        };
+
+        map(GLFW_GAMEPAD_BUTTON_DPAD_LEFT, INPUT_LEFT);
+        map(GLFW_GAMEPAD_BUTTON_DPAD_RIGHT, INPUT_RIGHT);
+        map(GLFW_GAMEPAD_BUTTON_DPAD_UP, INPUT_UP);
+        map(GLFW_GAMEPAD_BUTTON_DPAD_DOWN, INPUT_DOWN);
+        map(GLFW_GAMEPAD_BUTTON_A, INPUT_JUMP);
+        map(GLFW_GAMEPAD_BUTTON_B, INPUT_JUMP);
+        map(GLFW_GAMEPAD_BUTTON_X, INPUT_RUN);
+        map(GLFW_GAMEPAD_BUTTON_Y, INPUT_RUN);
+        map(GLFW_GAMEPAD_BUTTON_START, INPUT_START);
+
+        return state;
+    }
+}
+
+Controller::Controller(int gamepad) noexcept
+    : mSource(Source::GAMEPAD), mGamepad(gamepad)
+{
+}
+
+const InputState& Controller::poll() noexcept {
+
+    switch (mSource) {
+    case Source::GAMEPAD:
+        mState = readGamepad(mGamepad);
+        break;
+    case Source::REPLAY:
+        mState = mCursor < mReplay.size() ? mReplay[mCursor++] : InputState{};
+        break;
+    default:
+        mState = InputState{};
+        break;
+    }
+
+    if (mRecording) {
+        mRecorded.push_back(mState);
+    }
+
+    return mState;
+}
+
+void Controller::setSource(Source source) noexcept {
+
+    mSource = source;
+    mState = InputState{};
+}
+
+void Controller::startRecording() noexcept {
+
+    mRecorded.clear();
+    mRecording = true;
+}
+
+void Controller::replay(std::vector<InputState> frames) noexcept {
+
+    mReplay = std::move(frames);
+    mCursor = 0u;
+    setSource(Source::REPLAY);
+}
+
+namespace input {
+
+    int saveRecording(const std::string& intoFile, const Controller* const* controllers, uint32_t count) noexcept {
+
+        std::ofstream out(intoFile, std::ios::binary);
+
+        if (!out.is_open() || out.bad()) {
+            std::cerr << "Error while saving input into file [ " << intoFile << " ]\n";
+            return -1;
+        }
+
+        FileHeader header{};
+        header.identity = FILE_IDENTITY;
+        header.version = FILE_VERSION;
+        header.playerCount = count;
+        for (uint32_t p = 0u; p < count; p++) {
+            header.tickCount = std::max(header.tickCount, static_cast<uint32_t>(controllers[p]->getRecording().size()));
+        }
+        out.write((const char*)&header, sizeof(FileHeader));
+
+        // each player is a run count, then the runs
+        std::vector<Run> runs;
+        for (uint32_t p = 0u; p < count; p++) {
+            runs.clear();
+            for (const InputState& state : controllers[p]->getRecording()) {
+                if (!runs.empty() && runs.back().buttons == state.buttons && runs.back().length < UINT16_MAX) {
+                    runs.back().length++;
+                }
+                else {
+                    runs.push_back({ state.buttons, 1u });
+                }
+            }
+
+            const uint32_t runCount = static_cast<uint32_t>(runs.size());
+            out.write((const char*)&runCount, sizeof(uint32_t));
+            out.write((const char*)runs.data(), runs.size() * sizeof(Run));
+        }
+
+        out.close();
+        return out.fail() ? -1 : 0;
+    }
+
+    int loadReplay(const std::string& fromFile, Controller* const* controllers, uint32_t count) noexcept {
+
+        std::ifstream in(fromFile, std::ios::binary);
+
+        if (!in.is_open() || in.bad()) {
+            std::cerr << "Error while loading input from file [ " << fromFile << " ]\n";
+            return -1;
+        }
+
+        FileHeader header{};
+        in.read((char*)&header, sizeof(FileHeader));
+
+        if (!in || header.identity != FILE_IDENTITY || header.version > FILE_VERSION) {
+            std::cerr << "Invalid input file " << fromFile << std::endl;
+            return -1;
+        }
+
+        std::vector<InputState> frames;
+        for (uint32_t p = 0u; p < header.playerCount; p++) {
+            uint32_t runCount = 0u;
+            in.read((char*)&runCount, sizeof(uint32_t));
+
+            frames.clear();
+            for (uint32_t r = 0u; r < runCount && in; r++) {
+                Run run{};
+                in.read((char*)&run, sizeof(Run));
+                frames.insert(frames.end(), run.length, InputState{ run.buttons });
+            }
+
+            if (!in) {
+                std::cerr << "Input file " << fromFile << " ends early\n";
+                return -1;
+            }
+
+            if (p < count) {
+                controllers[p]->replay(frames);
+            }
+        }
+
+        // the players the file does not have stand still
+        for (uint32_t p = header.playerCount; p < count; p++) {
+            controllers[p]->replay({});
+        }
+
+        return static_cast<int>(header.tickCount);
+    }
+}
@@ -1,12 +1,130 @@
 #ifndef CONTROLLER_H_
 #define CONTROLLER_H_
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* The buttons the game reads, one bit each. Several gamepad buttons can map to the same one
+*/
+enum InputButton : uint16_t {
+    INPUT_LEFT  = 1u << 0,
+    INPUT_RIGHT = 1u << 1,
+    INPUT_UP    = 1u << 2,
+    INPUT_DOWN  = 1u << 3,
+    INPUT_JUMP  = 1u << 4,
+    INPUT_RUN   = 1u << 5,
+    INPUT_START = 1u << 6,
+};
+
+/**
+* What a player is holding during one tick
+*/
+struct InputState {
+    uint16_t buttons{ 0u };
+
+    inline bool isDown(InputButton button) const noexcept {
+        return (buttons & button) != 0u;
+    }
+
+    inline bool operator==(const InputState& other) const noexcept {
+        return buttons == other.buttons;
+    }
+};
+
+/**
+* The input of one player. It is polled once per tick, on the main thread, and reads either a gamepad or a
+* replay; while recording every polled state is kept, so the same ticks can be played back later with exactly
+* the same input. The simulation only ever sees the InputState, never where it came from
+*/
 class Controller
 {
 public:
 
+    enum class Source {
+        // nothing is pressed, for headless runs
+        NONE,
+        GAMEPAD,
+        REPLAY,
+    };
+
+    explicit Controller(int gamepad = 0) noexcept;
+
+    /**
+    * @brief Reads the input of the next tick from the source, and records it when recording
+    * @return The new state
+    */
+    const InputState& poll() noexcept;
+
+    inline const InputState& getState() const noexcept {
+        return mState;
+    }
+
+    inline Source getSource() const noexcept {
+        return mSource;
+    }
+
+    void setSource(Source source) noexcept;
+
+    inline void setGamepad(int gamepad) noexcept {
+        mGamepad = gamepad;
+    }
+
+    /**
+    * @brief Starts recording from the next poll, dropping any previous recording
+    */
+    void startRecording() noexcept;
+
+    inline void stopRecording() noexcept {
+        mRecording = false;
+    }
+
+    inline bool isRecording() const noexcept {
+        return mRecording;
+    }
+
+    inline const std::vector<InputState>& getRecording() const noexcept {
+        return mRecorded;
+    }
+
+    /**
+    * @brief Plays the frames back, one per poll; once they run out nothing is pressed. A replay can be recorded
+    * too, the recording then matches the replay tick for tick
+    */
+    void replay(std::vector<InputState> frames) noexcept;
+
+    inline bool isReplayFinished() const noexcept {
+        return mSource == Source::REPLAY && mCursor >= mReplay.size();
+    }
+
 private:
+    Source mSource;
+    int mGamepad;
+    InputState mState;
 
+    bool mRecording{ false };
+    std::vector<InputState> mRecorded;
+    // the replay being played back, and the next frame of it
+    std::vector<InputState> mReplay;
+    size_t mCursor{ 0u };
 };
 
-#endif // !CONTROLLER_H_
\ No newline at end of file
+namespace input {
+
+    /**
+    * @brief Writes what the controllers recorded into an input file (.inp), run length encoded so long holds
+    * and idle stretches cost 4 bytes
+    * @return 0 on success, -1 if the file could not be written
+    */
+    int saveRecording(const std::string& intoFile, const Controller* const* controllers, uint32_t count) noexcept;
+
+    /**
+    * @brief Loads an input file and replays it on the controllers, player i of the file on controllers[i].
+    * Controllers the file has no input for replay nothing
+    * @return The number of ticks in the file, -1 if it could not be read
+    */
+    int loadReplay(const std::string& fromFile, Controller* const* controllers, uint32_t count) noexcept;
+}
+
+#endif // !CONTROLLER_H_
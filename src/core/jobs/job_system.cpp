@@ -0,0 +1,127 @@
+#include "job_system.h"
+
+#include <string>
+
+#include "../profiler/profiler.h"
+
+namespace jobs {
+
+	namespace {
+		// the system a worker thread belongs to and its queue there. Any other thread, and any other system's worker,
+		// pushes to and runs from queue 0
+		struct WorkerSlot {
+			const JobSystem* system = nullptr;
+			uint32_t index = 0u;
+		};
+		thread_local WorkerSlot tWorker;
+	}
+
+	JobSystem::JobSystem(uint32_t threadCount) {
+
+		if (threadCount == 0u) {
+			threadCount = std::thread::hardware_concurrency();
+			threadCount = threadCount == 0u ? 1u : threadCount;
+		}
+
+		for (uint32_t i = 0u; i < threadCount; i++) {
+			mQueues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		// thread 0 is the one that made the system
+		for (uint32_t i = 1u; i < threadCount; i++) {
+			mThreads.emplace_back(&JobSystem::workerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem() noexcept {
+
+		mStop.store(true);
+		wakeWorkers();
+
+		for (std::thread& thread : mThreads) {
+			thread.join();
+		}
+	}
+
+	uint32_t JobSystem::threadIndex() const noexcept {
+		return tWorker.system == this ? tWorker.index : 0u;
+	}
+
+	void JobSystem::submit(Counter& counter, Job job) noexcept {
+
+		push(counter, job);
+
+		{
+			std::lock_guard<std::mutex> lock(mSleepMutex);
+		}
+		mWake.notify_one();
+	}
+
+	void JobSystem::push(Counter& counter, Job job) noexcept {
+
+		job.counter = &counter;
+		counter.pending.fetch_add(1u, std::memory_order_relaxed);
+
+		if (mQueues[threadIndex()]->push(job)) {
+			mQueued.fetch_add(1u, std::memory_order_release);
+		}
+		else {
+			// full, no point in waiting for room
+			job.function(job.data, job.begin, job.end);
+			counter.pending.fetch_sub(1u, std::memory_order_release);
+		}
+	}
+
+	void JobSystem::wait(Counter& counter) noexcept {
+
+		const uint32_t self = threadIndex();
+		while (counter.pending.load(std::memory_order_acquire) > 0u) {
+			if (!runOne(self)) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::runOne(uint32_t self) noexcept {
+
+		Job job;
+		bool found = mQueues[self]->pop(job);
+
+		// steal, starting with the next thread over so the thieves spread out
+		const uint32_t count = threadCount();
+		for (uint32_t i = 1u; !found && i < count; i++) {
+			found = mQueues[(self + i) % count]->steal(job);
+		}
+
+		if (!found) { return false; }
+
+		mQueued.fetch_sub(1u, std::memory_order_relaxed);
+		job.function(job.data, job.begin, job.end);
+		job.counter->pending.fetch_sub(1u, std::memory_order_release);
+		return true;
+	}
+
+	void JobSystem::workerLoop(uint32_t index) noexcept {
+
+		tWorker = WorkerSlot{ this, index };
+		profiler::setThreadName("worker " + std::to_string(index));
+
+		while (!mStop.load()) {
+			if (runOne(index)) { continue; }
+
+			std::unique_lock<std::mutex> lock(mSleepMutex);
+			mWake.wait(lock, [this]() {
+				return mStop.load() || mQueued.load(std::memory_order_acquire) > 0u;
+			});
+		}
+	}
+
+	void JobSystem::wakeWorkers() noexcept {
+
+		// taking the lock means no worker is between checking mQueued and going to sleep
+		{
+			std::lock_guard<std::mutex> lock(mSleepMutex);
+		}
+		mWake.notify_all();
+	}
+}
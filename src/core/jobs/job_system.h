@@ -0,0 +1,177 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace jobs {
+
+	/**
+	* Counts the jobs of a fork that have not finished yet, JobSystem::wait returns once it reaches 0
+	*/
+	struct Counter {
+		std::atomic<uint32_t> pending{ 0u };
+	};
+
+	/**
+	* A range of work, run as function(data, begin, end). Jobs are plain data so submitting one never allocates
+	*/
+	struct Job {
+		void (*function)(void* data, uint32_t begin, uint32_t end);
+		void* data;
+		uint32_t begin;
+		uint32_t end;
+		Counter* counter;
+	};
+
+	/**
+	* A bounded double ended queue of jobs. The thread that owns it pushes and pops at the back (newest first,
+	* while the data is still in cache), other threads steal from the front (the oldest, usually the biggest, jobs)
+	*/
+	class WorkQueue final {
+	public:
+
+		static constexpr uint32_t CAPACITY = 4096u;
+
+		/**
+		* @return false if the queue is full
+		*/
+		bool push(const Job& job) noexcept {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mBack - mFront == CAPACITY) { return false; }
+			mJobs[mBack++ % CAPACITY] = job;
+			return true;
+		}
+
+		bool pop(Job& job) noexcept {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mBack == mFront) { return false; }
+			job = mJobs[--mBack % CAPACITY];
+			return true;
+		}
+
+		bool steal(Job& job) noexcept {
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mBack == mFront) { return false; }
+			job = mJobs[mFront++ % CAPACITY];
+			return true;
+		}
+
+	private:
+		std::mutex mMutex;
+		std::array<Job, CAPACITY> mJobs;
+		// ever increasing, the queue holds [mFront, mBack)
+		uint64_t mFront{ 0u };
+		uint64_t mBack{ 0u };
+	};
+
+	/**
+	* A small work stealing scheduler: one WorkQueue per thread, the thread that created the system counts as thread 0
+	* and runs jobs while it waits. Workers sleep when there is nothing to do, so an idle system costs nothing between frames
+	*/
+	class JobSystem final {
+	public:
+
+		/**
+		* @param threadCount - The number of threads that run jobs, including the calling one. 0 uses every hardware thread,
+		* 1 runs everything inline on the calling thread
+		*/
+		explicit JobSystem(uint32_t threadCount = 0u);
+		~JobSystem() noexcept;
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		inline uint32_t threadCount() const noexcept {
+			return static_cast<uint32_t>(mQueues.size());
+		}
+
+		/**
+		* @brief Queues a job on the calling thread's queue, where idle threads can steal it. Runs it inline if the queue is full
+		*/
+		void submit(Counter& counter, Job job) noexcept;
+
+		/**
+		* @brief Runs jobs (any jobs, not just the counter's) until every job of the counter has finished
+		*/
+		void wait(Counter& counter) noexcept;
+
+		/**
+		* @brief Splits [0, count) into ranges of grain items, runs f(begin, end) on each across the threads and joins.
+		* The ranges only depend on count and grain, never on the number of threads
+		*/
+		template<typename F>
+		void parallelFor(uint32_t count, uint32_t grain, F&& f) noexcept {
+
+			if (count == 0u) { return; }
+			if (grain == 0u) { grain = 1u; }
+
+			if (threadCount() == 1u || count <= grain) {
+				f(0u, count);
+				return;
+			}
+
+			using Function = typename std::remove_reference<F>::type;
+			auto trampoline = [](void* data, uint32_t begin, uint32_t end) {
+				(*static_cast<Function*>(data))(begin, end);
+			};
+
+			// fork every range but the first, which this thread runs itself
+			Counter counter;
+			for (uint32_t begin = grain; begin < count; begin += grain) {
+				const uint32_t end = count - begin < grain ? count : begin + grain;
+				push(counter, Job{ trampoline, const_cast<void*>(static_cast<const void*>(&f)), begin, end, &counter });
+			}
+			wakeWorkers();
+
+			f(0u, grain);
+
+			// join
+			wait(counter);
+		}
+
+		/**
+		* @return The index of the calling thread's queue, 0 for any thread that is not one of this system's workers
+		*/
+		uint32_t threadIndex() const noexcept;
+
+	private:
+
+		// submit without waking anyone up, for batches of jobs
+		void push(Counter& counter, Job job) noexcept;
+		bool runOne(uint32_t self) noexcept;
+		void workerLoop(uint32_t index) noexcept;
+		void wakeWorkers() noexcept;
+
+		std::vector<std::unique_ptr<WorkQueue>> mQueues;
+		std::vector<std::thread> mThreads;
+
+		std::atomic<bool> mStop{ false };
+		// the number of jobs sitting in the queues, workers sleep while it is 0
+		std::atomic<uint32_t> mQueued{ 0u };
+		std::mutex mSleepMutex;
+		std::condition_variable mWake;
+	};
+
+	/**
+	* @brief JobSystem::parallelFor, or a plain call over the whole range when there is no job system
+	*/
+	template<typename F>
+	inline void parallelFor(JobSystem* system, uint32_t count, uint32_t grain, F&& f) noexcept {
+		if (system != nullptr) {
+			system->parallelFor(count, grain, f);
+		}
+		else if (count > 0u) {
+			f(0u, count);
+		}
+	}
+}
+
+#endif // !JOB_SYSTEM_H_
@@ -0,0 +1,145 @@
+#ifndef ACTIVATION_H_
+#define ACTIVATION_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "entity/entity_store.h"
+
+/**
+* A span of the level (along x) that keeps entities awake, usually what a player's camera can see plus a margin
+*/
+struct ActivationWindow {
+	float left;
+	float right;
+};
+
+/**
+* Puts entities to sleep when they are far from every ActivationWindow, and wakes them when a window reaches them again.
+*
+* The level is cut into sectors of SECTOR_WIDTH columns. A sector is awake if a window overlaps it; awake entities are
+* put to sleep once they are more than one sector away from every awake sector (so entities on the edge don't flicker
+* between states), and remembered in the list of the sector they fell asleep in. Since sleeping entities never move,
+* waking only has to look at the lists of the sectors that just woke up, in sector order and then in the order the
+* entities fell asleep, so the wake order is the same on every machine. Each tick costs the size of the awake set
+* plus whatever wakes up
+*/
+class ActivationGrid final {
+public:
+
+	static constexpr int SECTOR_WIDTH = 16;
+
+	/**
+	* @brief Resizes the grid for a level this many columns wide and forgets every sleeping entity; the caller
+	* has to wake them all (EntityStore::wakeAll)
+	*/
+	void resize(int levelWidth) {
+		const size_t count = static_cast<size_t>((std::max(levelWidth, 1) + SECTOR_WIDTH - 1) / SECTOR_WIDTH);
+		mSleepers.resize(count);
+		for (std::vector<EntityId>& sector : mSleepers) {
+			sector.clear();
+		}
+		mAwake.assign(count, 0u);
+		mWasAwake.assign(count, 0u);
+		mKeep.assign(count, 0u);
+	}
+
+	inline int sectorCount() const noexcept {
+		return static_cast<int>(mSleepers.size());
+	}
+
+	/**
+	* @return The sector a column is in, positions off the level are clamped to the first or last sector
+	*/
+	inline int sectorOf(float x) const noexcept {
+		const int s = static_cast<int>(std::floor(x)) / SECTOR_WIDTH;
+		return std::clamp(x < 0.0f ? 0 : s, 0, sectorCount() - 1);
+	}
+
+	/**
+	* @brief Puts the entities outside of every window to sleep and wakes the ones a window has reached
+	*/
+	void update(EntityStore& store, const ActivationWindow* windows, uint32_t windowCount) noexcept {
+
+		if (mSleepers.empty()) { return; }
+
+		// Mark the sectors the windows overlap, and the ones right next to them
+		std::fill(mAwake.begin(), mAwake.end(), uint8_t(0u));
+		std::fill(mKeep.begin(), mKeep.end(), uint8_t(0u));
+		for (uint32_t w = 0u; w < windowCount; w++) {
+			const int first = sectorOf(windows[w].left);
+			const int last = sectorOf(windows[w].right);
+			for (int s = first; s <= last; s++) {
+				mAwake[s] = 1u;
+			}
+			for (int s = std::max(first - 1, 0); s <= std::min(last + 1, sectorCount() - 1); s++) {
+				mKeep[s] = 1u;
+			}
+		}
+
+		// Sleep pass, backwards so the entity swapped into i has already been looked at. Dead entities stay awake
+		// until their death clip ends : it is only checked against the tick while awake, asleep they would never be removed
+		store.forEachBlock([this](EntityBlock& block) {
+			for (uint32_t i = block.awake; i-- > 0u;) {
+				const int s = sectorOf(block.position[i].x);
+				if (!mKeep[s] && block.alive(i)) {
+					mSleepers[s].push_back(block.id(i));
+					block.sleep(i);
+				}
+			}
+		});
+
+		// Wake pass over the sectors that just woke up
+		for (int s = 0; s < sectorCount(); s++) {
+			if (mAwake[s] && !mWasAwake[s]) {
+				for (const EntityId id : mSleepers[s]) {
+					EntityHandle handle = store.resolve(id);
+					if (handle.valid()) {
+						store.block(id.type()).wake(handle.index());
+					}
+				}
+				mSleepers[s].clear();
+			}
+		}
+
+		std::swap(mAwake, mWasAwake);
+	}
+
+	/**
+	* @brief Writes who sleeps where; the grid has to be loaded into a level of the same width
+	*/
+	void save(SnapshotWriter& out) const {
+		out.writeArray(mWasAwake);
+		for (const std::vector<EntityId>& sector : mSleepers) {
+			out.writeArray(sector);
+		}
+	}
+
+	void load(SnapshotReader& in) {
+		in.readArray(mWasAwake);
+		for (std::vector<EntityId>& sector : mSleepers) {
+			in.readArray(sector);
+		}
+	}
+
+	size_t memoryUsage() const noexcept {
+		size_t bytes = mAwake.capacity() + mWasAwake.capacity() + mKeep.capacity()
+			+ mSleepers.capacity() * sizeof(std::vector<EntityId>);
+		for (const std::vector<EntityId>& sector : mSleepers) {
+			bytes += sector.capacity() * sizeof(EntityId);
+		}
+		return bytes;
+	}
+
+private:
+	// the ids of the entities that fell asleep in each sector
+	std::vector<std::vector<EntityId>> mSleepers;
+	// which sectors a window overlaps this tick, and the last
+	std::vector<uint8_t> mAwake;
+	std::vector<uint8_t> mWasAwake;
+	// which sectors are close enough to a window to keep their entities awake
+	std::vector<uint8_t> mKeep;
+};
+
+#endif // !ACTIVATION_H_
@@ -14,6 +14,11 @@ enum class TC_Type {
 	PIPE // interaction tiles
 };
 
+// Whether or not entities are stopped by a tile of this type
+inline constexpr bool isBlocking(TC_Type type) noexcept {
+	return type == TC_Type::STRENGTH_1 || type == TC_Type::STRENGTH_2 || type == TC_Type::STRENGTH_3 || type == TC_Type::PIPE;
+}
+
 class Entity;
 class Player;
 
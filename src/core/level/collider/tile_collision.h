@@ -0,0 +1,207 @@
+#ifndef TILE_COLLISION_H_
+#define TILE_COLLISION_H_
+
+#include <cmath>
+#include <array>
+
+#include <glm/vec2.hpp>
+
+#include "collider.h"
+#include "../level.h"
+
+namespace collision {
+
+	// Which side of the moving box touched the tile
+	enum class TileSide : uint8_t {
+		LEFT,
+		RIGHT,
+		BOTTOM, // feet
+		TOP // head
+	};
+
+	// Flags returned from a sweep
+	enum TileHit : uint8_t {
+		HIT_NONE = 0,
+		HIT_WALL = 1 << 0,
+		HIT_GROUND = 1 << 1,
+		HIT_CEILING = 1 << 2
+	};
+
+	struct TileContact {
+		int x;
+		int y;
+		TC_Type type;
+		TileSide side;
+		// index of the entity in the batch that made the contact
+		uint32_t entity;
+	};
+
+	/**
+	* A fixed size list of contacts, so a sweep never allocates. Contacts past the capacity are dropped,
+	* the blocking response is still applied
+	*/
+	struct TileContactBuffer {
+
+		static constexpr uint32_t CAPACITY = 256u;
+
+		inline void clear() noexcept {
+			count = 0u;
+		}
+
+		inline void push(const TileContact& contact) noexcept {
+			if (count < CAPACITY) {
+				contacts[count++] = contact;
+			}
+		}
+
+		uint32_t count{ 0u };
+		std::array<TileContact, CAPACITY> contacts;
+	};
+
+	namespace detail {
+
+		// Keeps boxes that are exactly touching a tile from counting as overlapping it
+		static constexpr float EPSILON = 1.0f / 1024.0f;
+
+		inline int floorToInt(float f) noexcept {
+			return static_cast<int>(std::floor(f));
+		}
+
+		inline void pushBlockingContacts(const Level& level, int x0, int y0, int x1, int y1, TileSide side,
+			uint32_t entity, TileContactBuffer* contacts) noexcept {
+
+			if (contacts == nullptr) { return; }
+
+			level.forEachTile(x0, y0, x1, y1, [&](int x, int y, const Tile& tile) {
+				if (tile.solid()) {
+					contacts->push({ x, y, tile.type(), side, entity });
+				}
+			});
+		}
+
+		/**
+		* @brief Moves the box along one axis, stepping over the tile columns (or rows) the leading edge crosses, nearest first
+		* @return true if the box was stopped by a solid tile
+		*/
+		inline bool sweepAxis(const Level& level, int axis, glm::vec2& position, glm::vec2& velocity, const glm::vec2& dimensions,
+			uint32_t entity, TileContactBuffer* contacts) noexcept {
+
+			const float move = velocity[axis];
+			if (move == 0.0f) { return false; }
+
+			const int other = axis ^ 1;
+
+			// The span of tiles the box covers on the other axis
+			const int lo = floorToInt(position[other] + EPSILON);
+			const int hi = floorToInt(position[other] + dimensions[other] - EPSILON);
+
+			if (move > 0.0f) {
+				// The leading edge is the right / top of the box
+				const float edge = position[axis] + dimensions[axis];
+				const int first = floorToInt(edge - EPSILON) + 1;
+				const int last = static_cast<int>(std::ceil(edge + move)) - 1;
+
+				for (int i = first; i <= last; i++) {
+					const bool blocked = axis == 0 ? level.solidMask.anySolid(i, lo, i, hi) : level.solidMask.anySolid(lo, i, hi, i);
+					if (blocked) {
+						const TileSide side = axis == 0 ? TileSide::RIGHT : TileSide::TOP;
+						if (axis == 0) { pushBlockingContacts(level, i, lo, i, hi, side, entity, contacts); }
+						else { pushBlockingContacts(level, lo, i, hi, i, side, entity, contacts); }
+
+						position[axis] = static_cast<float>(i) - dimensions[axis];
+						velocity[axis] = 0.0f;
+						return true;
+					}
+				}
+			}
+			else {
+				// The leading edge is the left / bottom of the box
+				const float edge = position[axis];
+				const int first = floorToInt(edge + EPSILON) - 1;
+				const int last = floorToInt(edge + move);
+
+				for (int i = first; i >= last; i--) {
+					const bool blocked = axis == 0 ? level.solidMask.anySolid(i, lo, i, hi) : level.solidMask.anySolid(lo, i, hi, i);
+					if (blocked) {
+						const TileSide side = axis == 0 ? TileSide::LEFT : TileSide::BOTTOM;
+						if (axis == 0) { pushBlockingContacts(level, i, lo, i, hi, side, entity, contacts); }
+						else { pushBlockingContacts(level, lo, i, hi, i, side, entity, contacts); }
+
+						position[axis] = static_cast<float>(i + 1);
+						velocity[axis] = 0.0f;
+						return true;
+					}
+				}
+			}
+
+			position[axis] += move;
+			return false;
+		}
+	}
+
+	/**
+	* @brief Moves a box by its velocity through the level's tiles. Each axis is resolved on its own (x first, then y),
+	* only the tiles the leading edge sweeps through are tested, so fast movers never tunnel through terrain.
+	* The velocity on a blocked axis is zeroed
+	* @param level - The level with the tiles to collide against
+	* @param position - The bottom left of the box, moved in place
+	* @param velocity - The displacement for this tick, zeroed on a blocked axis
+	* @param dimensions - The width and height of the box
+	* @param entity - An id stored with each contact, usually the index of the entity in a batch
+	* @param contacts - Optional buffer that collects every blocking tile that was touched
+	* @return The TileHit flags
+	*/
+	inline uint8_t sweep(const Level& level, glm::vec2& position, glm::vec2& velocity, const glm::vec2& dimensions,
+		uint32_t entity = 0u, TileContactBuffer* contacts = nullptr) noexcept {
+
+		uint8_t hits = HIT_NONE;
+
+		if (detail::sweepAxis(level, 0, position, velocity, dimensions, entity, contacts)) {
+			hits |= HIT_WALL;
+		}
+
+		const bool falling = velocity.y < 0.0f;
+		if (detail::sweepAxis(level, 1, position, velocity, dimensions, entity, contacts)) {
+			hits |= falling ? HIT_GROUND : HIT_CEILING;
+		}
+
+		return hits;
+	}
+
+	/**
+	* @brief Sweeps every entity in the batch against the tiles and sets canJump on entities that landed
+	* @param entities - The entities to move, dead entities are skipped
+	* @param count - The number of entities
+	* @param contacts - Optional buffer for the contacts of the whole batch; TileContact::entity is the index in the batch
+	*/
+	inline void sweepEntities(const Level& level, Entity* const* entities, uint32_t count, TileContactBuffer* contacts = nullptr) noexcept {
+
+		for (uint32_t i = 0u; i < count; i++) {
+			Entity* e = entities[i];
+			if (!e->alive) { continue; }
+
+			const uint8_t hits = sweep(level, e->position, e->velocity, e->dimensions, i, contacts);
+			e->canJump = (hits & HIT_GROUND) != 0;
+		}
+	}
+
+	/**
+	* @brief Finds the coins the box is overlapping, coins do not block so they are never found by a sweep
+	*/
+	inline void overlapCoins(const Level& level, const glm::vec2& position, const glm::vec2& dimensions,
+		uint32_t entity, TileContactBuffer* contacts) noexcept {
+
+		const int x0 = detail::floorToInt(position.x + detail::EPSILON);
+		const int y0 = detail::floorToInt(position.y + detail::EPSILON);
+		const int x1 = detail::floorToInt(position.x + dimensions.x - detail::EPSILON);
+		const int y1 = detail::floorToInt(position.y + dimensions.y - detail::EPSILON);
+
+		level.forEachTile(x0, y0, x1, y1, [&](int x, int y, const Tile& tile) {
+			if (tile.type() == TC_Type::COIN) {
+				contacts->push({ x, y, TC_Type::COIN, TileSide::BOTTOM, entity });
+			}
+		});
+	}
+}
+
+#endif // !TILE_COLLISION_H_
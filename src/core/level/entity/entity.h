@@ -3,7 +3,7 @@
 
 #include <glm/vec2.hpp>
 
-#include "../../../graphics/renderer.h"
+#include "../../../graphics/render_list.h"
 #include "../../../graphics/line_renderer.h"
 #include "../../../graphics/animator.h"
 #include "../../../graphics/particle.h"
@@ -36,15 +36,24 @@ enum class EntityType : size_t {
 	GREEN_MUSHROOM,
 	STAR,
 	FIRE_FLOWER,
+	// the number of types, not a type
+	COUNT
 };
 
+static constexpr size_t ENTITY_TYPE_COUNT = static_cast<size_t>(EntityType::COUNT);
+
+// Downwards acceleration applied each tick, in tiles per tick squared
+static constexpr float GRAVITY = 9.8f / (60.0f * 60.0f);
+// The fastest anything falls, in tiles per tick
+static constexpr float TERMINAL_VELOCITY = 0.4f;
+
 class Player;
 
 class Entity {
 public:
 
 	// @brief - Other functions
-	virtual void draw(Renderer*) noexcept = 0;
+	virtual void draw(RenderList*) noexcept = 0;
 	virtual void update() noexcept = 0;
 
 	virtual EntityType getType() const noexcept = 0;
@@ -66,12 +75,12 @@ public:
 		lineRenderer->buffer(q.getBottomRight(), q.getTopRight());
 	}
 
-	glm::vec2 position;
-	glm::vec2 velocity;
-	glm::vec2 dimensions;
-	EntityType type;
-	bool alive;
-	bool canJump;
+	glm::vec2 position{ 0.0f, 0.0f };
+	glm::vec2 velocity{ 0.0f, 0.0f };
+	glm::vec2 dimensions{ 1.0f, 1.0f };
+	EntityType type{ EntityType::NONE };
+	bool alive{ true };
+	bool canJump{ false };
 
 protected:
 	/**
@@ -3,7 +3,125 @@
 // File with every entity include imaginable
 
 #include "entity.h"
+#include "entity_store.h"
 #include "player.h"
 #include "goomba.h"
 #include "koopa.h"
 #include "bowser.h"
+#include "motion.h"
+
+/**
+* Dispatches to the kernels of each entity type, a switch per block instead of a virtual call per entity.
+* Types without kernels of their own just fall through and sit still
+*/
+namespace kernels {
+
+	/**
+	* @param tick - The level's tick, animations start from it
+	*/
+	inline void spawn(EntityBlock& block, uint32_t i, uint32_t tick) noexcept {
+		switch (block.type) {
+		case EntityType::GOOMBA:
+			goomba::spawn(block, i, tick);
+			break;
+		case EntityType::RED_KOOPA:
+		case EntityType::GREEN_KOOPA:
+		case EntityType::RED_PARAKOOPA:
+		case EntityType::GREEN_PARAKOOPA:
+			koopa::spawn(block, i, tick);
+			break;
+		default:
+			break;
+		}
+	}
+
+	/**
+	* @return How the integration stage moves entities of the type
+	*/
+	inline motion::MotionParams motionParams(EntityType type) noexcept {
+		switch (type) {
+		case EntityType::BULLET_BILL:
+			// flies in a straight line, through everything
+			return { 0.0f, TERMINAL_VELOCITY, 1.0f, false };
+		default:
+			return { GRAVITY, TERMINAL_VELOCITY, 1.0f, true };
+		}
+	}
+
+	/**
+	* @brief Updates the awake entities in [begin, end)
+	*/
+	inline void update(EntityBlock& block, uint32_t begin, uint32_t end, uint32_t tick) noexcept {
+		switch (block.type) {
+		case EntityType::GOOMBA:
+			goomba::update(block, begin, end, tick);
+			break;
+		case EntityType::RED_KOOPA:
+		case EntityType::GREEN_KOOPA:
+		case EntityType::RED_PARAKOOPA:
+		case EntityType::GREEN_PARAKOOPA:
+			koopa::update(block, begin, end);
+			break;
+		default:
+			break;
+		}
+	}
+
+	/**
+	* @brief Draws every entity that plays a clip, the same way for every type : the clip and the tick it started at
+	* are all the renderer needs, the frame is picked on the GPU
+	*/
+	inline void draw(const EntityBlock& block, RenderList* list) noexcept {
+		const uint32_t count = block.size();
+		for (uint32_t i = 0u; i < count; i++) {
+			if (block.clip[i] == Clips::NONE) { continue; }
+			list->bufferClip(block.position[i], block.clip[i], block.clipStart[i]);
+		}
+	}
+
+	inline void kill(EntityBlock& block, uint32_t i, uint32_t tick) noexcept {
+		switch (block.type) {
+		case EntityType::GOOMBA:
+			goomba::kill(block, i, tick);
+			break;
+		default:
+			// no death animation, removed at the end of the tick
+			block.flags[i] &= ~ENTITY_ALIVE;
+			block.clip[i] = Clips::NONE;
+			break;
+		}
+	}
+
+	/**
+	* @param particles - Where stomps puff, may be null
+	*/
+	inline void resolvePlayerCollisions(EntityStore& store, EntityType type, Player* const* players, int playerCount,
+		uint32_t tick, ParticleSystem* particles) noexcept {
+		switch (type) {
+		case EntityType::GOOMBA:
+			goomba::resolvePlayerCollisions(store.block(type), players, playerCount, tick, particles);
+			break;
+		case EntityType::RED_KOOPA:
+		case EntityType::GREEN_KOOPA:
+		case EntityType::RED_PARAKOOPA:
+		case EntityType::GREEN_PARAKOOPA:
+			koopa::resolvePlayerCollisions(store, type, players, playerCount, tick, particles);
+			break;
+		default:
+			break;
+		}
+	}
+
+	/**
+	* @return Whether or not the entity is a kicked shell, which kills whatever it runs into
+	*/
+	inline bool isSpinningShell(const EntityBlock& block, uint32_t i) noexcept {
+		switch (block.type) {
+		case EntityType::RED_KOOPA:
+		case EntityType::GREEN_KOOPA:
+			return (block.flags[i] & koopa::SPINNING) != 0;
+		default:
+			return false;
+		}
+	}
+}
@@ -0,0 +1,589 @@
+#ifndef ENTITY_STORE_H_
+#define ENTITY_STORE_H_
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "entity.h"
+#include "../quad.h"
+#include "../state_hash.h"
+#include "../snapshot_stream.h"
+#include "../../../graphics/animation.h"
+#include "../../../graphics/line_renderer.h"
+
+/**
+* A generational reference to an entity that stays valid across compaction, and becomes invalid once the entity is removed.
+* Packed into 32 bits: the slot in its type's pool (bits 0-16), the slot's generation (bits 17-26) and the type (bits 27-31).
+* A type can have at most 131072 entities alive at once, and a slot's generation wraps after 1023 reuses
+*/
+struct EntityId {
+
+	static constexpr uint32_t SLOT_BITS = 17u;
+	static constexpr uint32_t GENERATION_BITS = 10u;
+	static constexpr uint32_t TYPE_BITS = 5u;
+
+	static constexpr uint32_t SLOT_MASK = (1u << SLOT_BITS) - 1u;
+	static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1u;
+	static constexpr uint32_t GENERATION_SHIFT = SLOT_BITS;
+	static constexpr uint32_t TYPE_SHIFT = SLOT_BITS + GENERATION_BITS;
+
+	EntityId() = default;
+
+	constexpr EntityId(EntityType type, uint32_t slot, uint32_t generation) noexcept :
+		mData((static_cast<uint32_t>(type) << TYPE_SHIFT) | ((generation & GENERATION_MASK) << GENERATION_SHIFT) | (slot & SLOT_MASK)) {}
+
+	inline constexpr EntityType type() const noexcept {
+		return static_cast<EntityType>(mData >> TYPE_SHIFT);
+	}
+
+	inline constexpr uint32_t slot() const noexcept {
+		return mData & SLOT_MASK;
+	}
+
+	inline constexpr uint32_t generation() const noexcept {
+		return (mData >> GENERATION_SHIFT) & GENERATION_MASK;
+	}
+
+	// generations start at 1, so the default (zero) id never refers to anything
+	inline constexpr bool null() const noexcept {
+		return mData == 0u;
+	}
+
+	inline constexpr bool operator==(const EntityId& other) const noexcept {
+		return mData == other.mData;
+	}
+
+	inline constexpr bool operator!=(const EntityId& other) const noexcept {
+		return mData != other.mData;
+	}
+
+	uint32_t mData{ 0u };
+};
+
+static_assert(sizeof(EntityId) == 4, "EntityId must stay 32 bits");
+static_assert(ENTITY_TYPE_COUNT <= (1u << EntityId::TYPE_BITS), "Too many entity types to fit in an EntityId");
+
+// Per entity flags, stored in EntityBlock::flags
+enum EntityFlags : uint8_t {
+	ENTITY_ALIVE = 1 << 0,
+	ENTITY_CAN_JUMP = 1 << 1, // landed on a tile this tick
+	ENTITY_HIT_WALL = 1 << 2, // ran into a tile this tick
+	// the rest of the bits are for the type's own use
+	ENTITY_STATE_0 = 1 << 4,
+	ENTITY_STATE_1 = 1 << 5,
+	ENTITY_STATE_2 = 1 << 6,
+	ENTITY_STATE_3 = 1 << 7,
+};
+
+/**
+* Every entity of a single EntityType, with one contiguous array per component, so the update kernel
+* of a type is a tight loop over a few arrays instead of a virtual call per heap allocated object.
+* All component arrays always have the same size; an entity is an index into them.
+*
+* Awake entities are kept at the front of the arrays, in [0, awake); kernels that simulate only run over that range,
+* the sleeping entities after it are only drawn.
+*
+* The block is also the type's pool: a table of slots maps each EntityId to the entity's current index,
+* and freed slots are chained into a free list. Removing entities only shrinks the arrays, so once the block
+* has grown to its high water mark (or was reserved for it), spawning and removing never touch the heap
+*/
+struct EntityBlock final {
+
+	static constexpr uint32_t MAX_SLOTS = EntityId::SLOT_MASK + 1u;
+	static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+	inline uint32_t size() const noexcept {
+		return static_cast<uint32_t>(position.size());
+	}
+
+	inline uint32_t sleeping() const noexcept {
+		return size() - awake;
+	}
+
+	inline bool alive(uint32_t i) const noexcept {
+		return (flags[i] & ENTITY_ALIVE) != 0;
+	}
+
+	inline Quad bounds(uint32_t i) const noexcept {
+		return Quad(position[i], position[i] + dimensions[i]);
+	}
+
+	inline EntityId id(uint32_t i) const noexcept {
+		const uint32_t s = slot[i];
+		return EntityId(type, s, generation[s]);
+	}
+
+	/**
+	* @return The index of the entity, or NO_SLOT if the id is stale (the entity was removed)
+	*/
+	inline uint32_t find(EntityId id) const noexcept {
+		const uint32_t s = id.slot();
+		if (id.type() != type || s >= generation.size() || generation[s] != id.generation()) {
+			return NO_SLOT;
+		}
+		return denseIndex[s];
+	}
+
+	/**
+	* @return The index of the new entity, or NO_SLOT if every slot of the pool is taken
+	*/
+	uint32_t push(glm::vec2 pos, glm::vec2 vel, glm::vec2 dim) {
+
+		// take a slot from the free list, or add a new one
+		uint32_t s = freeHead;
+		if (s != NO_SLOT) {
+			freeHead = denseIndex[s];
+		}
+		else {
+			if (generation.size() >= MAX_SLOTS) { return NO_SLOT; }
+			s = static_cast<uint32_t>(generation.size());
+			generation.push_back(1u);
+			denseIndex.push_back(0u);
+		}
+
+		const uint32_t i = size();
+		denseIndex[s] = i;
+
+		position.push_back(pos);
+		velocity.push_back(vel);
+		dimensions.push_back(dim);
+		flags.push_back(ENTITY_ALIVE);
+		clip.push_back(Clips::NONE);
+		clipStart.push_back(0u);
+		slot.push_back(s);
+
+		// new entities start awake, they were never part of the sleeping hash
+		swapEntities(i, awake);
+		return awake++;
+	}
+
+	/**
+	* @brief Swaps two entities, their ids stay valid
+	*/
+	void swapEntities(uint32_t a, uint32_t b) noexcept {
+		if (a == b) { return; }
+		std::swap(position[a], position[b]);
+		std::swap(velocity[a], velocity[b]);
+		std::swap(dimensions[a], dimensions[b]);
+		std::swap(flags[a], flags[b]);
+		std::swap(clip[a], clip[b]);
+		std::swap(clipStart[a], clipStart[b]);
+		std::swap(slot[a], slot[b]);
+		denseIndex[slot[a]] = a;
+		denseIndex[slot[b]] = b;
+	}
+
+	/**
+	* @brief Moves a sleeping entity into the awake range
+	* @return The entity's new index
+	*/
+	uint32_t wake(uint32_t i) noexcept {
+		if (i < awake) { return i; }
+		sleepingHash ^= hash(i);
+		swapEntities(i, awake);
+		return awake++;
+	}
+
+	/**
+	* @brief Moves an awake entity out of the awake range, the entity that takes its place was the last awake one
+	* @return The entity's new index
+	*/
+	uint32_t sleep(uint32_t i) noexcept {
+		if (i >= awake) { return i; }
+		sleepingHash ^= hash(i);
+		awake--;
+		swapEntities(i, awake);
+		return awake;
+	}
+
+	void wakeAll() noexcept {
+		awake = size();
+		sleepingHash = 0u;
+	}
+
+	/**
+	* @return The hash of one entity's state, its id included
+	*/
+	inline uint64_t hash(uint32_t i) const noexcept {
+		// every awake entity is hashed every tick, so the fields share a single mix
+		const uint64_t idStart = (static_cast<uint64_t>(id(i).mData) << 32) | clipStart[i];
+		const uint64_t a = statehash::bits(position[i]) ^ statehash::rotate(idStart, 29);
+		const uint64_t b = statehash::bits(velocity[i]) ^ statehash::bits(dimensions[i]) * 3u
+			^ (static_cast<uint64_t>(clip[i]) << 8 | flags[i]);
+		return statehash::mix(a * 0x9E3779B97F4A7C15ull + b * 0xC2B2AE3D27D4EB4Full + idStart);
+	}
+
+	/**
+	* @return The xor of the hashes of the awake entities in [begin, end)
+	*/
+	uint64_t hashAwake(uint32_t begin, uint32_t end) const noexcept {
+		uint64_t h = 0u;
+		for (uint32_t i = begin; i < end; i++) {
+			h ^= hash(i);
+		}
+		return h;
+	}
+
+	/**
+	* @brief Removes every entity that is dead and done with its death animation (playing no clip), keeping the order
+	* of the rest. Ids of removed entities become stale, ids of the rest stay valid
+	* @return The number of entities removed
+	*/
+	uint32_t compact() noexcept {
+
+		const uint32_t count = size();
+		uint32_t w = 0u;
+		uint32_t awakeKept = 0u;
+		for (uint32_t i = 0u; i < count; i++) {
+			const uint32_t s = slot[i];
+
+			if (i == awake) {
+				// everything kept so far was awake, order is preserved so the awake range stays at the front
+				awakeKept = w;
+			}
+
+			if (!(flags[i] & ENTITY_ALIVE) && clip[i] == Clips::NONE) {
+				if (i >= awake) { sleepingHash ^= hash(i); }
+
+				// free the slot, bumping its generation so old ids stop resolving (0 is never used)
+				uint16_t g = static_cast<uint16_t>((generation[s] + 1u) & EntityId::GENERATION_MASK);
+				generation[s] = g == 0u ? 1u : g;
+				denseIndex[s] = freeHead;
+				freeHead = s;
+				continue;
+			}
+
+			if (w != i) {
+				position[w] = position[i];
+				velocity[w] = velocity[i];
+				dimensions[w] = dimensions[i];
+				flags[w] = flags[i];
+				clip[w] = clip[i];
+				clipStart[w] = clipStart[i];
+				slot[w] = s;
+			}
+			denseIndex[s] = w;
+			w++;
+		}
+		awake = awake >= count ? w : awakeKept;
+
+		// shrinking never reallocates
+		position.resize(w);
+		velocity.resize(w);
+		dimensions.resize(w);
+		flags.resize(w);
+		clip.resize(w);
+		clipStart.resize(w);
+		slot.resize(w);
+
+		return count - w;
+	}
+
+	/**
+	* @brief Reserves room for this many entities alive at the same time, so spawning below it never allocates
+	*/
+	void reserve(uint32_t capacity) {
+		position.reserve(capacity);
+		velocity.reserve(capacity);
+		dimensions.reserve(capacity);
+		flags.reserve(capacity);
+		clip.reserve(capacity);
+		clipStart.reserve(capacity);
+		slot.reserve(capacity);
+		denseIndex.reserve(capacity);
+		generation.reserve(capacity);
+	}
+
+	/**
+	* @return The bytes allocated for the block's arrays, used or not
+	*/
+	size_t memoryUsage() const noexcept {
+		return position.capacity() * sizeof(glm::vec2) + velocity.capacity() * sizeof(glm::vec2)
+			+ dimensions.capacity() * sizeof(glm::vec2) + flags.capacity() * sizeof(uint8_t)
+			+ clip.capacity() * sizeof(uint16_t) + clipStart.capacity() * sizeof(uint32_t)
+			+ slot.capacity() * sizeof(uint32_t)
+			+ denseIndex.capacity() * sizeof(uint32_t) + generation.capacity() * sizeof(uint16_t);
+	}
+
+	/**
+	* @brief Writes every entity and the pool's slots, so load can put the block back exactly as it is
+	*/
+	void save(SnapshotWriter& out) const {
+		out.write(awake);
+		out.write(freeHead);
+		out.write(sleepingHash);
+		out.writeArray(position);
+		out.writeArray(velocity);
+		out.writeArray(dimensions);
+		out.writeArray(flags);
+		out.writeArray(clip);
+		out.writeArray(clipStart);
+		out.writeArray(slot);
+		out.writeArray(denseIndex);
+		out.writeArray(generation);
+	}
+
+	void load(SnapshotReader& in) {
+		in.read(awake);
+		in.read(freeHead);
+		in.read(sleepingHash);
+		in.readArray(position);
+		in.readArray(velocity);
+		in.readArray(dimensions);
+		in.readArray(flags);
+		in.readArray(clip);
+		in.readArray(clipStart);
+		in.readArray(slot);
+		in.readArray(denseIndex);
+		in.readArray(generation);
+	}
+
+	/**
+	* @brief Removes every entity, the memory is kept. Every slot goes back on the free list with a new generation
+	*/
+	void clear() noexcept {
+		for (uint32_t i = 0u; i < size(); i++) {
+			flags[i] = 0u;
+			clip[i] = Clips::NONE;
+		}
+		compact();
+		sleepingHash = 0u;
+	}
+
+	EntityType type{ EntityType::NONE };
+
+	std::vector<glm::vec2> position;
+	std::vector<glm::vec2> velocity;
+	std::vector<glm::vec2> dimensions;
+	std::vector<uint8_t> flags;
+	// the animation clip the entity plays (Clips), and the tick it started playing it at. Dead entities are removed
+	// once they stop playing a clip
+	std::vector<uint16_t> clip;
+	std::vector<uint32_t> clipStart;
+	// the pool slot of each entity
+	std::vector<uint32_t> slot;
+
+	// Indexed by slot : the entity's index while the slot is in use, the next free slot otherwise
+	std::vector<uint32_t> denseIndex;
+	// Indexed by slot : bumped each time the slot is freed
+	std::vector<uint16_t> generation;
+	uint32_t freeHead{ NO_SLOT };
+
+	// the number of awake entities, they are at the front of the arrays
+	uint32_t awake{ 0u };
+	// The xor of the hashes of the sleeping entities, kept up to date as they fall asleep and wake up since they don't
+	// change in between. Only valid as long as nothing but the simulation touches a sleeping entity
+	uint64_t sleepingHash{ 0u };
+};
+
+class EntityStore;
+
+/**
+* A reference to one entity in the store; mainly so the editor can keep treating entities as objects.
+* It holds the entity's index, so it is only good until the next compaction; keep an EntityId to refer to an entity for longer
+*/
+class EntityHandle final {
+public:
+
+	EntityHandle() = default;
+
+	EntityHandle(EntityBlock* block, uint32_t index) : mBlock(block), mIndex(index) {}
+
+	inline bool valid() const noexcept {
+		return mBlock != nullptr && mIndex < mBlock->size();
+	}
+
+	inline EntityType getType() const noexcept {
+		return mBlock->type;
+	}
+
+	inline uint32_t index() const noexcept {
+		return mIndex;
+	}
+
+	inline EntityId id() const noexcept {
+		return mBlock->id(mIndex);
+	}
+
+	inline glm::vec2& position() const noexcept {
+		return mBlock->position[mIndex];
+	}
+
+	inline glm::vec2& velocity() const noexcept {
+		return mBlock->velocity[mIndex];
+	}
+
+	inline glm::vec2& dimensions() const noexcept {
+		return mBlock->dimensions[mIndex];
+	}
+
+	inline bool alive() const noexcept {
+		return mBlock->alive(mIndex);
+	}
+
+	inline bool awake() const noexcept {
+		return mIndex < mBlock->awake;
+	}
+
+	void drawCollider(LineRenderer* lineRenderer) const noexcept {
+		Quad q = mBlock->bounds(mIndex);
+		lineRenderer->buffer(q.getBottomLeft(), q.getBottomRight());
+		lineRenderer->buffer(q.getTopLeft(), q.getTopRight());
+		lineRenderer->buffer(q.getBottomLeft(), q.getTopLeft());
+		lineRenderer->buffer(q.getBottomRight(), q.getTopRight());
+	}
+
+private:
+	EntityBlock* mBlock{ nullptr };
+	uint32_t mIndex{ 0u };
+};
+
+/**
+* Owns every (non player) entity of a level, grouped into one EntityBlock per EntityType
+*/
+class EntityStore final {
+public:
+
+	EntityStore() {
+		for (size_t t = 0; t < ENTITY_TYPE_COUNT; t++) {
+			mBlocks[t].type = static_cast<EntityType>(t);
+		}
+	}
+
+	/**
+	* @brief Adds an entity of the given type, the type's kernel sets up the rest of its state
+	* @param velocity - The starting velocity, most types override this in their spawn kernel
+	* @return The id of the new entity, or a null id if the type's pool is full
+	*/
+	EntityId spawn(EntityType type, glm::vec2 position, glm::vec2 velocity = { 0.0f, 0.0f },
+		glm::vec2 dimensions = { 1.0f, 1.0f }) {
+		EntityBlock& b = block(type);
+		const uint32_t i = b.push(position, velocity, dimensions);
+		return i == EntityBlock::NO_SLOT ? EntityId() : b.id(i);
+	}
+
+	/**
+	* @return A handle to the entity, invalid if the id is stale
+	*/
+	EntityHandle resolve(EntityId id) noexcept {
+		if (id.null() || static_cast<size_t>(id.type()) >= ENTITY_TYPE_COUNT) { return EntityHandle(); }
+		EntityBlock& b = block(id.type());
+		const uint32_t i = b.find(id);
+		return i == EntityBlock::NO_SLOT ? EntityHandle() : EntityHandle(&b, i);
+	}
+
+	/**
+	* @brief Removes the dead entities of every block, called once at the end of a tick
+	* @return The number of entities removed
+	*/
+	uint32_t compact() noexcept {
+		uint32_t removed = 0u;
+		for (EntityBlock& b : mBlocks) {
+			removed += b.compact();
+		}
+		return removed;
+	}
+
+	/**
+	* @brief Reserves room for this many entities of each type
+	*/
+	void reserve(uint32_t perType) {
+		for (EntityBlock& b : mBlocks) {
+			b.reserve(perType);
+		}
+	}
+
+	size_t memoryUsage() const noexcept {
+		size_t bytes = 0u;
+		for (const EntityBlock& b : mBlocks) {
+			bytes += b.memoryUsage();
+		}
+		return bytes;
+	}
+
+	inline EntityBlock& block(EntityType type) noexcept {
+		return mBlocks[static_cast<size_t>(type)];
+	}
+
+	inline const EntityBlock& block(EntityType type) const noexcept {
+		return mBlocks[static_cast<size_t>(type)];
+	}
+
+	/**
+	* @return The total number of entities in every block, dead or alive
+	*/
+	uint32_t count() const noexcept {
+		uint32_t total = 0u;
+		for (const EntityBlock& b : mBlocks) {
+			total += b.size();
+		}
+		return total;
+	}
+
+	uint32_t awakeCount() const noexcept {
+		uint32_t total = 0u;
+		for (const EntityBlock& b : mBlocks) {
+			total += b.awake;
+		}
+		return total;
+	}
+
+	uint32_t sleepingCount() const noexcept {
+		return count() - awakeCount();
+	}
+
+	void wakeAll() noexcept {
+		for (EntityBlock& b : mBlocks) {
+			b.wakeAll();
+		}
+	}
+
+	/**
+	* @brief Gets the idx'th entity, counting through the blocks in type order
+	*/
+	EntityHandle get(uint32_t idx) noexcept {
+		for (EntityBlock& b : mBlocks) {
+			if (idx < b.size()) {
+				return EntityHandle(&b, idx);
+			}
+			idx -= b.size();
+		}
+		return EntityHandle();
+	}
+
+	void clear() noexcept {
+		for (EntityBlock& b : mBlocks) {
+			b.clear();
+		}
+	}
+
+	void save(SnapshotWriter& out) const {
+		for (const EntityBlock& b : mBlocks) {
+			b.save(out);
+		}
+	}
+
+	void load(SnapshotReader& in) {
+		for (EntityBlock& b : mBlocks) {
+			b.load(in);
+		}
+	}
+
+	// calls f(EntityBlock&) for every block that has entities in it
+	template<typename F>
+	void forEachBlock(F&& f) {
+		for (EntityBlock& b : mBlocks) {
+			if (b.size() > 0u) {
+				f(b);
+			}
+		}
+	}
+
+private:
+	std::array<EntityBlock, ENTITY_TYPE_COUNT> mBlocks;
+};
+
+#endif // !ENTITY_STORE_H_
@@ -1,85 +1,79 @@
 #pragma once
 
-#include "entity.h"
+#include "entity_store.h"
+#include "player.h"
+#include "../../../graphics/sprite_ids.h"
 
-class Goomba final : public Entity {
+/**
+* Goomba kernels, each one runs over every goomba in the level's goomba block
+*/
+namespace goomba {
 
-public:
-	Goomba(glm::vec2 pos) {
-		this->position = pos;
-		this->alive = true;
-		this->deathDuration = 30u;
-		dimensions = { 1.0f, 1.0f };
+	// walking speed, in tiles per tick
+	static constexpr float SPEED = 1.0f / 60.0f;
+	// the amount of time the goomba stays stomped after dying
+	static constexpr uint32_t DEATH_DURATION = 30u;
+
+	inline void spawn(EntityBlock& block, uint32_t i, uint32_t tick) noexcept {
+		// goombas start walking towards the player
+		block.velocity[i] = { -SPEED, 0.0f };
+		block.dimensions[i] = { 1.0f, 1.0f };
+		block.clip[i] = Clips::GOOMBA_WALK;
+		block.clipStart[i] = tick;
 	}
 
-	void draw(Renderer* renderer) noexcept {
-		if (alive) {
-			renderer->buffer(this->position, animator.current());
-		} 
-		else {
-			deathDuration--;
-		}
-	};
-
-	inline EntityType getType() const noexcept {
-		return EntityType::GOOMBA;
+	inline void kill(EntityBlock& block, uint32_t i, uint32_t tick) noexcept {
+		block.flags[i] &= ~ENTITY_ALIVE;
+		block.velocity[i] = { 0.0f, 0.0f };
+		block.clip[i] = Clips::GOOMBA_STOMPED;
+		block.clipStart[i] = tick;
 	}
 
-	void resolvePlayerCollision(Player* p) noexcept {
-		
-		if (!colliding(p)) { return; }
+	/**
+	* @brief Updates the entities in [begin, end), every entity only touches its own state so ranges can run in parallel
+	*/
+	inline void update(EntityBlock& block, uint32_t begin, uint32_t end, uint32_t tick) noexcept {
 
-		// If the player's feet are above the goomba's midsection, it can be stomped
-		if (p->position.y > 0.65f * this->dimensions.y + this->position.y) {
-			this->kill();
-		}
-		// else
-		else {
-			p->damage();
-		}
-	}
+		for (uint32_t i = begin; i < end; i++) {
 
-	void resolveEntityCollision(Entity* e) noexcept {
-
-		if (!colliding(e)) return;
-
-		// if they collided...
+			if (!(block.flags[i] & ENTITY_ALIVE)) {
+				// stay stomped for a bit, then get removed
+				if (block.clip[i] != Clips::NONE && tick - block.clipStart[i] >= DEATH_DURATION) {
+					block.clip[i] = Clips::NONE;
+				}
+				continue;
+			}
 
-		// a koopa can kill the goomba if it's spinning (velocity is very large)
-		if (e->getType() == EntityType::GREEN_KOOPA) {
-			if (e->velocity.x > 2.5f / 60.0f) {
-				this->kill();
+			// turn around when walking into a wall
+			if (block.flags[i] & ENTITY_HIT_WALL) {
+				block.velocity[i].x = -block.velocity[i].x;
 			}
-			else { this->reverse(); e->reverse(); }
 		}
-		else {
-			// if it's neither a player nor spinning koopa, flip the two entities
-			this->reverse(); 
-			e->reverse();
-		}
-	}
-
-	void kill() noexcept {
-		this->alive = false;
-	}
-
-	void update() noexcept {
-		this->position += this->velocity;
-		animator.update();
 	}
 
-	void damage() noexcept {}
-
-	void reverse() noexcept {
-		this->velocity *= -1.0f;
+	inline void resolvePlayerCollisions(EntityBlock& block, Player* const* players, int playerCount, uint32_t tick,
+		ParticleSystem* particles) noexcept {
+
+		const uint32_t count = block.awake;
+		for (int p = 0; p < playerCount; p++) {
+			Player* player = players[p];
+			const Quad playerBounds(player->position, player->position + player->dimensions);
+
+			for (uint32_t i = 0u; i < count; i++) {
+				if (!(block.flags[i] & ENTITY_ALIVE)) { continue; }
+				if (!block.bounds(i).overlapsQuad(playerBounds)) { continue; }
+
+				// If the player's feet are above the goomba's midsection, it can be stomped
+				if (player->position.y > 0.65f * block.dimensions[i].y + block.position[i].y) {
+					kill(block, i, tick);
+					if (particles != nullptr) {
+						particles->burst(ParticleType::STOMP_PUFF, block.position[i], tick);
+					}
+				}
+				else {
+					player->damage();
+				}
+			}
+		}
 	}
-
-private:
-
-
-	// walking animation, 20 frames in between each
-	Animator animator = Animator({Sprites::GOOMBA_LEFT, Sprites::GOOMBA_RIGHT}, 20);
-
-	// the amount of time the goomba stays stomped after dying
-	uint32_t deathDuration;
-};
\ No newline at end of file
+}
@@ -1,100 +1,121 @@
 #pragma once
 
-#include "entity.h"
-
-// Has two colors and a boolean whther or not it has wings
-class Koopa final : public Entity {
+#include "entity_store.h"
+#include "player.h"
+#include "../../../graphics/sprite_ids.h"
+
+/**
+* Koopa kernels. Koopas have two colors and may have wings, each combination is its own EntityType
+* (and block), so the same kernels run over the four koopa blocks
+*/
+namespace koopa {
+
+	// walking speed, in tiles per tick
+	static constexpr float SPEED = 0.75f / 60.0f;
+	// a kicked shell is fast enough to kill other entities
+	static constexpr float SHELL_SPEED = 4.0f / 60.0f;
+	// the upwards velocity of a parakoopa's hop
+	static constexpr float HOP_SPEED = 8.0f / 60.0f;
+
+	// State bits
+	static constexpr uint8_t STOMPED = ENTITY_STATE_0;
+	static constexpr uint8_t SPINNING = ENTITY_STATE_1;
+
+	static constexpr EntityType types[4] = {
+		EntityType::RED_KOOPA,
+		EntityType::GREEN_KOOPA,
+		EntityType::RED_PARAKOOPA,
+		EntityType::GREEN_PARAKOOPA,
+	};
 
-public:
+	inline constexpr EntityType getType(bool green, bool winged) noexcept {
+		return types[winged * 2 + green];
+	}
 
-	Koopa(glm::vec2 position, bool green, bool winged) {
-		this->position = position;
-		this->green = green;
-		this->winged = winged;
-		this->stomped = false;
-		this->setCorrectAnimator();
+	inline constexpr bool isWinged(EntityType type) noexcept {
+		return type == EntityType::RED_PARAKOOPA || type == EntityType::GREEN_PARAKOOPA;
 	}
 
-	// If the koopa is green or not
-	int green : 1;
-	// If the koopa is winged or not
-	int winged : 1;
-	// whether or not the koopa is spinning
-	int spinning : 1;
-	bool stomped;
-	// if the koopa is on the ground or not
-	int touchingGround : 1;
-	// the health only needs a value between 0 - 3; 0 = dead; 1 = alive but in cramped position; 2 = alive, no wings; 3 = alive with wings
-	int health : 2;
-
-	void draw(Renderer* renderer) noexcept {
-		renderer->buffer(position, animator.current());
+	inline void spawn(EntityBlock& block, uint32_t i, uint32_t tick) noexcept {
+		block.velocity[i] = { -SPEED, 0.0f };
+		block.dimensions[i] = { 1.0f, 1.5f };
+		block.clip[i] = Clips::KOOPA_WALK;
+		block.clipStart[i] = tick;
 	}
-	
-	void update() noexcept {
 
-		position += velocity;
-		velocity -= 9.8f / 60.0f;
+	inline void update(EntityBlock& block, uint32_t begin, uint32_t end) noexcept {
 
-	}
+		const bool winged = isWinged(block.type);
+
+		for (uint32_t i = begin; i < end; i++) {
 
-private:
+			if (!(block.flags[i] & ENTITY_ALIVE)) { continue; }
 
-	void setCorrectAnimator() noexcept {
-		if (green) {
-			if (winged) { // green and winged
-				this->animator = Animator<2>({ Sprites::PARAKOOPA_G_1, Sprites::PARAKOOPA_G_2 }, 15);
+			if (block.flags[i] & ENTITY_HIT_WALL) {
+				block.velocity[i].x = -block.velocity[i].x;
 			}
-			else { // green and not winged
-				if (stomped) {
-					this->animator = Animator<2>({ Sprites::KOOPA_G_STOMPED_1, Sprites::KOOPA_G_STOMPED_2 }, 15);
-				}
-				else {
-					this->animator = Animator<2>({ Sprites::KOOPA_G_1, Sprites::KOOPA_G_2 }, 15);
-				}
+
+			if (winged && (block.flags[i] & ENTITY_CAN_JUMP)) {
+				block.velocity[i].y = HOP_SPEED;
 			}
 		}
-		else { // red 
-			if (winged) { // red and winged
-				this->animator = Animator<2>({ Sprites::PARAKOOPA_R_1, Sprites::PARAKOOPA_R_2 }, 15);
-			}
-			else { // red and not winged
-				if (stomped) {
-					this->animator = Animator<2>({ Sprites::KOOPA_R_STOMPED_1, Sprites::KOOPA_R_STOMPED_2 }, 15);
+	}
+
+	inline void resolvePlayerCollisions(EntityStore& store, EntityType type, Player* const* players, int playerCount,
+		uint32_t tick, ParticleSystem* particles) noexcept {
+
+		EntityBlock& block = store.block(type);
+
+		const uint32_t count = block.awake;
+		for (int p = 0; p < playerCount; p++) {
+			Player* player = players[p];
+			const Quad playerBounds(player->position, player->position + player->dimensions);
+
+			for (uint32_t i = 0u; i < count; i++) {
+				uint8_t& flags = block.flags[i];
+				if (!(flags & ENTITY_ALIVE)) { continue; }
+				if (!block.bounds(i).overlapsQuad(playerBounds)) { continue; }
+
+				const bool stomp = player->position.y > 0.65f * block.dimensions[i].y + block.position[i].y;
+				const bool kickable = (flags & STOMPED) && !(flags & SPINNING);
+
+				if (stomp && isWinged(type)) {
+					// lose the wings : move into the block of the koopa with the same color and no wings
+					const bool green = type == EntityType::GREEN_PARAKOOPA;
+					EntityBlock& walkers = store.block(getType(green, false));
+					const uint32_t w = walkers.push(block.position[i], { block.velocity[i].x, 0.0f }, block.dimensions[i]);
+					if (w != EntityBlock::NO_SLOT) {
+						walkers.clip[w] = Clips::KOOPA_WALK;
+						walkers.clipStart[w] = tick;
+					}
+					flags = 0u;
+					block.clip[i] = Clips::NONE;
+				}
+				else if (stomp && !(flags & STOMPED)) {
+					// hide in the shell
+					flags |= STOMPED;
+					block.velocity[i].x = 0.0f;
+					block.clip[i] = Clips::KOOPA_SHELL;
+					block.clipStart[i] = tick;
+					if (particles != nullptr) {
+						particles->burst(ParticleType::STOMP_PUFF, block.position[i], tick);
+					}
+				}
+				else if (stomp && (flags & SPINNING)) {
+					// stop the shell
+					flags &= ~SPINNING;
+					block.velocity[i].x = 0.0f;
+				}
+				else if (kickable) {
+					// kick the shell away from the player
+					flags |= SPINNING;
+					const bool fromLeft = player->position.x < block.position[i].x;
+					block.velocity[i].x = fromLeft ? SHELL_SPEED : -SHELL_SPEED;
 				}
 				else {
-					this->animator = Animator<2>({ Sprites::KOOPA_R_1, Sprites::KOOPA_R_2 }, 15);
+					player->damage();
 				}
 			}
 		}
 	}
-
-	static constexpr EntityType type_table[4] = {
-		EntityType::RED_KOOPA,
-		EntityType::GREEN_KOOPA,
-		EntityType::RED_PARAKOOPA,
-		EntityType::GREEN_PARAKOOPA,
-	};
-
-public:
-
-	EntityType getType() const noexcept {
-		return type_table[winged * 2 + green];
-	}
-	
-	void reverse() noexcept {
-
-	}
-	
-	void damage() noexcept {
-		if (this->winged) { this->winged = false; }
-		
-	}
-	
-	void kill() noexcept {
-
-	}
-
-private:
-	Animator<2> animator;
-};
\ No newline at end of file
+}
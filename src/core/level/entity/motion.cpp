@@ -0,0 +1,193 @@
+#include "motion.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MOTION_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC lets any function use any intrinsic
+#define MOTION_TARGET_AVX
+#else
+#define MOTION_TARGET_AVX __attribute__((target("avx")))
+#endif
+#else
+#define MOTION_X86 0
+#endif
+
+namespace motion {
+
+	namespace {
+
+		// velocity.x is lane 0 and velocity.y lane 1 of every float pair
+
+		inline void velocityScalar(float* v, uint32_t floats, const MotionParams& p) noexcept {
+			for (uint32_t i = 0u; i < floats; i += 2u) {
+				v[i] *= p.friction;
+				v[i + 1u] = std::max(v[i + 1u] - p.gravity, -p.terminalVelocity);
+			}
+		}
+
+		inline void integrateScalar(float* x, float* v, uint32_t floats, const MotionParams& p) noexcept {
+			for (uint32_t i = 0u; i < floats; i += 2u) {
+				v[i] *= p.friction;
+				v[i + 1u] = std::max(v[i + 1u] - p.gravity, -p.terminalVelocity);
+				x[i] += v[i];
+				x[i + 1u] += v[i + 1u];
+			}
+		}
+
+#if MOTION_X86
+		// 2 entities per register
+		void velocitySse2(float* v, uint32_t floats, const MotionParams& p) noexcept {
+			const __m128 mul = _mm_setr_ps(p.friction, 1.0f, p.friction, 1.0f);
+			const __m128 sub = _mm_setr_ps(0.0f, p.gravity, 0.0f, p.gravity);
+			const __m128 lo = _mm_setr_ps(-FLT_MAX, -p.terminalVelocity, -FLT_MAX, -p.terminalVelocity);
+
+			uint32_t i = 0u;
+			for (; i + 4u <= floats; i += 4u) {
+				const __m128 vel = _mm_loadu_ps(v + i);
+				_mm_storeu_ps(v + i, _mm_max_ps(_mm_sub_ps(_mm_mul_ps(vel, mul), sub), lo));
+			}
+			velocityScalar(v + i, floats - i, p);
+		}
+
+		void integrateSse2(float* x, float* v, uint32_t floats, const MotionParams& p) noexcept {
+			const __m128 mul = _mm_setr_ps(p.friction, 1.0f, p.friction, 1.0f);
+			const __m128 sub = _mm_setr_ps(0.0f, p.gravity, 0.0f, p.gravity);
+			const __m128 lo = _mm_setr_ps(-FLT_MAX, -p.terminalVelocity, -FLT_MAX, -p.terminalVelocity);
+
+			uint32_t i = 0u;
+			for (; i + 4u <= floats; i += 4u) {
+				const __m128 vel = _mm_max_ps(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(v + i), mul), sub), lo);
+				_mm_storeu_ps(v + i, vel);
+				_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), vel));
+			}
+			integrateScalar(x + i, v + i, floats - i, p);
+		}
+
+		// 4 entities per register
+		MOTION_TARGET_AVX void velocityAvx(float* v, uint32_t floats, const MotionParams& p) noexcept {
+			const __m256 mul = _mm256_setr_ps(p.friction, 1.0f, p.friction, 1.0f, p.friction, 1.0f, p.friction, 1.0f);
+			const __m256 sub = _mm256_setr_ps(0.0f, p.gravity, 0.0f, p.gravity, 0.0f, p.gravity, 0.0f, p.gravity);
+			const float t = -p.terminalVelocity;
+			const __m256 lo = _mm256_setr_ps(-FLT_MAX, t, -FLT_MAX, t, -FLT_MAX, t, -FLT_MAX, t);
+
+			uint32_t i = 0u;
+			for (; i + 8u <= floats; i += 8u) {
+				const __m256 vel = _mm256_loadu_ps(v + i);
+				_mm256_storeu_ps(v + i, _mm256_max_ps(_mm256_sub_ps(_mm256_mul_ps(vel, mul), sub), lo));
+			}
+			velocityScalar(v + i, floats - i, p);
+		}
+
+		MOTION_TARGET_AVX void integrateAvx(float* x, float* v, uint32_t floats, const MotionParams& p) noexcept {
+			const __m256 mul = _mm256_setr_ps(p.friction, 1.0f, p.friction, 1.0f, p.friction, 1.0f, p.friction, 1.0f);
+			const __m256 sub = _mm256_setr_ps(0.0f, p.gravity, 0.0f, p.gravity, 0.0f, p.gravity, 0.0f, p.gravity);
+			const float t = -p.terminalVelocity;
+			const __m256 lo = _mm256_setr_ps(-FLT_MAX, t, -FLT_MAX, t, -FLT_MAX, t, -FLT_MAX, t);
+
+			uint32_t i = 0u;
+			for (; i + 8u <= floats; i += 8u) {
+				const __m256 vel = _mm256_max_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(v + i), mul), sub), lo);
+				_mm256_storeu_ps(v + i, vel);
+				_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), vel));
+			}
+			integrateScalar(x + i, v + i, floats - i, p);
+		}
+#endif
+
+		Isa detect() noexcept {
+#if MOTION_X86
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 1);
+			const bool sse2 = (info[3] & (1 << 26)) != 0;
+			// AVX needs the OS to save the ymm registers too
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = osxsave && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6u) == 6u;
+#else
+			__builtin_cpu_init();
+			const bool sse2 = __builtin_cpu_supports("sse2");
+			const bool avx = __builtin_cpu_supports("avx");
+#endif
+			if (avx) { return Isa::AVX; }
+			if (sse2) { return Isa::SSE2; }
+#endif
+			return Isa::SCALAR;
+		}
+
+		Isa& active() noexcept {
+			static Isa isa = detectIsa();
+			return isa;
+		}
+	}
+
+	Isa detectIsa() noexcept {
+		static const Isa isa = detect();
+		return isa;
+	}
+
+	Isa activeIsa() noexcept {
+		return active();
+	}
+
+	void setIsa(Isa isa) noexcept {
+		active() = std::min(isa, detectIsa());
+	}
+
+	const char* isaName(Isa isa) noexcept {
+		switch (isa) {
+		case Isa::SSE2: return "sse2";
+		case Isa::AVX: return "avx";
+		default: return "scalar";
+		}
+	}
+
+	void integrateVelocity(glm::vec2* velocity, uint32_t count, const MotionParams& params) noexcept {
+
+		if (count == 0u) { return; }
+
+		float* v = &velocity[0].x;
+		const uint32_t floats = count * 2u;
+
+		switch (active()) {
+#if MOTION_X86
+		case Isa::AVX:
+			velocityAvx(v, floats, params);
+			break;
+		case Isa::SSE2:
+			velocitySse2(v, floats, params);
+			break;
+#endif
+		default:
+			velocityScalar(v, floats, params);
+			break;
+		}
+	}
+
+	void integrate(glm::vec2* position, glm::vec2* velocity, uint32_t count, const MotionParams& params) noexcept {
+
+		if (count == 0u) { return; }
+
+		float* x = &position[0].x;
+		float* v = &velocity[0].x;
+		const uint32_t floats = count * 2u;
+
+		switch (active()) {
+#if MOTION_X86
+		case Isa::AVX:
+			integrateAvx(x, v, floats, params);
+			break;
+		case Isa::SSE2:
+			integrateSse2(x, v, floats, params);
+			break;
+#endif
+		default:
+			integrateScalar(x, v, floats, params);
+			break;
+		}
+	}
+}
@@ -0,0 +1,63 @@
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "The motion kernels treat vec2 arrays as packed floats");
+
+/**
+* The integration stage, run over a whole component array at once: gravity, terminal velocity and friction
+* are applied to the velocities, and for entities that ignore the tiles the positions are moved as well
+* (everything else is moved by the tile sweep). Each kernel has a scalar, SSE2 and AVX version, the
+* fastest one the CPU supports is picked the first time a kernel runs
+*/
+namespace motion {
+
+	struct MotionParams {
+		// subtracted from velocity.y every tick
+		float gravity;
+		// the fastest an entity can fall, in tiles per tick
+		float terminalVelocity;
+		// velocity.x is multiplied by this every tick, 1 keeps a constant speed
+		float friction;
+		// false if the entity flies through the tiles, and its position is integrated here
+		bool tileCollision;
+	};
+
+	enum class Isa : uint8_t {
+		SCALAR,
+		SSE2,
+		AVX
+	};
+
+	/**
+	* @return The best instruction set the CPU (and OS) supports
+	*/
+	Isa detectIsa() noexcept;
+
+	/**
+	* @return The instruction set the kernels currently run with
+	*/
+	Isa activeIsa() noexcept;
+
+	/**
+	* @brief Forces the kernels to an instruction set, clamped to what the CPU supports; for benchmarks
+	*/
+	void setIsa(Isa isa) noexcept;
+
+	const char* isaName(Isa isa) noexcept;
+
+	/**
+	* @brief velocity.x *= friction, velocity.y = max(velocity.y - gravity, -terminalVelocity)
+	*/
+	void integrateVelocity(glm::vec2* velocity, uint32_t count, const MotionParams& params) noexcept;
+
+	/**
+	* @brief integrateVelocity, then position += velocity
+	*/
+	void integrate(glm::vec2* position, glm::vec2* velocity, uint32_t count, const MotionParams& params) noexcept;
+}
+
+#endif // !MOTION_H_
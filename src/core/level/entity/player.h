@@ -1,6 +1,7 @@
 #pragma once
 
 #include "entity.h"
+#include "../../controller.h"
 
 class Player final : public Entity {
 
@@ -14,50 +15,52 @@ public:
 		delete mCamera;
 	}
 	
-	void draw(Renderer* renderer) noexcept {
+	void draw(RenderList* list) noexcept {
 		if (alive) {
-			//renderer->buffer(this->position, Sprites::BRICK_BOT);
+			//list->buffer(this->position, Sprites::BRICK_BOT);
 		}
 	}
 
-	void handleInput(GLFWwindow* window) {
+	/**
+	* @brief Applies the input of this tick, the simulation never reads a device directly so a recorded run
+	* replays exactly
+	*/
+	void handleInput(const InputState& input) noexcept {
 
-		// handle each button
-		GLFWgamepadstate state;
-		glfwGetGamepadState(0, &state);
-		
-		if (state.buttons[GLFW_GAMEPAD_BUTTON_A] || state.buttons[GLFW_GAMEPAD_BUTTON_B]) {
+		if (input.isDown(INPUT_JUMP)) {
 			// jump if the player is touching the ground -> add upwards velocity
 
 		}
 
-		if (state.buttons[GLFW_GAMEPAD_BUTTON_X] || state.buttons[GLFW_GAMEPAD_BUTTON_Y]) {
+		if (input.isDown(INPUT_RUN)) {
 			
 		}
 
-		if (state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_RIGHT]) {
+		// The velocity is applied by the level when it resolves collisions with the tiles
+		this->velocity = { 0.0f, 0.0f };
+
+		if (input.isDown(INPUT_RIGHT)) {
 			// set the direction
-			this->position.x += 1.0f / 60.0f;
+			this->velocity.x += 1.0f / 60.0f;
 		}
-		if (state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_LEFT]) {
+		if (input.isDown(INPUT_LEFT)) {
 			// set the direction
-			this->position.x -= 1.0f / 60.0f;
+			this->velocity.x -= 1.0f / 60.0f;
 		}
-		if (state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_UP]) {
+		if (input.isDown(INPUT_UP)) {
 			// set the direction
-			this->position.y += 1.0f / 60.0f;
+			this->velocity.y += 1.0f / 60.0f;
 		}
-		if (state.buttons[GLFW_GAMEPAD_BUTTON_DPAD_DOWN]) {
+		if (input.isDown(INPUT_DOWN)) {
 			// set the direction
-			this->position.y -= 1.0f / 60.0f;
+			this->velocity.y -= 1.0f / 60.0f;
 		}
 	}
 
 	virtual void update() noexcept {
 
 		// TODO: implement
-		position += velocity;
-		
+		// the position is moved by the level's tile collision pass
 	}
 
 	EntityType getType() const noexcept {
@@ -91,8 +94,12 @@ public:
 		return mCamera;
 	}
 
+	Controller& getController() noexcept {
+		return mController;
+	}
+
 private:
-	GLFWgamepadstate state;
+	Controller mController;
 	Camera* mCamera;
 
 	enum class PowerUpState : size_t {
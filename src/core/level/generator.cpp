@@ -0,0 +1,219 @@
+#include "generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#include "level.h"
+#include "entity/koopa.h"
+#include "../serializer.h"
+#include "../../graphics/sprite_ids.h"
+
+namespace generator {
+
+    namespace {
+
+        // the ground is two tiles deep, everything stands on row 2
+        constexpr int GROUND_ROWS = 2;
+        // floating platforms leave room to walk under them, and their coins room to jump to
+        constexpr int PLATFORM_ROW = 5;
+        constexpr int COIN_ROW = PLATFORM_ROW + 3;
+    }
+
+    // Only the raw output of the engine is used, never the standard distributions, which are implemented differently
+    // by every standard library : the same seed gives the same level on every compiler
+    ColumnGenerator::ColumnGenerator(const GeneratorOptions& options) :
+        mRandom(options.seed),
+        mWidth(std::max(options.width, 2 * SAFE_COLUMNS)),
+        mHeight(std::max(options.height, MIN_HEIGHT))
+    {
+        const double span = static_cast<double>(mWidth - 2 * SAFE_COLUMNS);
+        mEnemies = static_cast<uint64_t>(std::llround(std::max(options.enemyDensity, 0.0) * span));
+    }
+
+    void ColumnGenerator::startSegment()
+    {
+        mSegmentStart = mColumn;
+        mSegment = Segment::GROUND;
+        mSegmentSize = 0;
+
+        const int remaining = mWidth - SAFE_COLUMNS - mColumn;
+        if (mColumn < SAFE_COLUMNS || remaining <= 0) {
+            mSegmentLength = mColumn < SAFE_COLUMNS ? SAFE_COLUMNS - mColumn : mWidth - mColumn;
+            mFeatureNext = true;
+            return;
+        }
+
+        if (!mFeatureNext) {
+            mSegmentLength = std::min(3 + static_cast<int>(mRandom() % 10u), remaining);
+            mFeatureNext = true;
+            return;
+        }
+        mFeatureNext = false;
+
+        const uint32_t pick = mRandom() % 100u;
+        if (pick < 15u) {
+            mSegment = Segment::GAP;
+            mSegmentLength = 2 + static_cast<int>(mRandom() % 3u);
+        }
+        else if (pick < 40u) {
+            mSegment = Segment::PIPE;
+            mSegmentLength = 2;
+            mSegmentSize = 2 + static_cast<int>(mRandom() % 3u);
+        }
+        else if (pick < 75u) {
+            mSegment = Segment::PLATFORM;
+            mSegmentLength = 3 + static_cast<int>(mRandom() % 6u);
+            mSegmentSize = PLATFORM_ROW;
+        }
+        else {
+            mSegment = Segment::STAIRS;
+            mSegmentSize = 3 + static_cast<int>(mRandom() % 3u);
+            mSegmentLength = 2 * mSegmentSize;
+        }
+
+        // a feature that would run into the end is left out
+        if (mSegmentLength > remaining) {
+            mSegment = Segment::GROUND;
+            mSegmentLength = remaining;
+            mSegmentSize = 0;
+        }
+    }
+
+    void ColumnGenerator::buildFeature(Tile* column, int offset) noexcept
+    {
+        switch (mSegment) {
+        case Segment::GAP:
+            for (int y = 0; y < GROUND_ROWS; y++) {
+                column[y] = Tile();
+            }
+            break;
+        case Segment::PIPE: {
+            const bool left = offset == 0;
+            const int top = GROUND_ROWS + mSegmentSize - 1;
+            for (int y = GROUND_ROWS; y < top; y++) {
+                column[y] = Tile(TC_Type::PIPE, left ? Sprites::PIPE_SEG_LEFT : Sprites::PIPE_SEG_RIGHT);
+            }
+            column[top] = Tile(TC_Type::PIPE, left ? Sprites::PIPE_TOP_LEFT : Sprites::PIPE_TOP_RIGHT);
+            break;
+        }
+        case Segment::PLATFORM:
+            // a question block in four, with a coin over every other block
+            if (mRandom() % 4u == 0u) {
+                column[mSegmentSize] = Tile(TC_Type::STRENGTH_2, Sprites::QUESTION_BLOCK_1);
+            }
+            else {
+                column[mSegmentSize] = Tile(TC_Type::STRENGTH_1, Sprites::BRICK_TOP);
+            }
+            if (mRandom() % 2u == 0u) {
+                column[COIN_ROW] = Tile(TC_Type::COIN, Sprites::COIN_1);
+            }
+            break;
+        case Segment::STAIRS: {
+            // up one step a column, then back down
+            const int steps = offset < mSegmentSize ? offset + 1 : 2 * mSegmentSize - offset;
+            for (int y = GROUND_ROWS; y < GROUND_ROWS + steps; y++) {
+                column[y] = Tile(TC_Type::STRENGTH_3, Sprites::STONE);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    bool ColumnGenerator::next(Tile* column, std::vector<Spawn>& spawns)
+    {
+        if (mColumn >= mWidth) { return false; }
+
+        if (mColumn >= mSegmentStart + mSegmentLength) {
+            startSegment();
+        }
+
+        std::fill(column, column + mHeight, Tile());
+        for (int y = 0; y < GROUND_ROWS; y++) {
+            column[y] = Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1);
+        }
+        buildFeature(column, mColumn - mSegmentStart);
+
+        // enemies stand on the ground where nothing is in their way, the ones a column could not take go to the next
+        const int x = mColumn++;
+        if (x < SAFE_COLUMNS || mSpawned >= mEnemies) { return true; }
+        if (!column[0].solid() || column[GROUND_ROWS].solid() || column[GROUND_ROWS + 1].solid()) { return true; }
+
+        const uint64_t span = static_cast<uint64_t>(mWidth - 2 * SAFE_COLUMNS);
+        const uint64_t due = x >= mWidth - SAFE_COLUMNS ? mEnemies
+            : mEnemies * static_cast<uint64_t>(x - SAFE_COLUMNS + 1) / span;
+
+        // stacked two tiles apart, only under a platform's blocks
+        const uint64_t room = mSegment == Segment::PLATFORM ? 1u : static_cast<uint64_t>((mHeight - GROUND_ROWS - 2) / 2);
+        const uint64_t count = std::min(due > mSpawned ? due - mSpawned : 0u, room);
+        for (uint64_t k = 0u; k < count; k++) {
+            const uint32_t kind = mRandom() % 10u;
+            const EntityType type = kind < 4u ? EntityType::GOOMBA : koopa::getType(kind % 2u == 0u, kind >= 8u);
+            spawns.push_back({ type, { static_cast<float>(x), static_cast<float>(GROUND_ROWS + 2 * k) } });
+        }
+        mSpawned += count;
+        return true;
+    }
+
+    void generateLevel(Level& level, const GeneratorOptions& options)
+    {
+        ColumnGenerator columns(options);
+
+        level.resizeTiles(columns.width(), columns.height());
+        level.entities.clear();
+
+        std::vector<Tile> column(columns.height());
+        std::vector<Spawn> spawns;
+        for (int x = 0; columns.next(column.data(), spawns); x++) {
+            for (int y = 0; y < columns.height(); y++) {
+                if (column[y].mData != 0u) {
+                    level.addTile(column[y], x, y);
+                }
+            }
+        }
+
+        for (const Spawn& spawn : spawns) {
+            level.addEntity(spawn.type, spawn.position);
+        }
+    }
+
+    int writeLevel(const GeneratorOptions& options, const std::string& path)
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Error while saving level into file [ " << path << " ]\n";
+            return -1;
+        }
+
+        ColumnGenerator columns(options);
+
+        serializer::detail::FileHeader fileHeader{ serializer::detail::FILE_IDENTITY, serializer::detail::FILE_VERSION };
+        serializer::detail::TileDataHeader tileDataHeader{ static_cast<uint32_t>(columns.width()), static_cast<uint32_t>(columns.height()) };
+        out.write((char*)&fileHeader, sizeof(fileHeader));
+        out.write((char*)&tileDataHeader, sizeof(tileDataHeader));
+
+        // the same layout as serializer::saveLevel : the tiles column by column, then the entities
+        std::vector<Tile> column(columns.height());
+        std::vector<uint32_t> packed;
+        std::vector<Spawn> spawns;
+        while (columns.next(column.data(), spawns)) {
+            serializer::detail::writeColumn(&out, column.data(), columns.height(), packed);
+        }
+
+        std::vector<serializer::detail::EntityRecord> records;
+        records.reserve(spawns.size());
+        for (const Spawn& spawn : spawns) {
+            records.push_back({ static_cast<uint32_t>(spawn.type), spawn.position.x, spawn.position.y });
+        }
+
+        serializer::detail::EntityDataHeader entityDataHeader{ static_cast<uint32_t>(records.size()) };
+        out.write((char*)&entityDataHeader, sizeof(entityDataHeader));
+        out.write((char*)records.data(), records.size() * sizeof(serializer::detail::EntityRecord));
+        out.close();
+
+        return out.good() ? 0 : -1;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "tile/tile.h"
+#include "entity/entity.h"
+
+class Level;
+
+/**
+* Seeded levels of any size, for testing the engine at scale. The terrain is a run of segments like the ones of a
+* hand made level : flat ground, gaps, pipes, floating platforms of bricks and question blocks with coins above them,
+* and stairs, with a flat start and end. The same options always give the same level, on every machine
+*/
+namespace generator {
+
+	// the first and last columns are always flat ground without enemies, where the player starts and ends
+	static constexpr int SAFE_COLUMNS = 16;
+
+	// the lowest level the segments fit in
+	static constexpr int MIN_HEIGHT = 16;
+
+	struct GeneratorOptions {
+		int width = 1000;
+		int height = 26;
+		uint32_t seed = 1u;
+		// enemies per column past the start, placed on the ground; several per column stack up
+		double enemyDensity = 0.05;
+	};
+
+	struct Spawn {
+		EntityType type;
+		glm::vec2 position;
+	};
+
+	/**
+	* Builds the level one column at a time, so a level of any width can be written out without ever holding it
+	* in memory. Enemies are spread so the whole level gets round(enemyDensity * (width - SAFE_COLUMNS)) of them,
+	* however many columns the gaps and pipes take
+	*/
+	class ColumnGenerator final {
+	public:
+
+		explicit ColumnGenerator(const GeneratorOptions& options);
+
+		/**
+		* @brief Writes the height tiles of the next column, bottom up, and appends the enemies that stand on it
+		* @return false once every column was generated, nothing is written then
+		*/
+		bool next(Tile* column, std::vector<Spawn>& spawns);
+
+		inline int width() const noexcept {
+			return mWidth;
+		}
+
+		inline int height() const noexcept {
+			return mHeight;
+		}
+
+	private:
+
+		enum class Segment : uint8_t {
+			GROUND,
+			GAP,
+			PIPE,
+			PLATFORM,
+			STAIRS
+		};
+
+		// picks the segment starting at the current column, a feature always follows a stretch of ground
+		void startSegment();
+
+		// the segment's tiles of the column at offset into it, over the ground that is already written
+		void buildFeature(Tile* column, int offset) noexcept;
+
+		std::mt19937 mRandom;
+		int mWidth;
+		int mHeight;
+
+		int mColumn{ 0 };
+		Segment mSegment{ Segment::GROUND };
+		int mSegmentStart{ 0 };
+		int mSegmentLength{ 0 };
+		// the height of a pipe or stairs, the row of a platform
+		int mSegmentSize{ 0 };
+		bool mFeatureNext{ false };
+
+		uint64_t mEnemies;
+		uint64_t mSpawned{ 0u };
+	};
+
+	/**
+	* @brief Resizes the level to the options' size and fills it, any entity it had is removed
+	*/
+	void generateLevel(Level& level, const GeneratorOptions& options);
+
+	/**
+	* @brief Writes a generated level straight into a .lvl file, one column at a time
+	* @return 0 on success, -1 if the file could not be written
+	*/
+	int writeLevel(const GeneratorOptions& options, const std::string& path);
+}
+
+#endif // !GENERATOR_H_
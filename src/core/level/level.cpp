@@ -1,7 +1,25 @@
 #include "level.h"
-
-#define MIN_LEVEL_WIDTH 100u * 2u;
-#define MIN_LEVEL_HEIGHT 13u * 2u;
+#include "collider/tile_collision.h"
+#include "entity/entity_pkg.h"
+#include "../profiler/profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#define MIN_LEVEL_WIDTH (100u * 2u)
+#define MIN_LEVEL_HEIGHT (13u * 2u)
+// entities of each type that can be alive at once before a spawn touches the heap
+#define ENTITY_POOL_SIZE (64u)
+// half of the number of columns a camera sees
+#define VIEW_HALF_WIDTH (12.0f)
+// how far past the edge of the screen entities are still simulated
+#define ACTIVATION_MARGIN (16.0f)
+// entities per job, for the parallel passes over entities
+#define ENTITY_GRAIN (1024u)
+#define COLLISION_GRAIN (256u)
+// the neighbours a narrow phase query is expected to return, its buffer only grows past it in a crowd
+#define QUERY_CAPACITY (64u)
 
 Level::Level() : play(false) {
 
@@ -11,13 +29,16 @@ Level::Level() : play(false) {
 
     // Setup the data width * height
     this->tileData = new Tile[this->width * this->height];
+    this->solidMask.resize(this->width, this->height);
+    this->tileHash.resize(this->width, this->height);
 
     this->tileEntityCount = 0u;
     // TODO: fix
     //this->tileEntityTree = new QuadTree<TileEntity>({ 0.0f,0.0f }, { 100.0f, 13.0f });
 
-    this->entityCount = 0u;
-    this->entityTree = new Quadtree<Entity>({ 0.0f,0.0f }, { 100.0f, 13.0f });
+    this->entityTree = new Quadtree<EntityRef>({ 0.0f,0.0f }, { (float)this->width, (float)this->height });
+    this->entities.reserve(ENTITY_POOL_SIZE);
+    this->activation.resize(this->width);
 
     this->playerCount = 0u;
     this->addPlayer(new Player());
@@ -25,11 +46,6 @@ Level::Level() : play(false) {
 
 Level::~Level() noexcept {
 
-    // Delete entity data
-    for (int i = 0; i < entityCount; i++) {
-        delete entityData[i];
-    }
-
     for (int i = 0; i < playerCount; i++) {
         delete players[i];
     }
@@ -43,22 +59,75 @@ Player* Level::getPlayer(uint32_t idx) const noexcept {
     return this->players[idx];
 }
 
-Entity* Level::getEntity(uint32_t idx) const noexcept {
+EntityHandle Level::getEntity(uint32_t idx) noexcept {
+
+    return this->entities.get(idx);
+}
+
+uint32_t Level::getEntityCount() const noexcept {
+
+    return this->entities.count();
+}
+
+uint32_t Level::getActiveEntityCount() const noexcept {
 
-    return this->entityData[idx];
+    return this->entities.awakeCount();
+}
+
+uint32_t Level::getSleepingEntityCount() const noexcept {
+
+    return this->entities.sleepingCount();
+}
+
+size_t Level::getMemoryUsage() const noexcept {
+
+    size_t bytes = static_cast<size_t>(width) * height * sizeof(Tile) + solidMask.memoryUsage()
+        + entities.memoryUsage() + entityTree->memoryUsage() + activation.memoryUsage()
+        + entityRefs.capacity() * sizeof(EntityRef) + collisionPairs.capacity() * sizeof(EntityPair)
+        + activationWindows.capacity() * sizeof(ActivationWindow) + playerCount * sizeof(Player);
+
+    for (const std::vector<EntityPair>& pairs : pairBuffers) {
+        bytes += pairs.capacity() * sizeof(EntityPair);
+    }
+    for (const std::vector<EntityRef*>& results : queryBuffers) {
+        bytes += results.capacity() * sizeof(EntityRef*);
+    }
+    return bytes;
 }
 
 void Level::addPlayer(Player* player) noexcept
 {
+    // one gamepad per player, in the order they joined
+    player->getController().setGamepad(playerCount);
     players.push_back(player);
-    entityTree->insert(player);
     playerCount++;
 }
 
 
 void Level::addTile(Tile tile, int x, int y) noexcept {
 
-    this->tileData[x + y * this->width] = tile;
+    this->tileData[tileIndex(x, y)] = tile;
+    this->solidMask.set(x, y, tile.solid());
+    this->tileHash.markDirty(x);
+}
+
+void Level::resizeTiles(int width, int height) noexcept {
+
+    delete[] this->tileData;
+
+    this->width = width;
+    this->height = height;
+    this->tileData = new Tile[this->width * this->height];
+    this->solidMask.resize(this->width, this->height);
+    this->tileHash.resize(this->width, this->height);
+
+    // the sectors change, so the sleeping entities have to be found again
+    this->activation.resize(this->width);
+    this->entities.wakeAll();
+
+    // the entity tree covers the whole level
+    delete this->entityTree;
+    this->entityTree = new Quadtree<EntityRef>({ 0.0f,0.0f }, { (float)this->width, (float)this->height });
 }
 
 void Level::addTileEntity(TileEntity* tileEntity) noexcept {
@@ -84,96 +153,459 @@ void Level::onCursorEvent(GLFWwindow*, double, double) noexcept
 {
 }
 
-void Level::addEntity(Entity* entity) noexcept {
+EntityId Level::addEntity(EntityType type, glm::vec2 position) noexcept {
 
-    this->entityData.push_back(entity);
-    this->entityTree->insert(entity);
-    this->entityCount++;
+    const EntityId id = this->entities.spawn(type, position);
+    const EntityHandle handle = this->entities.resolve(id);
+    if (handle.valid()) {
+        kernels::spawn(this->entities.block(type), handle.index(), static_cast<uint32_t>(this->tick));
+    }
+    return id;
 }
 
+EntityHandle Level::findEntity(EntityId id) noexcept {
+
+    return this->entities.resolve(id);
+}
 
 
 
-void Level::draw(Renderer* renderer) noexcept {
 
-    renderer->clear();
+void Level::pollInput() noexcept {
 
-    // First draw the tiles, since they are the background, we buffer these first
-    for (int x = 0; x < this->width; x++) {
-        for (int y = 0; y < this->height; y++) {
-            Tile* tile = &this->tileData[x + y * this->width];
-            if (tile->mSprite != 0) {
-                renderer->buffer({ x, y }, tile->mSprite);
-            }
-        }
+    // every player reads its controller once per tick, whether that is a gamepad or a replay
+    for (int p = 0; p < playerCount; p++) {
+        players[p]->handleInput(players[p]->getController().poll());
     }
+}
 
+void Level::startInputRecording() noexcept {
 
-    entityTree->clear();
-    for (int i = 0; i < entityCount; i++) {
+    for (int p = 0; p < playerCount; p++) {
+        players[p]->getController().startRecording();
+    }
+}
 
-        entityTree->insert(entityData[i]);
+int Level::saveInputRecording(const std::string& intoFile) const noexcept {
+
+    std::vector<const Controller*> controllers;
+    for (int p = 0; p < playerCount; p++) {
+        controllers.push_back(&players[p]->getController());
     }
 
+    return input::saveRecording(intoFile, controllers.data(), static_cast<uint32_t>(controllers.size()));
+}
 
-    
-    
+int Level::loadInputReplay(const std::string& fromFile) noexcept {
 
-    // Draw every player in the level and handle input from gamepads
+    std::vector<Controller*> controllers;
     for (int p = 0; p < playerCount; p++) {
-        players[p]->draw(renderer);
-        players[p]->handleInput(this->parentWindow);
+        controllers.push_back(&players[p]->getController());
     }
 
+    return input::loadReplay(fromFile, controllers.data(), static_cast<uint32_t>(controllers.size()));
+}
 
-    // Draw every entity (including players) in the level and check for collisions -> update appropriately
-    for (int i = 0; i < entityCount + playerCount; i++) {
+void Level::update() noexcept {
 
-        Entity* e{ nullptr };
-        if (i < entityCount) {
-            e = getEntity(i);
-            if (!e->alive) { continue; }
-            e->draw(renderer);
+    PROFILE_SCOPE("Level::update");
+
+    // Run the update kernel of every entity type over its block, then integrate the whole block at once
+    if (play) {
+        PROFILE_SCOPE("entity update");
+        updateActivation();
+
+        // animations run off the tick, 32 bits of it is over two years at 60 Hz
+        const uint32_t now = static_cast<uint32_t>(tick);
+        entities.forEachBlock([this, now](EntityBlock& block) {
+            const motion::MotionParams params = kernels::motionParams(block.type);
+
+            // entities only touch their own state here, so the block is split across the job system
+            jobs::parallelFor(jobSystem, block.awake, ENTITY_GRAIN, [&block, &params, now](uint32_t begin, uint32_t end) {
+                PROFILE_SCOPE("entity update job");
+                kernels::update(block, begin, end, now);
+
+                if (params.tileCollision) {
+                    // the sweep moves them
+                    motion::integrateVelocity(block.velocity.data() + begin, end - begin, params);
+                }
+                else {
+                    motion::integrate(block.position.data() + begin, block.velocity.data() + begin, end - begin, params);
+                }
+            });
+        });
+    }
 
-            // check for entity collisions with the players
-            for (int p = 0u; p < playerCount; p++) {
-                e->resolvePlayerCollision(getPlayer(p));
-            }
+    // Contacts between the players and the tiles, applied after everything has moved
+    collision::TileContactBuffer tileContacts;
+
+    // Resolve entity collisions with the terrain's colliders
+    if (play) {
+        PROFILE_SCOPE("tile collision");
+        entities.forEachBlock([this](EntityBlock& block) {
+            if (!kernels::motionParams(block.type).tileCollision) { return; }
+
+            // the sweep only reads the tiles
+            jobs::parallelFor(jobSystem, block.awake, ENTITY_GRAIN, [this, &block](uint32_t begin, uint32_t end) {
+                PROFILE_SCOPE("tile collision job");
+                sweepEntities(block, begin, end);
+            });
+        });
+    }
+
+    // Players are always moved, so they can walk around the level in the editor
+    for (int p = 0; p < playerCount; p++) {
+        Player* player = players[p];
+        const uint8_t hits = collision::sweep(*this, player->position, player->velocity, player->dimensions, p, &tileContacts);
+        player->canJump = (hits & collision::HIT_GROUND) != 0;
+        collision::overlapCoins(*this, player->position, player->dimensions, p, &tileContacts);
+    }
 
+    // check for entity collisions with the players
+    entities.forEachBlock([this](EntityBlock& block) {
+        PROFILE_SCOPE("player collision");
+        kernels::resolvePlayerCollisions(entities, block.type, players.data(), playerCount, static_cast<uint32_t>(tick), particles);
+    });
 
-            if (play) {
-                e->update();
-            }
+    // Resolve entity collisions with other entities
+    resolveEntityCollisions();
+
+    resolveTileContacts(tileContacts);
+
+    // Remove the dead entities, so nothing iterates over them next tick
+    {
+        PROFILE_SCOPE("compact");
+        entities.compact();
+    }
+
+    if (play && particles != nullptr) {
+        PROFILE_SCOPE("particles");
+        particles->update(static_cast<uint32_t>(tick));
+    }
+
+    hashState();
+
+    PROFILE_COUNTER("entities alive", getEntityCount());
+    PROFILE_COUNTER("entities awake", getActiveEntityCount());
+    PROFILE_COUNTER("quadtree nodes", entityTree->count);
+
+    this->tick++;
+
+    if (play && snapshots != nullptr) {
+        PROFILE_SCOPE("snapshot capture");
+        snapshots->capture(*this);
+    }
+}
+
+void Level::saveState(SnapshotWriter& out) const {
+
+    out.write(tick);
+    out.write(stateHash);
+
+    out.write(playerCount);
+    for (int p = 0; p < playerCount; p++) {
+        Player* player = players[p];
+        out.write(player->position);
+        out.write(player->velocity);
+        out.write(player->dimensions);
+        out.write(player->alive);
+        out.write(player->canJump);
+        out.write(player->getCamera()->mPosition);
+    }
+
+    entities.save(out);
+    activation.save(out);
+}
+
+bool Level::loadState(SnapshotReader& in) {
+
+    // the header is checked before anything is written
+    uint64_t stateTick = 0u;
+    StateHash hash{};
+    int count = 0;
+    in.read(stateTick);
+    in.read(hash);
+    in.read(count);
+    if (!in.ok() || count != playerCount) { return false; }
+
+    tick = stateTick;
+    stateHash = hash;
+
+    for (int p = 0; p < playerCount; p++) {
+        Player* player = players[p];
+        in.read(player->position);
+        in.read(player->velocity);
+        in.read(player->dimensions);
+        in.read(player->alive);
+        in.read(player->canJump);
+        in.read(player->getCamera()->mPosition);
+    }
+
+    entities.load(in);
+    activation.load(in);
+
+    return in.ok();
+}
+
+void Level::hashState() noexcept {
+
+    PROFILE_SCOPE("state hash");
+
+    stateHash.tick = tick;
+    stateHash.tiles = tileHash.update(tileData);
+
+    uint64_t h = statehash::mix(static_cast<uint64_t>(playerCount));
+    for (int p = 0; p < playerCount; p++) {
+        const Player* player = players[p];
+        h = statehash::combine(h, statehash::bits(player->position));
+        h = statehash::combine(h, statehash::bits(player->velocity));
+        h = statehash::combine(h, statehash::bits(player->dimensions));
+        h = statehash::combine(h, (player->alive ? 1u : 0u) | (player->canJump ? 2u : 0u));
+    }
+    stateHash.players = h;
+
+    // the sleeping entities are already hashed, only the awake ones changed
+    for (size_t t = 0u; t < ENTITY_TYPE_COUNT; t++) {
+        const EntityBlock& block = entities.block(static_cast<EntityType>(t));
+
+        std::atomic<uint64_t> awakeHash{ 0u };
+        jobs::parallelFor(jobSystem, block.awake, ENTITY_GRAIN, [&block, &awakeHash](uint32_t begin, uint32_t end) {
+            awakeHash.fetch_xor(block.hashAwake(begin, end), std::memory_order_relaxed);
+        });
+
+        stateHash.blocks[t] = block.sleepingHash ^ awakeHash.load(std::memory_order_relaxed);
+    }
+
+    uint64_t total = statehash::combine(statehash::mix(stateHash.tick), stateHash.tiles);
+    total = statehash::combine(total, stateHash.players);
+    for (const uint64_t blockHash : stateHash.blocks) {
+        total = statehash::combine(total, blockHash);
+    }
+    stateHash.total = total;
+}
+
+void Level::buildRenderList(RenderList& list, float left, float right) const noexcept {
+
+    PROFILE_SCOPE("Level::buildRenderList");
+
+    list.clear();
+    list.tick = this->tick;
+
+    // First draw the tiles, since they are the background, we buffer these first
+    const int x0 = static_cast<int>(std::floor(left));
+    const int x1 = static_cast<int>(std::ceil(right));
+    // animated tiles all play their clip from tick 0, in step
+    const AnimationTable* animations = this->animations;
+    forEachTile(x0, 0, x1, this->height - 1, [&list, animations](int x, int y, const Tile& tile) {
+        if (tile.sprite() == 0) { return; }
+        const uint16_t clip = animations != nullptr ? animations->tileClip(tile.sprite()) : static_cast<uint16_t>(Clips::NONE);
+        if (clip != Clips::NONE) {
+            list.bufferClip({ x, y }, clip, 0u);
         }
         else {
-            // check collisions with world with the players
-            e = getPlayer(i - entityCount);
+            list.buffer({ x, y }, tile.sprite());
+        }
+    });
+
+    // Draw every player in the level
+    for (int p = 0; p < playerCount; p++) {
+        players[p]->draw(&list);
+    }
+
+    // Draw every entity in the level
+    for (size_t t = 0u; t < ENTITY_TYPE_COUNT; t++) {
+        const EntityBlock& block = entities.block(static_cast<EntityType>(t));
+        if (block.size() > 0u) {
+            kernels::draw(block, &list);
         }
+    }
+
+    // and the particles in front of everything
+    if (particles != nullptr) {
+        particles->draw(list);
+    }
+}
+
+void Level::sweepEntities(EntityBlock& block, uint32_t begin, uint32_t end) noexcept {
 
+    for (uint32_t i = begin; i < end; i++) {
+        if (!block.alive(i)) { continue; }
+
+        // Entities keep their horizontal speed when they run into a wall, their kernel decides what to do with it
+        const float vx = block.velocity[i].x;
+        const uint8_t hits = collision::sweep(*this, block.position[i], block.velocity[i], block.dimensions[i]);
+        if (hits & collision::HIT_WALL) {
+            block.velocity[i].x = vx;
+        }
+
+        block.flags[i] &= ~(ENTITY_CAN_JUMP | ENTITY_HIT_WALL);
+        block.flags[i] |= (hits & collision::HIT_GROUND) ? static_cast<uint8_t>(ENTITY_CAN_JUMP) : uint8_t{ 0u };
+        block.flags[i] |= (hits & collision::HIT_WALL) ? static_cast<uint8_t>(ENTITY_HIT_WALL) : uint8_t{ 0u };
+    }
+}
+
+void Level::updateActivation() noexcept {
+
+    activationWindows.clear();
+    for (int p = 0; p < playerCount; p++) {
+        // the camera's view, stretched to include the player in case the camera is somewhere else
+        const float cameraX = players[p]->getCamera()->mPosition.x;
+        const float playerX = players[p]->position.x;
+        activationWindows.push_back({
+            std::min(cameraX - VIEW_HALF_WIDTH, playerX) - ACTIVATION_MARGIN,
+            std::max(cameraX + VIEW_HALF_WIDTH, playerX) + ACTIVATION_MARGIN
+        });
+    }
+
+    activation.update(entities, activationWindows.data(), static_cast<uint32_t>(activationWindows.size()));
+}
+
+void Level::resolveEntityCollisions() noexcept {
+
+    PROFILE_SCOPE("entity collision");
+
+    // Rebuild the tree from the living, awake entities
+    {
+        PROFILE_SCOPE("quadtree rebuild");
+
+        entityRefs.clear();
+        entities.forEachBlock([this](EntityBlock& block) {
+            for (uint32_t i = 0u; i < block.awake; i++) {
+                if (block.alive(i)) {
+                    entityRefs.push_back({ block.position[i], &block, i });
+                }
+            }
+        });
+
+        // Sorted left to right, so each job of the narrow phase gets a strip of the level
+        std::sort(entityRefs.begin(), entityRefs.end(), [](const EntityRef& a, const EntityRef& b) {
+            if (a.position.x != b.position.x) { return a.position.x < b.position.x; }
+            if (a.block->type != b.block->type) { return a.block->type < b.block->type; }
+            return a.index < b.index;
+        });
+
+        entityTree->reserve(static_cast<uint32_t>(entityRefs.size()));
+        entityTree->clear();
+        for (EntityRef& ref : entityRefs) {
+            entityTree->insert(&ref);
+        }
+    }
+
+    // Narrow phase : every job finds the overlapping pairs of its strip, nothing is changed yet
+    const uint32_t refCount = static_cast<uint32_t>(entityRefs.size());
+    const uint32_t chunks = (refCount + COLLISION_GRAIN - 1u) / COLLISION_GRAIN;
+    if (pairBuffers.size() < chunks) {
+        const size_t first = pairBuffers.size();
+        pairBuffers.resize(chunks);
+        queryBuffers.resize(chunks);
+
+        // up front, instead of a few bytes at a time whenever a strip gets more crowded than it ever was
+        for (size_t c = first; c < chunks; c++) {
+            pairBuffers[c].reserve(COLLISION_GRAIN);
+            queryBuffers[c].reserve(QUERY_CAPACITY);
+        }
+    }
+    for (uint32_t c = 0u; c < chunks; c++) {
+        pairBuffers[c].clear();
+    }
+
+    jobs::parallelFor(jobSystem, refCount, COLLISION_GRAIN, [this](uint32_t begin, uint32_t end) {
+        PROFILE_SCOPE("narrow phase job");
+        std::vector<EntityPair>& pairs = pairBuffers[begin / COLLISION_GRAIN];
+        std::vector<EntityRef*>& nearby = queryBuffers[begin / COLLISION_GRAIN];
+
+        for (uint32_t a = begin; a < end; a++) {
+            const EntityRef& ref = entityRefs[a];
 
-        // Resolve entity collisions with other entities
-        if (i == 0) {
-            std::vector<Entity*> nearbyEntities;
             // Get the entities within the range of one block of the entity's hitbox
-            entityTree->query({ e->position - glm::vec2{1.0f, 1.0f}, e->position + glm::vec2{2.0f, 2.0f} }, &nearbyEntities);
-            //std::cout << "Nearby to 0: " << nearbyEntities.size() << std::endl;
-            for (Entity* e2 : nearbyEntities) {
-                e2->resolveEntityCollision(e);
+            nearby.clear();
+            entityTree->query({ ref.position - glm::vec2{1.0f, 1.0f}, ref.position + glm::vec2{2.0f, 2.0f} }, &nearby);
+
+            for (const EntityRef* other : nearby) {
+                // only find each pair once
+                const uint32_t b = static_cast<uint32_t>(other - entityRefs.data());
+                if (b <= a) { continue; }
+                if (ref.block->bounds(ref.index).overlapsQuad(other->block->bounds(other->index))) {
+                    pairs.push_back({ a, b });
+                }
             }
         }
+    });
 
-        // Resolve entity collisions with the terrain's colliders
+    // Commit phase : the responses are applied in a sorted order, so the outcome never depends on the number of threads
+    collisionPairs.clear();
+    for (uint32_t c = 0u; c < chunks; c++) {
+        collisionPairs.insert(collisionPairs.end(), pairBuffers[c].begin(), pairBuffers[c].end());
+    }
+    std::sort(collisionPairs.begin(), collisionPairs.end(), [](const EntityPair& l, const EntityPair& r) {
+        return l.a != r.a ? l.a < r.a : l.b < r.b;
+    });
+
+    for (const EntityPair& pair : collisionPairs) {
+        const EntityRef& a = entityRefs[pair.a];
+        const EntityRef& b = entityRefs[pair.b];
+
+        // one of them may have been killed by an earlier pair
+        if (!a.block->alive(a.index) || !b.block->alive(b.index)) { continue; }
+
+        const bool aShell = kernels::isSpinningShell(*a.block, a.index);
+        const bool bShell = kernels::isSpinningShell(*b.block, b.index);
+
+        // a spinning shell kills whatever it runs into
+        if (aShell != bShell) {
+            const EntityRef& victim = aShell ? b : a;
+            kernels::kill(*victim.block, victim.index, static_cast<uint32_t>(tick));
+            if (particles != nullptr) {
+                particles->burst(ParticleType::STOMP_PUFF, victim.block->position[victim.index], static_cast<uint32_t>(tick));
+            }
+        }
+        // otherwise the two entities turn around
+        else {
+            a.block->velocity[a.index].x *= -1.0f;
+            b.block->velocity[b.index].x *= -1.0f;
+        }
     }
 }
 
-void Level::update() noexcept {
+void Level::resolveTileContacts(const collision::TileContactBuffer& contacts) noexcept {
+
+    for (uint32_t i = 0u; i < contacts.count; i++) {
+        const collision::TileContact& contact = contacts.contacts[i];
+
+        if (contact.type == TC_Type::COIN) {
+            // collect it
+            addTile(Tile(), contact.x, contact.y);
+            continue;
+        }
+
+        // The rest of the interactions only happen when a player hits a tile with their head
+        if (contact.side != collision::TileSide::TOP) { continue; }
+
+        switch (contact.type) {
+        case TC_Type::STRENGTH_1:
+            // bricks break
+            addTile(Tile(), contact.x, contact.y);
+            if (particles != nullptr) {
+                particles->burst(ParticleType::BRICK_DEBRIS, glm::vec2(contact.x, contact.y), static_cast<uint32_t>(tick));
+            }
+            break;
+        case TC_Type::STRENGTH_2:
+            // question blocks and stones can only be hit once, then they are indestructible
+            addTile(Tile(TC_Type::STRENGTH_3, getTile(contact.x, contact.y).sprite()), contact.x, contact.y);
+            if (particles != nullptr) {
+                particles->burst(ParticleType::COIN_POP, glm::vec2(contact.x, contact.y), static_cast<uint32_t>(tick));
+            }
+            break;
+        default:
+            // STRENGTH_3 and pipes do not react
+            break;
+        }
+    }
 }
 
 void Level::reset() noexcept
 {
-    this->width = MIN_LEVEL_WIDTH;
-    this->height = MIN_LEVEL_HEIGHT;
+    this->resizeTiles(MIN_LEVEL_WIDTH, MIN_LEVEL_HEIGHT);
 
-    this->entityCount = 0;
-    this->entityData.clear();
+    this->entities.clear();
 }
@@ -2,20 +2,49 @@
 #define SCENE_H_
 
 #include <vector>
+#include <string>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
-#include "../../graphics/renderer.h"
+#include "../../graphics/render_list.h"
 #include "../../core/camera.h"
 #include "../json.h"
 #include "../../graphics/animator.h"
 #include "tile/tile.h"
+#include "tile/solid_mask.h"
 #include "tile_entity/tile_entity.h"
 #include "entity/entity.h"
+#include "entity/entity_store.h"
 #include "entity/player.h"
 #include "collider/collider.h"
 #include "quadtree.h"
+#include "activation.h"
+#include "state_hash.h"
+#include "snapshot.h"
+#include "snapshot_stream.h"
+#include "../jobs/job_system.h"
+
+namespace collision {
+    struct TileContactBuffer;
+}
+
+/**
+* What goes into the entity quadtree, a copy of the position and where the entity lives in the store
+*/
+struct EntityRef {
+    glm::vec2 position;
+    EntityBlock* block;
+    uint32_t index;
+};
+
+/**
+* Two overlapping entities, as indices into the level's sorted EntityRefs
+*/
+struct EntityPair {
+    uint32_t a;
+    uint32_t b;
+};
 
 class Level
 {
@@ -23,12 +52,72 @@ public:
     explicit Level();
     ~Level() noexcept;
 
-    Entity* getEntity(uint32_t idx) const noexcept;
+    EntityHandle getEntity(uint32_t idx) noexcept;
+    uint32_t getEntityCount() const noexcept;
+    uint32_t getActiveEntityCount() const noexcept;
+    uint32_t getSleepingEntityCount() const noexcept;
+
+    /**
+    * @return The bytes the level holds on the heap : tiles, entities, the trees and the per tick buffers, used or not
+    */
+    size_t getMemoryUsage() const noexcept;
     Player* getPlayer(uint32_t idx) const noexcept;
     
     void addPlayer(Player* player) noexcept;
     void addTile(Tile tile, int x, int y) noexcept;
-    void addEntity(Entity* entity) noexcept;
+    
+    /**
+    * @brief Reallocates the tile data (and the solid mask) for a new size, every tile is cleared
+    */
+    void resizeTiles(int width, int height) noexcept;
+
+    /**
+    * @brief Tiles are stored column major (x * height + y) since levels are much wider than they are tall,
+    * and every scan over the tiles walks a column at a time
+    */
+    inline int tileIndex(int x, int y) const noexcept {
+        return x * this->height + y;
+    }
+
+    inline const Tile& getTile(int x, int y) const noexcept {
+        return this->tileData[tileIndex(x, y)];
+    }
+
+    /**
+    * @return A pointer to the contiguous column of `height` tiles at x
+    */
+    inline const Tile* getTileColumn(int x) const noexcept {
+        return &this->tileData[tileIndex(x, 0)];
+    }
+
+    /**
+    * @brief Calls f(x, y, tile) for every tile in the (inclusive) window, in memory order; the window is clipped to the level
+    */
+    template<typename F>
+    void forEachTile(int x0, int y0, int x1, int y1, F&& f) const noexcept {
+        x0 = x0 < 0 ? 0 : x0;
+        y0 = y0 < 0 ? 0 : y0;
+        x1 = x1 >= this->width ? this->width - 1 : x1;
+        y1 = y1 >= this->height ? this->height - 1 : y1;
+
+        for (int x = x0; x <= x1; x++) {
+            const Tile* column = getTileColumn(x);
+            for (int y = y0; y <= y1; y++) {
+                f(x, y, column[y]);
+            }
+        }
+    }
+
+    /**
+    * @brief Spawns an entity, its type's kernel sets up its velocity, size...
+    * @return The entity's id, null if the type's pool is full
+    */
+    EntityId addEntity(EntityType type, glm::vec2 position) noexcept;
+
+    /**
+    * @return A handle to the entity, invalid once the entity has been removed
+    */
+    EntityHandle findEntity(EntityId id) noexcept;
     void addTileEntity(TileEntity* entity) noexcept;
 
     void onMouseEvent(GLFWwindow*, int, int, int) noexcept;
@@ -36,19 +125,61 @@ public:
     void onScrollEvent(GLFWwindow*, double, double) noexcept;
     void onCursorEvent(GLFWwindow*, double, double) noexcept;
 
-    LineRenderer lineRenderer;
+    /**
+    * @brief Polls every player's controller for the next tick; GLFW only allows reading gamepads on the main
+    * thread, so it is kept out of update
+    */
+    void pollInput() noexcept;
 
     /**
-    * @brief Draw all tiles and entities
-    * @param Renderer - Pointer to the current rendering engine
+    * @brief Records every player's input from the next poll on
     */
-    void draw(Renderer*) noexcept;
-    
+    void startInputRecording() noexcept;
+
+    /**
+    * @brief Saves what the players' controllers recorded into an input file
+    * @return 0 on success, -1 on failure
+    */
+    int saveInputRecording(const std::string& intoFile) const noexcept;
+
+    /**
+    * @brief Replays an input file on the players' controllers, from the next poll on. Replaying a recording from
+    * the same level state gives a bit identical simulation
+    * @return The number of ticks in the file, -1 if it could not be read
+    */
+    int loadInputReplay(const std::string& fromFile) noexcept;
+
     /**
-    * @brief Draws, updates, and animates all objects in this Scene; pretty cool :)
+    * @brief Simulates one tick : moves, collides and animates everything. Touches nothing but the level, so it can
+    * run on a worker thread while the last tick is being rendered
     */
     void update() noexcept;
 
+    /**
+    * @brief Writes everything the simulation changes, except the tiles : the tick, players, entities and who sleeps
+    * where. SnapshotRing keeps the tiles itself
+    */
+    void saveState(SnapshotWriter& out) const;
+
+    /**
+    * @brief Reads back what saveState wrote, into a level of the same size with the same players
+    * @return false if the state does not fit this level, which is checked before anything is written. A state cut
+    * short also returns false, after loading what it had : SnapshotRing only hands whole states to it
+    */
+    bool loadState(SnapshotReader& in);
+
+    /**
+    * @return The hash of the level's state after the last simulated tick
+    */
+    inline const StateHash& getStateHash() const noexcept {
+        return stateHash;
+    }
+
+    /**
+    * @brief Fills the list with every sprite the level draws between the columns left and right
+    */
+    void buildRenderList(RenderList& list, float left, float right) const noexcept;
+
     /**
     * Permanently resets / clears the data in the scene
     */
@@ -56,26 +187,83 @@ public:
 
     bool play;
 
+    // The number of ticks simulated
+    uint64_t tick{ 0u };
+
+    // Runs the entity passes across threads, everything runs on the calling thread when null; not owned
+    jobs::JobSystem* jobSystem{ nullptr };
+
+    // Captures every simulated tick for rewinding when set; not owned
+    SnapshotRing* snapshots{ nullptr };
+
+    // Which tiles are animated (usually the atlas's clips), tiles are drawn still when null; not owned
+    const AnimationTable* animations{ nullptr };
+
+    // Where the level emits its particles and draws them from, none are emitted when null; not owned
+    ParticleSystem* particles{ nullptr };
+
     GLFWwindow* parentWindow;
 
-    // Tile data is stored in a large head array
+    // Tile data is stored in a large heap array, column major; use getTile / tileIndex to access it
     int width;
     int height;
     Tile* tileData;
+    // Which tiles are solid, 1 bit per tile; kept in sync by addTile
+    SolidMask solidMask;
+    // The hash of the tiles per chunk, addTile marks the chunks that need a rehash
+    TileHashGrid tileHash;
 
     // tile entities (things with functions or animations)
     int tileEntityCount;
     std::vector<TileEntity*> tileEntityData;
     Quadtree<TileEntity>* tileEntityTree;
 
-    // entities
-    int entityCount;
-    std::vector<Entity*> entityData;
-    Quadtree<Entity>* entityTree;
+    // entities, stored by type with one array per component
+    EntityStore entities;
+    Quadtree<EntityRef>* entityTree;
+    // Only entities near a player are simulated
+    ActivationGrid activation;
 
     // Players
     int playerCount;
     std::vector <Player*> players;
+
+private:
+
+    /**
+    * @brief Applies what the players hit this frame to the tiles (breaking bricks, collecting coins...)
+    */
+    void resolveTileContacts(const collision::TileContactBuffer& contacts) noexcept;
+
+    /**
+    * @brief Moves the living entities in [begin, end) of the block through the tiles, and records if they landed or hit a wall
+    */
+    void sweepEntities(EntityBlock& block, uint32_t begin, uint32_t end) noexcept;
+
+    /**
+    * @brief Rebuilds the entity tree and resolves the collisions between overlapping entities
+    */
+    void resolveEntityCollisions() noexcept;
+
+    /**
+    * @brief Updates stateHash at the end of a tick, only rehashing what may have changed
+    */
+    void hashState() noexcept;
+
+    /**
+    * @brief Wakes the entities around each player's camera, and puts the far away ones to sleep
+    */
+    void updateActivation() noexcept;
+
+    std::vector<ActivationWindow> activationWindows;
+
+    StateHash stateHash;
+
+    // Scratch buffers for resolveEntityCollisions, kept around so a frame does not allocate; one pair and query buffer per job
+    std::vector<EntityRef> entityRefs;
+    std::vector<std::vector<EntityPair>> pairBuffers;
+    std::vector<std::vector<EntityRef*>> queryBuffers;
+    std::vector<EntityPair> collisionPairs;
 };
 
 #endif // SCENE_H_
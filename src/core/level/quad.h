@@ -53,6 +53,15 @@ struct Quad {
 			((point.x < this->topRight.x) && (point.y < topRight.y));
 	}
 
+	// Like intersectsQuad, but quads that only share an edge do not count
+	inline bool overlapsQuad(const Quad& other) const noexcept {
+
+		return other.getBottomLeft().x < this->getTopRight().x &&
+			other.getTopRight().x > this->getBottomLeft().x &&
+			other.getBottomLeft().y < this->getTopRight().y &&
+			other.getTopRight().y > this->getBottomLeft().y;
+	}
+
 	inline bool intersectsQuad(const Quad& other) const noexcept {
 
 		return !(other.getBottomLeft().x > this->getTopRight().x ||
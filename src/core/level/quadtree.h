@@ -12,10 +12,26 @@ public:
 		this->topRight = topRight;
 		// This is a heap allocated array; what should the max number be??
 		this->count = 0;
-		this->buffer = new detail::QuadtreeImpl<T>[1000];
+		this->capacity = 1000u;
+		this->buffer = new detail::QuadtreeImpl<T>[this->capacity];
 		this->base = create(bottomLeft, topRight);
 	}
 
+	/**
+	* @brief Makes sure the node buffer can hold a tree of this many items. Every insertion subdivides at most one node,
+	* so 4 nodes per item (+ the root) can never overflow. Only reallocates when growing
+	* @note - Invalidates the tree, clear and re-insert everything after calling this
+	*/
+	void reserve(uint32_t items) noexcept {
+		const uint32_t needed = 4u * items + 1u;
+		if (needed > this->capacity) {
+			delete[] this->buffer;
+			this->capacity = needed;
+			this->buffer = new detail::QuadtreeImpl<T>[this->capacity];
+			this->clear();
+		}
+	}
+
 	~Quadtree() noexcept {
 		delete[] buffer;
 	}
@@ -35,7 +51,7 @@ public:
 	* Query for items with the bounds of the quad q
 	* @param results - Vector pointer to be filled with pointers to the matching items
 	*/
-	inline void query(Quad boundary, std::vector<T*>* results) noexcept {
+	inline void query(Quad boundary, std::vector<T*>* results) const noexcept {
 		this->base->query(boundary, results);
 	}
 
@@ -44,13 +60,19 @@ public:
 		this->base = create(this->bottomLeft, this->topRight);
 	}
 
-	// Return pointer to a "new" quadtree
-	detail::QuadtreeImpl<T>* create(glm::vec2 bottomLeft, glm::vec2 topRight) noexcept {
-		this->buffer[count] = detail::QuadtreeImpl<T>(bottomLeft, topRight); // create in place
+	// Return pointer to a "new" quadtree, or nullptr if the buffer is full
+	detail::QuadtreeImpl<T>* create(glm::vec2 bottomLeft, glm::vec2 topRight, uint32_t depth = 0u) noexcept {
+		if (count >= capacity) { return nullptr; }
+		this->buffer[count] = detail::QuadtreeImpl<T>(bottomLeft, topRight, depth); // create in place
 		return &this->buffer[count++]; // return the pointer to the newly created quad tree
 	}
 
+	inline size_t memoryUsage() const noexcept {
+		return this->capacity * sizeof(detail::QuadtreeImpl<T>);
+	}
+
 	uint32_t count;
+	uint32_t capacity;
 private:
 
 	// Must be placed in the buffer on construction
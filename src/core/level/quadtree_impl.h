@@ -23,10 +23,11 @@ namespace detail {
 		* @param center - The center of the quad tree, usually half the width and half the height of the level
 		* @param dimensions - The dimensions to the edges from the center of the quad tree, usually half the width and half the height of the level
 		*/
-		QuadtreeImpl(glm::vec2 bottomLeft, glm::vec2 topRight)
+		QuadtreeImpl(glm::vec2 bottomLeft, glm::vec2 topRight, uint32_t depth = 0u)
 		{
 			this->divided = false;
 			this->count = 0u;
+			this->depth = depth;
 			this->bounds = Quad(bottomLeft, topRight);
 			this->childTopLeft = nullptr;
 			this->childTopRight = nullptr;
@@ -55,12 +56,18 @@ namespace detail {
 			}
 		}
 
-		void subDivide(Quadtree<T>* buffer) noexcept {
+		/**
+		* @return false if the tree is out of nodes
+		*/
+		bool subDivide(Quadtree<T>* buffer) noexcept {
+			if (buffer->count + 4u > buffer->capacity) { return false; }
+
 			glm::vec2 center{bounds.getCenter()};
-			childTopLeft = buffer->create(glm::vec2{ bounds.bottomLeft.x, center.y }, glm::vec2{ center.x, bounds.topRight.y });
-			childTopRight = buffer->create(center, bounds.getTopRight());
-			childBottomLeft = buffer->create(bounds.getBottomLeft(), center);
-			childBottomRight = buffer->create(glm::vec2{ center.x, bounds.bottomLeft.y }, glm::vec2{ bounds.topRight.x, center.y });
+			childTopLeft = buffer->create(glm::vec2{ bounds.bottomLeft.x, center.y }, glm::vec2{ center.x, bounds.topRight.y }, depth + 1u);
+			childTopRight = buffer->create(center, bounds.getTopRight(), depth + 1u);
+			childBottomLeft = buffer->create(bounds.getBottomLeft(), center, depth + 1u);
+			childBottomRight = buffer->create(glm::vec2{ center.x, bounds.bottomLeft.y }, glm::vec2{ bounds.topRight.x, center.y }, depth + 1u);
+			return true;
 		}
 
 		/**
@@ -80,9 +87,12 @@ namespace detail {
 			}
 			// count is greater than 4, at max capacity
 			else {
+				// Many items stacked on the same point would keep dividing forever, drop them past the max depth
+				if (!divided && depth >= MAX_DEPTH) { return; }
+
 				// If we have not divided, we must or the children trees will be null
 				if (!divided) {
-					this->subDivide(buffer);
+					if (!this->subDivide(buffer)) { return; }
 					divided = true;
 				}
 				childTopLeft->insert(t, buffer);
@@ -119,10 +129,13 @@ namespace detail {
 		}
 
 	private:
+		static constexpr uint32_t MAX_DEPTH = 16u;
+
 		Quad bounds;
 
 		// See if we can get this into 4 bytes
 		uint32_t count;
+		uint32_t depth;
 		std::array<T*, 4> items;
 
 		// Children quadtree pointers, stored in a buffer somewhere
@@ -0,0 +1,276 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "level.h"
+
+namespace {
+
+    inline uint64_t wordAt(const std::vector<uint8_t>& bytes, size_t i) noexcept {
+        if ((i + 1u) * sizeof(uint64_t) > bytes.size()) { return 0u; }
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+        return word;
+    }
+
+    /**
+    * The xor of two states, one 64 bit word at a time : the number of words, then runs of a header word
+    * (unchanged words in the high half, changed words in the low half) followed by the changed words
+    */
+    void encodeDelta(const std::vector<uint8_t>& from, const std::vector<uint8_t>& to, std::vector<uint64_t>& out) {
+
+        const size_t words = std::max(from.size(), to.size()) / sizeof(uint64_t);
+
+        out.clear();
+        out.push_back(words);
+
+        size_t i = 0u;
+        while (i < words) {
+            const size_t runStart = i;
+            while (i < words && wordAt(from, i) == wordAt(to, i)) { i++; }
+            const size_t same = i - runStart;
+
+            const size_t header = out.size();
+            out.push_back(0u);
+
+            const size_t changedStart = i;
+            while (i < words && wordAt(from, i) != wordAt(to, i)) {
+                out.push_back(wordAt(from, i) ^ wordAt(to, i));
+                i++;
+            }
+
+            out[header] = (static_cast<uint64_t>(same) << 32) | (i - changedStart);
+        }
+    }
+
+    /**
+    * @brief Applies a delta to a state, turning one end of the delta into the other
+    */
+    void applyDelta(const std::vector<uint64_t>& delta, std::vector<uint8_t>& state) {
+
+        if (delta.empty()) { return; }
+
+        const size_t words = static_cast<size_t>(delta[0]);
+        state.resize(std::max(state.size(), words * sizeof(uint64_t)), 0u);
+
+        size_t at = 0u;
+        for (size_t d = 1u; d < delta.size();) {
+            const uint64_t header = delta[d++];
+            at += static_cast<size_t>(header >> 32);
+
+            const size_t changed = static_cast<size_t>(header & 0xFFFFFFFFu);
+            for (size_t c = 0u; c < changed; c++, at++) {
+                uint64_t word;
+                std::memcpy(&word, state.data() + at * sizeof(uint64_t), sizeof(uint64_t));
+                word ^= delta[d++];
+                std::memcpy(state.data() + at * sizeof(uint64_t), &word, sizeof(uint64_t));
+            }
+        }
+    }
+
+    // pads to whole words, the deltas work on words
+    inline void pad(std::vector<uint8_t>& state) {
+        state.resize((state.size() + sizeof(uint64_t) - 1u) / sizeof(uint64_t) * sizeof(uint64_t), 0u);
+    }
+}
+
+SnapshotRing::SnapshotRing(uint32_t capacity) : mFrames(std::max(capacity, 1u)),
+    // enough that a keyframe outlives the frames it is for
+    mKeyframes(std::max(capacity, 1u) / KEYFRAME_INTERVAL + 2u) {
+}
+
+void SnapshotRing::clear() noexcept {
+
+    mCount = 0u;
+    mNewest = 0u;
+    mState.clear();
+    for (Keyframe& keyframe : mKeyframes) {
+        keyframe.state.clear();
+    }
+}
+
+void SnapshotRing::resetTiles(const Level& level) {
+
+    mWidth = level.width;
+    mHeight = level.height;
+    mTileLayout = level.tileHash.layout();
+    mTiles.assign(level.tileData, level.tileData + static_cast<size_t>(mWidth) * mHeight);
+
+    mChunkVersions.resize(level.tileHash.chunkCount());
+    for (uint32_t c = 0u; c < level.tileHash.chunkCount(); c++) {
+        mChunkVersions[c] = level.tileHash.chunkVersion(c);
+    }
+}
+
+void SnapshotRing::capture(const Level& level) {
+
+    // a resized level, or a gap in the ticks, starts a new history
+    const bool resized = level.width != mWidth || level.height != mHeight || level.tileHash.layout() != mTileLayout;
+    if (mCount > 0u && (resized || level.tick != newestTick() + 1u)) {
+        clear();
+    }
+
+    SnapshotWriter out(mScratch);
+    level.saveState(out);
+    pad(mScratch);
+
+    const uint32_t slot = mCount == 0u ? 0u : (mNewest + 1u) % capacity();
+    Frame& frame = mFrames[slot];
+    frame.tick = level.tick;
+    frame.stateSize = static_cast<uint32_t>(mScratch.size());
+    frame.tiles.clear();
+
+    if (mCount == 0u) {
+        // the first frame is never walked back over, it needs no delta
+        frame.delta.clear();
+        resetTiles(level);
+    }
+    else {
+        encodeDelta(mState, mScratch, frame.delta);
+
+        // the chunks that changed since the last frame, xor'd with what they were
+        const int chunkWidth = TileHashGrid::CHUNK_WIDTH;
+        for (uint32_t c = 0u; c < level.tileHash.chunkCount(); c++) {
+            if (level.tileHash.chunkVersion(c) == mChunkVersions[c]) { continue; }
+            mChunkVersions[c] = level.tileHash.chunkVersion(c);
+
+            frame.tiles.push_back(static_cast<uint16_t>(c));
+            const size_t first = static_cast<size_t>(c) * chunkWidth * mHeight;
+            const size_t last = std::min(first + static_cast<size_t>(chunkWidth) * mHeight, mTiles.size());
+            for (size_t k = first; k < last; k++) {
+                frame.tiles.push_back(mTiles[k].mData ^ level.tileData[k].mData);
+                mTiles[k] = level.tileData[k];
+            }
+        }
+    }
+
+    // the first frame is a keyframe too, anything that wraps around to it starts over from there
+    if (mCount == 0u || frame.tick % KEYFRAME_INTERVAL == 0u) {
+        Keyframe& keyframe = keyframeOf(frame.tick);
+        keyframe.tick = frame.tick;
+        keyframe.state.assign(mScratch.begin(), mScratch.end());
+    }
+
+    std::swap(mState, mScratch);
+    mNewest = slot;
+    mCount = std::min(mCount + 1u, capacity());
+}
+
+bool SnapshotRing::restore(Level& level, uint64_t tick) {
+
+    if (!contains(tick)) { return false; }
+    if (level.width != mWidth || level.height != mHeight || level.tileHash.layout() != mTileLayout) { return false; }
+
+    // start from the closest full state : the newest, or a keyframe on either side of the tick
+    uint64_t from = newestTick();
+    for (uint64_t t = tick; t + KEYFRAME_INTERVAL > tick && t >= oldestTick(); t--) {
+        if (findKeyframe(t) != nullptr) {
+            from = tick - t < from - tick ? t : from;
+            break;
+        }
+    }
+    for (uint64_t t = tick + 1u; t < tick + KEYFRAME_INTERVAL && t < newestTick(); t++) {
+        if (findKeyframe(t) != nullptr) {
+            from = t - tick < (from > tick ? from - tick : tick - from) ? t : from;
+            break;
+        }
+    }
+
+    // nothing is written before the whole walk is known to be there : every frame on it still in the ring,
+    // and every tile record within the level
+    if (from != newestTick() && findKeyframe(from) == nullptr) { return false; }
+    for (uint64_t t = std::min(from, tick); t <= newestTick(); t++) {
+        const Frame& frame = mFrames[slotOf(t)];
+        if (frame.tick != t) { return false; }
+        if (t > std::min(from, tick) && t <= std::max(from, tick) && frame.delta.empty()) { return false; }
+        if (t <= tick) { continue; }
+
+        const size_t chunkTiles = static_cast<size_t>(TileHashGrid::CHUNK_WIDTH) * mHeight;
+        for (size_t i = 0u; i < frame.tiles.size();) {
+            const uint32_t c = frame.tiles[i++];
+            if (c >= mChunkVersions.size()) { return false; }
+            const size_t first = static_cast<size_t>(c) * chunkTiles;
+            i += std::min(first + chunkTiles, mTiles.size()) - first;
+            if (i > frame.tiles.size()) { return false; }
+        }
+    }
+
+    if (from == newestTick()) {
+        mScratch = mState;
+    }
+    else {
+        mScratch = findKeyframe(from)->state;
+    }
+
+    // then apply the deltas on the way, forwards or backwards
+    for (uint64_t t = from + 1u; t <= tick; t++) {
+        applyDelta(mFrames[slotOf(t)].delta, mScratch);
+        mScratch.resize(mFrames[slotOf(t)].stateSize);
+    }
+    for (uint64_t t = from; t > tick; t--) {
+        applyDelta(mFrames[slotOf(t)].delta, mScratch);
+        mScratch.resize(mFrames[slotOf(t - 1u)].stateSize);
+    }
+
+    // loadState checks the state fits the level before it writes anything
+    SnapshotReader in(mScratch.data(), mScratch.size());
+    if (!level.loadState(in)) { return false; }
+
+    // the tiles are small enough to always walk back from the newest frame
+    mTouched.assign(mChunkVersions.size(), 0u);
+    const int chunkWidth = TileHashGrid::CHUNK_WIDTH;
+    for (uint64_t t = newestTick(); t > tick; t--) {
+        const Frame& frame = mFrames[slotOf(t)];
+
+        for (size_t i = 0u; i < frame.tiles.size();) {
+            const uint32_t c = frame.tiles[i++];
+            mTouched[c] = 1u;
+
+            const size_t first = static_cast<size_t>(c) * chunkWidth * mHeight;
+            const size_t last = std::min(first + static_cast<size_t>(chunkWidth) * mHeight, mTiles.size());
+            for (size_t k = first; k < last; k++) {
+                mTiles[k].mData ^= frame.tiles[i++];
+            }
+        }
+    }
+
+    // the tiles that changed on the way, or since the newest frame (the editor)
+    for (uint32_t c = 0u; c < mChunkVersions.size(); c++) {
+        if (!mTouched[c] && level.tileHash.chunkVersion(c) == mChunkVersions[c]) { continue; }
+
+        const int first = static_cast<int>(c) * chunkWidth;
+        const int last = std::min(first + chunkWidth, mWidth);
+        for (int x = first; x < last; x++) {
+            for (int y = 0; y < mHeight; y++) {
+                level.addTile(mTiles[static_cast<size_t>(x) * mHeight + y], x, y);
+            }
+        }
+        mChunkVersions[c] = level.tileHash.chunkVersion(c);
+    }
+
+    std::swap(mState, mScratch);
+    mCount -= static_cast<uint32_t>(newestTick() - tick);
+    mNewest = slotOf(tick);
+
+    return true;
+}
+
+size_t SnapshotRing::getNewestFrameBytes() const noexcept {
+
+    if (mCount == 0u) { return 0u; }
+    const Frame& frame = mFrames[mNewest];
+    return frame.delta.size() * sizeof(uint64_t) + frame.tiles.size() * sizeof(uint16_t);
+}
+
+size_t SnapshotRing::getMemoryUsed() const noexcept {
+
+    size_t bytes = mState.capacity() + mScratch.capacity() + mTiles.capacity() * sizeof(Tile);
+    for (const Frame& frame : mFrames) {
+        bytes += frame.delta.capacity() * sizeof(uint64_t) + frame.tiles.capacity() * sizeof(uint16_t);
+    }
+    for (const Keyframe& keyframe : mKeyframes) {
+        bytes += keyframe.state.capacity();
+    }
+    return bytes;
+}
@@ -0,0 +1,138 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "tile/tile.h"
+
+class Level;
+
+/**
+* The last few ticks of a level, for rewinding and rolling back.
+*
+* capture is called after a tick and stores the whole simulation state (entities, players, activation, tiles) as a
+* frame in a ring of preallocated frames, overwriting the oldest. Frames are deltas: a frame holds the xor of its
+* state with the state of the frame before it, with the runs of unchanged bytes left out, so a tick where only the
+* awake entities moved costs about as much as the awake entities. Tiles are only stored for the chunks that changed
+* since the frame before.
+*
+* Xor works both ways, so a delta can be undone as well as applied. The ring keeps the full state of the newest frame,
+* and every KEYFRAME_INTERVAL ticks a frame also keeps its full state; restoring a tick starts from the closest full
+* state and walks to the tick one delta at a time (so at most KEYFRAME_INTERVAL / 2 deltas when every entity moves),
+* then drops every frame after the restored one so the simulation can carry on from there. Walking only needs the
+* frames in between, so the oldest frame can be overwritten without touching the rest
+*/
+class SnapshotRing final {
+public:
+
+	static constexpr uint32_t KEYFRAME_INTERVAL = 8u;
+
+	/**
+	* @param capacity - The number of ticks kept
+	*/
+	explicit SnapshotRing(uint32_t capacity = 600u);
+
+	/**
+	* @brief Captures the state of the level after its last tick, as the frame of Level::tick
+	*/
+	void capture(const Level& level);
+
+	/**
+	* @brief Puts the level back in the state it was in at the tick, and forgets every frame after it
+	* @return false if the tick is not in the ring, a frame on the way to it is missing, or the level no longer fits
+	* the frames (resized, other players); the whole walk is checked first, so the level is left untouched then
+	*/
+	bool restore(Level& level, uint64_t tick);
+
+	/**
+	* @brief Forgets every frame, the memory is kept
+	*/
+	void clear() noexcept;
+
+	inline uint32_t size() const noexcept {
+		return mCount;
+	}
+
+	inline uint32_t capacity() const noexcept {
+		return static_cast<uint32_t>(mFrames.size());
+	}
+
+	inline bool contains(uint64_t tick) const noexcept {
+		return mCount > 0u && tick >= oldestTick() && tick <= newestTick();
+	}
+
+	inline uint64_t newestTick() const noexcept {
+		return mFrames[mNewest].tick;
+	}
+
+	inline uint64_t oldestTick() const noexcept {
+		return newestTick() + 1u - mCount;
+	}
+
+	/**
+	* @return The size of the delta of the newest frame in bytes, tiles included
+	*/
+	size_t getNewestFrameBytes() const noexcept;
+
+	/**
+	* @return The bytes used by every frame and the full state, allocated or not
+	*/
+	size_t getMemoryUsed() const noexcept;
+
+private:
+
+	struct Frame {
+		uint64_t tick;
+		// the size of the full state at this tick
+		uint32_t stateSize;
+		// the xor with the state of the frame before, run length encoded (see encodeDelta)
+		std::vector<uint64_t> delta;
+		// for every chunk that changed since the frame before : the chunk index, then the xor of its tiles
+		std::vector<uint16_t> tiles;
+	};
+
+	// a full state, kept in a pool of its own so only capacity / KEYFRAME_INTERVAL frames hold one
+	struct Keyframe {
+		uint64_t tick;
+		std::vector<uint8_t> state;
+	};
+
+	inline Keyframe& keyframeOf(uint64_t tick) noexcept {
+		return mKeyframes[(tick / KEYFRAME_INTERVAL) % mKeyframes.size()];
+	}
+
+	// the keyframe of the tick, or null if it has none
+	inline const Keyframe* findKeyframe(uint64_t tick) const noexcept {
+		const Keyframe& keyframe = mKeyframes[(tick / KEYFRAME_INTERVAL) % mKeyframes.size()];
+		return keyframe.tick == tick && !keyframe.state.empty() ? &keyframe : nullptr;
+	}
+
+	inline uint32_t slotOf(uint64_t tick) const noexcept {
+		const uint32_t back = static_cast<uint32_t>(newestTick() - tick);
+		return (mNewest + capacity() - back) % capacity();
+	}
+
+	// starts over from the level's current tiles
+	void resetTiles(const Level& level);
+
+	std::vector<Frame> mFrames;
+	std::vector<Keyframe> mKeyframes;
+	uint32_t mNewest{ 0u };
+	uint32_t mCount{ 0u };
+
+	// the full state of the newest frame, and the state being captured / restored
+	std::vector<uint8_t> mState;
+	std::vector<uint8_t> mScratch;
+
+	// the tiles at the newest frame, and the chunk versions they were copied at
+	std::vector<Tile> mTiles;
+	std::vector<uint32_t> mChunkVersions;
+	uint32_t mTileLayout{ 0u };
+	int mWidth{ 0 };
+	int mHeight{ 0 };
+	// which chunks a restore has to write back into the level
+	std::vector<uint8_t> mTouched;
+};
+
+#endif // !SNAPSHOT_H_
@@ -0,0 +1,85 @@
+#ifndef SNAPSHOT_STREAM_H_
+#define SNAPSHOT_STREAM_H_
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+* Appends plain values and arrays to a byte buffer, for snapshots of the simulation. The buffer is cleared but
+* keeps its memory, so writing a snapshot of the same size as the last one does not allocate
+*/
+class SnapshotWriter final {
+public:
+
+	explicit SnapshotWriter(std::vector<uint8_t>& buffer) noexcept : mBuffer(buffer) {
+		mBuffer.clear();
+	}
+
+	template<typename T>
+	void write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written to a snapshot");
+		const size_t at = mBuffer.size();
+		mBuffer.resize(at + sizeof(T));
+		std::memcpy(mBuffer.data() + at, &value, sizeof(T));
+	}
+
+	/**
+	* @brief Writes the size of the array, then its elements
+	*/
+	template<typename T>
+	void writeArray(const std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written to a snapshot");
+		write(static_cast<uint32_t>(values.size()));
+		const size_t at = mBuffer.size();
+		mBuffer.resize(at + values.size() * sizeof(T));
+		if (!values.empty()) {
+			std::memcpy(mBuffer.data() + at, values.data(), values.size() * sizeof(T));
+		}
+	}
+
+private:
+	std::vector<uint8_t>& mBuffer;
+};
+
+/**
+* Reads back what a SnapshotWriter wrote, in the same order. Reading past the end leaves the values untouched
+* and makes ok() false
+*/
+class SnapshotReader final {
+public:
+
+	SnapshotReader(const uint8_t* data, size_t size) noexcept : mData(data), mSize(size) {}
+
+	template<typename T>
+	void read(T& value) noexcept {
+		if (mAt + sizeof(T) > mSize) { mOk = false; return; }
+		std::memcpy(&value, mData + mAt, sizeof(T));
+		mAt += sizeof(T);
+	}
+
+	template<typename T>
+	void readArray(std::vector<T>& values) {
+		uint32_t count = 0u;
+		read(count);
+		if (!mOk || mAt + count * sizeof(T) > mSize) { mOk = false; return; }
+		values.resize(count);
+		if (count > 0u) {
+			std::memcpy(values.data(), mData + mAt, count * sizeof(T));
+		}
+		mAt += count * sizeof(T);
+	}
+
+	inline bool ok() const noexcept {
+		return mOk;
+	}
+
+private:
+	const uint8_t* mData;
+	size_t mSize;
+	size_t mAt{ 0u };
+	bool mOk{ true };
+};
+
+#endif // !SNAPSHOT_STREAM_H_
@@ -0,0 +1,178 @@
+#ifndef STATE_HASH_H_
+#define STATE_HASH_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "entity/entity.h"
+#include "tile/tile.h"
+
+/**
+* Hashing of the simulation state, to tell when two runs that should be identical (a replay, a different thread
+* count, another build) stop being identical.
+*
+* Every part of the state (an entity, a chunk of tiles, a player) hashes to a 64 bit value, and the parts are
+* combined with xor. Xor can take a part back out, so a part that changes only costs its own rehash: the level
+* keeps the hash of what does not change from tick to tick (sleeping entities, untouched tiles) and only rehashes
+* what does. Floats are hashed by their bits, so -0 and 0 differ, which is what bit identical means
+*/
+namespace statehash {
+
+	/**
+	* @brief The splitmix64 finalizer, every input bit flips about half of the output bits
+	*/
+	inline constexpr uint64_t mix(uint64_t h) noexcept {
+		h ^= h >> 30;
+		h *= 0xBF58476D1CE4E5B9ull;
+		h ^= h >> 27;
+		h *= 0x94D049BB133111EBull;
+		h ^= h >> 31;
+		return h;
+	}
+
+	inline constexpr uint64_t combine(uint64_t h, uint64_t value) noexcept {
+		return mix(h ^ (value + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2)));
+	}
+
+	inline constexpr uint64_t rotate(uint64_t h, unsigned bits) noexcept {
+		return (h << bits) | (h >> (64u - bits));
+	}
+
+	inline uint64_t bits(glm::vec2 v) noexcept {
+		uint64_t out;
+		static_assert(sizeof(glm::vec2) == sizeof(uint64_t), "glm::vec2 must be two packed floats");
+		std::memcpy(&out, &v, sizeof(out));
+		return out;
+	}
+}
+
+/**
+* The hash of a level after a tick, split by part so two hashes that differ also say where they differ
+*/
+struct StateHash {
+	uint64_t tick{ 0u };
+	// every part below, combined in order
+	uint64_t total{ 0u };
+	uint64_t tiles{ 0u };
+	uint64_t players{ 0u };
+	// one per EntityType
+	std::array<uint64_t, ENTITY_TYPE_COUNT> blocks{};
+
+	inline bool operator==(const StateHash& other) const noexcept {
+		return total == other.total;
+	}
+
+	inline bool operator!=(const StateHash& other) const noexcept {
+		return total != other.total;
+	}
+};
+
+/**
+* The hash of the tiles, kept per chunk of CHUNK_WIDTH columns. Changing a tile marks its chunk, and only the
+* marked chunks are rehashed, so a tick that breaks a brick costs one chunk instead of the whole level
+*/
+class TileHashGrid final {
+public:
+
+	static constexpr int CHUNK_WIDTH = 16;
+
+	/**
+	* @brief Resizes the grid for a level of this size, every chunk gets rehashed
+	*/
+	void resize(int levelWidth, int levelHeight) {
+		mHeight = levelHeight;
+		const size_t count = static_cast<size_t>((std::max(levelWidth, 0) + CHUNK_WIDTH - 1) / CHUNK_WIDTH);
+		mChunks.assign(count, 0u);
+		mDirty.assign(count, 1u);
+		mVersions.assign(count, 0u);
+		mLayout++;
+		mAnyDirty = true;
+		mHash = 0u;
+		mWidth = levelWidth;
+	}
+
+	inline void markDirty(int x) noexcept {
+		const size_t c = static_cast<size_t>(x / CHUNK_WIDTH);
+		mDirty[c] = 1u;
+		mVersions[c]++;
+		mAnyDirty = true;
+	}
+
+	/**
+	* @return A number that changes every time the grid is resized, the chunk versions start over when it does
+	*/
+	inline uint32_t layout() const noexcept {
+		return mLayout;
+	}
+
+	inline uint32_t chunkCount() const noexcept {
+		return static_cast<uint32_t>(mChunks.size());
+	}
+
+	/**
+	* @return A number that changes every time a tile of the chunk does, for anything else that needs to know
+	* which chunks changed (snapshots)
+	*/
+	inline uint32_t chunkVersion(uint32_t chunk) const noexcept {
+		return mVersions[chunk];
+	}
+
+	/**
+	* @brief Rehashes the marked chunks
+	* @param tiles - The level's tiles, column major
+	* @return The hash of every tile
+	*/
+	uint64_t update(const Tile* tiles) noexcept {
+
+		if (!mAnyDirty) { return mHash; }
+
+		for (size_t c = 0u; c < mChunks.size(); c++) {
+			if (!mDirty[c]) { continue; }
+
+			const int first = static_cast<int>(c) * CHUNK_WIDTH;
+			const int last = std::min(first + CHUNK_WIDTH, mWidth);
+
+			// the chunk's index is part of its hash, so moving a column changes the total
+			uint64_t h = statehash::mix(c + 1u);
+			const Tile* column = tiles + static_cast<size_t>(first) * mHeight;
+			for (int i = 0; i < (last - first) * mHeight; i++) {
+				h = statehash::combine(h, column[i].mData);
+			}
+
+			mHash ^= mChunks[c] ^ h;
+			mChunks[c] = h;
+			mDirty[c] = 0u;
+		}
+
+		mAnyDirty = false;
+		return mHash;
+	}
+
+	/**
+	* @return The first column of the first chunk whose hash differs between the grids, -1 if they are the same
+	*/
+	int firstDifference(const TileHashGrid& other) const noexcept {
+		const size_t count = std::min(mChunks.size(), other.mChunks.size());
+		for (size_t c = 0u; c < count; c++) {
+			if (mChunks[c] != other.mChunks[c]) { return static_cast<int>(c) * CHUNK_WIDTH; }
+		}
+		return mChunks.size() == other.mChunks.size() ? -1 : static_cast<int>(count) * CHUNK_WIDTH;
+	}
+
+private:
+	std::vector<uint64_t> mChunks;
+	std::vector<uint8_t> mDirty;
+	std::vector<uint32_t> mVersions;
+	uint32_t mLayout{ 0u };
+	bool mAnyDirty{ true };
+	uint64_t mHash{ 0u };
+	int mWidth{ 0 };
+	int mHeight{ 0 };
+};
+
+#endif // !STATE_HASH_H_
@@ -0,0 +1,94 @@
+#ifndef SOLID_MASK_H_
+#define SOLID_MASK_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+* A 1 bit per tile bitmap of which tiles are solid.
+* Each row of the level is padded to a whole number of 64 bit words so that a rectangle query
+* only has to OR a couple of words per row instead of testing every tile.
+*/
+class SolidMask final {
+public:
+
+	SolidMask() : mWidth(0), mHeight(0), mWordsPerRow(0) {}
+
+	/**
+	* @brief Resizes the mask and clears every bit
+	* @param width - The width of the level in tiles
+	* @param height - The height of the level in tiles
+	*/
+	void resize(int width, int height) {
+		mWidth = width;
+		mHeight = height;
+		mWordsPerRow = (width + 63) >> 6;
+		mWords.assign(static_cast<size_t>(mWordsPerRow) * static_cast<size_t>(height), 0ull);
+	}
+
+	inline void clear() noexcept {
+		std::fill(mWords.begin(), mWords.end(), 0ull);
+	}
+
+	inline void set(int x, int y, bool solid) noexcept {
+		uint64_t& word = mWords[static_cast<size_t>(y) * mWordsPerRow + (x >> 6)];
+		const uint64_t bit = 1ull << (x & 63);
+		// branch-free set or clear
+		word = (word & ~bit) | (static_cast<uint64_t>(solid) << (x & 63));
+	}
+
+	inline bool test(int x, int y) const noexcept {
+		if (x < 0 || y < 0 || x >= mWidth || y >= mHeight) { return false; }
+		return (mWords[static_cast<size_t>(y) * mWordsPerRow + (x >> 6)] >> (x & 63)) & 1ull;
+	}
+
+	/**
+	* @brief Checks if any tile within the (inclusive) rectangle is solid; the rectangle is clipped to the level
+	* @param x0, y0 - The bottom left tile of the rectangle
+	* @param x1, y1 - The top right tile of the rectangle
+	*/
+	bool anySolid(int x0, int y0, int x1, int y1) const noexcept {
+
+		x0 = x0 < 0 ? 0 : x0;
+		y0 = y0 < 0 ? 0 : y0;
+		x1 = x1 >= mWidth ? mWidth - 1 : x1;
+		y1 = y1 >= mHeight ? mHeight - 1 : y1;
+		if (x0 > x1 || y0 > y1) { return false; }
+
+		const int firstWord = x0 >> 6;
+		const int lastWord = x1 >> 6;
+		// masks for the partial words at either end of each row
+		const uint64_t firstMask = ~0ull << (x0 & 63);
+		const uint64_t lastMask = ~0ull >> (63 - (x1 & 63));
+
+		uint64_t hits = 0ull;
+		for (int y = y0; y <= y1; y++) {
+			const uint64_t* row = &mWords[static_cast<size_t>(y) * mWordsPerRow];
+
+			if (firstWord == lastWord) {
+				hits |= row[firstWord] & firstMask & lastMask;
+				continue;
+			}
+
+			hits |= row[firstWord] & firstMask;
+			for (int w = firstWord + 1; w < lastWord; w++) {
+				hits |= row[w];
+			}
+			hits |= row[lastWord] & lastMask;
+		}
+		return hits != 0ull;
+	}
+
+	inline size_t memoryUsage() const noexcept {
+		return mWords.size() * sizeof(uint64_t);
+	}
+
+private:
+	int mWidth;
+	int mHeight;
+	int mWordsPerRow;
+	std::vector<uint64_t> mWords;
+};
+
+#endif // !SOLID_MASK_H_
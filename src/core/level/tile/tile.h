@@ -1,9 +1,41 @@
 #pragma once
 
+#include <cstdint>
+
+#include "../collider/collider.h"
+
+/**
+* A tile is packed into 16 bits, the atlas only has ~100 sprites so an int is a waste
+* @bits 0 - 11 : the sprite index in the texture atlas (up to 4096 sprites)
+* @bits 12 - 14 : the collider type (TC_Type) of the tile
+* @bit 15 : whether or not the tile is solid
+* @note - Solidity is also mirrored into the level's SolidMask for fast collision queries
+*/
 struct Tile {
-	Tile(bool solid, int sprite) : mSolid(solid), mSprite(sprite) {}
-	Tile() : mSolid(false), mSprite(0) {}
+	// Plain solid tiles (ground, clouds) are indestructible
+	Tile(bool solid, int sprite) : Tile(solid ? TC_Type::STRENGTH_3 : TC_Type::NONE, sprite) {}
+	Tile(TC_Type type, int sprite) : mData(static_cast<uint16_t>(
+		(isBlocking(type) ? SOLID_BIT : 0u) | (static_cast<uint16_t>(type) << TYPE_SHIFT) | (sprite & SPRITE_MASK))) {}
+	Tile() : mData(0u) {}
+
+	static constexpr uint16_t SPRITE_MASK = 0x0FFFu;
+	static constexpr uint16_t TYPE_MASK = 0x7000u;
+	static constexpr uint16_t TYPE_SHIFT = 12u;
+	static constexpr uint16_t SOLID_BIT = 0x8000u;
+
+	inline uint16_t sprite() const noexcept {
+		return mData & SPRITE_MASK;
+	}
+
+	inline bool solid() const noexcept {
+		return (mData & SOLID_BIT) != 0u;
+	}
+
+	inline TC_Type type() const noexcept {
+		return static_cast<TC_Type>((mData & TYPE_MASK) >> TYPE_SHIFT);
+	}
+
+	uint16_t mData;
+};
 
-	bool mSolid;
-	int mSprite;
-};
\ No newline at end of file
+static_assert(sizeof(Tile) == 2, "Tile must stay packed into 16 bits");
@@ -0,0 +1,50 @@
+#include "loopback_transport.h"
+
+#include <algorithm>
+
+namespace net {
+
+	LoopbackLink::LoopbackLink(const LoopbackConfig& config) : mConfig(config), mRandom(config.seed) {
+
+		for (int i = 0; i < 2; i++) {
+			mEnds[i].link = this;
+			mEnds[i].peer = 1 - i;
+		}
+	}
+
+	bool LoopbackLink::End::send(const uint8_t* data, size_t size) noexcept {
+
+		if (size > MAX_PACKET_SIZE) { return false; }
+
+		LoopbackLink& l = *link;
+		l.mSent++;
+
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+		const bool lost = unit(l.mRandom) < l.mConfig.loss;
+		const double jitter = l.mConfig.jitterMs * unit(l.mRandom);
+		if (lost) {
+			l.mDropped++;
+			return true;
+		}
+
+		l.mInFlight[peer].push_back({ l.mNow + l.mConfig.latencyMs + jitter, l.mSent, std::vector<uint8_t>(data, data + size) });
+		return true;
+	}
+
+	size_t LoopbackLink::End::receive(uint8_t* buffer, size_t capacity) noexcept {
+
+		LoopbackLink& l = *link;
+		std::vector<InFlight>& queue = l.mInFlight[peer ^ 1];
+
+		// the first packet to arrive, if it has
+		auto next = std::min_element(queue.begin(), queue.end(), [](const InFlight& a, const InFlight& b) {
+			return a.arrival != b.arrival ? a.arrival < b.arrival : a.order < b.order;
+		});
+		if (next == queue.end() || next->arrival > l.mNow) { return 0u; }
+
+		const size_t size = std::min(capacity, next->data.size());
+		std::copy(next->data.begin(), next->data.begin() + size, buffer);
+		queue.erase(next);
+		return size;
+	}
+}
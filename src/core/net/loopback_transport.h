@@ -0,0 +1,86 @@
+#ifndef LOOPBACK_TRANSPORT_H_
+#define LOOPBACK_TRANSPORT_H_
+
+#include <random>
+#include <vector>
+
+#include "transport.h"
+
+namespace net {
+
+	/**
+	* How bad a LoopbackLink is, in each direction
+	*/
+	struct LoopbackConfig {
+		// one way delay
+		double latencyMs = 0.0;
+		// a random extra delay in [0, jitterMs), which also reorders packets
+		double jitterMs = 0.0;
+		// the chance of a packet being dropped, 0 to 1
+		float loss = 0.0f;
+		// the same seed drops and delays the same packets
+		uint32_t seed = 1u;
+	};
+
+	/**
+	* Two Transports connected to each other in the same process, for testing netcode without a network. The link
+	* has a clock of its own that only moves with advance, so a test run with the same seed and the same calls
+	* delivers the same packets at the same time on every machine
+	*/
+	class LoopbackLink final {
+	public:
+
+		explicit LoopbackLink(const LoopbackConfig& config);
+
+		LoopbackLink(const LoopbackLink&) = delete;
+		LoopbackLink& operator=(const LoopbackLink&) = delete;
+
+		// the two ends of the link
+		inline Transport& a() noexcept { return mEnds[0]; }
+		inline Transport& b() noexcept { return mEnds[1]; }
+
+		/**
+		* @brief Moves the link's clock forward, packets whose delay has passed can be received
+		*/
+		inline void advance(double ms) noexcept {
+			mNow += ms;
+		}
+
+		inline double now() const noexcept {
+			return mNow;
+		}
+
+		inline uint64_t getSentCount() const noexcept { return mSent; }
+		inline uint64_t getDroppedCount() const noexcept { return mDropped; }
+
+	private:
+
+		class End final : public Transport {
+		public:
+			bool send(const uint8_t* data, size_t size) noexcept override;
+			size_t receive(uint8_t* buffer, size_t capacity) noexcept override;
+
+			LoopbackLink* link{ nullptr };
+			// the index of the other end
+			int peer{ 0 };
+		};
+
+		struct InFlight {
+			double arrival;
+			// sent order, so packets with the same arrival time are received in the order they were sent
+			uint64_t order;
+			std::vector<uint8_t> data;
+		};
+
+		LoopbackConfig mConfig;
+		std::mt19937 mRandom;
+		End mEnds[2];
+		// the packets on their way to each end
+		std::vector<InFlight> mInFlight[2];
+		double mNow{ 0.0 };
+		uint64_t mSent{ 0u };
+		uint64_t mDropped{ 0u };
+	};
+}
+
+#endif // !LOOPBACK_TRANSPORT_H_
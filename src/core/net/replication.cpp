@@ -0,0 +1,503 @@
+#include "replication.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "../level/level.h"
+#include "../level/entity/entity_pkg.h"
+
+namespace net {
+
+	namespace {
+
+		constexpr uint32_t MESSAGE_MAGIC = 'R' | ('P' << 8) | ('L' << 16) | (1u << 24);
+
+		// which fields of an entity a message holds
+		enum EntityField : uint8_t {
+			FIELD_X = 1u << 0,
+			FIELD_Y = 1u << 1,
+			FIELD_VX = 1u << 2,
+			FIELD_VY = 1u << 3,
+			// the clip and the tick it started, they change together
+			FIELD_CLIP = 1u << 4,
+			FIELD_FLAGS = 1u << 5,
+			// not in the baseline, the fields are deltas from zero
+			FIELD_NEW = 1u << 6,
+		};
+
+		inline int32_t quantize(float value, float scale) noexcept {
+			return static_cast<int32_t>(std::lround(value * scale));
+		}
+
+		inline uint64_t zigzag(int64_t value) noexcept {
+			return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+		}
+
+		inline int64_t unzigzag(uint64_t value) noexcept {
+			return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1u);
+		}
+
+		inline void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+			while (value >= 0x80u) {
+				out.push_back(static_cast<uint8_t>(value | 0x80u));
+				value >>= 7;
+			}
+			out.push_back(static_cast<uint8_t>(value));
+		}
+
+		inline void writeDelta(std::vector<uint8_t>& out, int64_t from, int64_t to) {
+			writeVarint(out, zigzag(to - from));
+		}
+
+		// reads what the write functions above wrote; reading past the end makes ok false and returns zeros
+		struct MessageReader {
+			const uint8_t* data;
+			size_t size;
+			size_t at{ 0u };
+			bool ok{ true };
+
+			uint64_t varint() noexcept {
+				uint64_t value = 0u;
+				for (unsigned shift = 0u; shift < 64u; shift += 7u) {
+					if (at >= size) { ok = false; return 0u; }
+					const uint8_t byte = data[at++];
+					value |= static_cast<uint64_t>(byte & 0x7Fu) << shift;
+					if (!(byte & 0x80u)) { return value; }
+				}
+				ok = false;
+				return 0u;
+			}
+
+			inline int64_t delta(int64_t from) noexcept {
+				return from + unzigzag(varint());
+			}
+
+			inline uint8_t byte() noexcept {
+				if (at >= size) { ok = false; return 0u; }
+				return data[at++];
+			}
+		};
+
+		constexpr uint32_t GENERATION_BITS = EntityId::GENERATION_BITS;
+		constexpr uint32_t TYPE_SHIFT = EntityId::SLOT_BITS + EntityId::GENERATION_BITS;
+
+		inline uint32_t replicatedId(EntityType type, uint32_t slot, uint32_t generation) noexcept {
+			return (static_cast<uint32_t>(type) << TYPE_SHIFT) | (slot << GENERATION_BITS) | generation;
+		}
+
+		inline EntityType typeOf(uint32_t replicatedId) noexcept {
+			return static_cast<EntityType>(replicatedId >> TYPE_SHIFT);
+		}
+
+		// the type and slot : a slot holds one entity at a time, so within a state this is enough to find it, and
+		// consecutive slots are one apart on the wire
+		inline uint32_t slotKey(uint32_t replicatedId) noexcept {
+			return replicatedId >> GENERATION_BITS;
+		}
+
+		// the quantized state of every entity and player, entities sorted by id
+		void capture(const Level& level, ReplicatedState& state) {
+
+			state.tick = level.tick;
+			state.entities.clear();
+			for (size_t t = 0u; t < ENTITY_TYPE_COUNT; t++) {
+				const EntityBlock& block = level.entities.block(static_cast<EntityType>(t));
+
+				// slot by slot, the free slots point at no entity (or one in another slot)
+				for (uint32_t s = 0u; s < block.generation.size(); s++) {
+					const uint32_t i = block.denseIndex[s];
+					if (i >= block.size() || block.slot[i] != s) { continue; }
+
+					state.entities.push_back({
+						replicatedId(block.type, s, block.generation[s]),
+						quantize(block.position[i].x, replication::POSITION_SCALE),
+						quantize(block.position[i].y, replication::POSITION_SCALE),
+						quantize(block.velocity[i].x, replication::VELOCITY_SCALE),
+						quantize(block.velocity[i].y, replication::VELOCITY_SCALE),
+						block.clipStart[i],
+						block.clip[i],
+						block.flags[i]
+					});
+				}
+			}
+
+			state.players.clear();
+			for (int p = 0; p < level.playerCount; p++) {
+				const Player* player = level.getPlayer(p);
+				state.players.push_back({
+					quantize(player->position.x, replication::POSITION_SCALE),
+					quantize(player->position.y, replication::POSITION_SCALE),
+					quantize(player->velocity.x, replication::VELOCITY_SCALE),
+					quantize(player->velocity.y, replication::VELOCITY_SCALE)
+				});
+			}
+		}
+
+		void writeEntity(std::vector<uint8_t>& out, const ReplicatedEntity& from, const ReplicatedEntity& to, uint8_t mask) {
+
+			out.push_back(mask);
+			if (mask & FIELD_NEW) { writeVarint(out, to.id & EntityId::GENERATION_MASK); }
+			if (mask & FIELD_X) { writeDelta(out, from.x, to.x); }
+			if (mask & FIELD_Y) { writeDelta(out, from.y, to.y); }
+			if (mask & FIELD_VX) { writeDelta(out, from.vx, to.vx); }
+			if (mask & FIELD_VY) { writeDelta(out, from.vy, to.vy); }
+			if (mask & FIELD_CLIP) {
+				writeVarint(out, to.clip);
+				writeDelta(out, from.clipStart, to.clipStart);
+			}
+			if (mask & FIELD_FLAGS) { out.push_back(to.flags); }
+		}
+
+		void readEntity(MessageReader& in, ReplicatedEntity& entity, uint8_t mask) noexcept {
+
+			if (mask & FIELD_NEW) { entity.id |= static_cast<uint32_t>(in.varint()) & EntityId::GENERATION_MASK; }
+			if (mask & FIELD_X) { entity.x = static_cast<int32_t>(in.delta(entity.x)); }
+			if (mask & FIELD_Y) { entity.y = static_cast<int32_t>(in.delta(entity.y)); }
+			if (mask & FIELD_VX) { entity.vx = static_cast<int32_t>(in.delta(entity.vx)); }
+			if (mask & FIELD_VY) { entity.vy = static_cast<int32_t>(in.delta(entity.vy)); }
+			if (mask & FIELD_CLIP) {
+				entity.clip = static_cast<uint16_t>(in.varint());
+				entity.clipStart = static_cast<uint32_t>(in.delta(entity.clipStart));
+			}
+			if (mask & FIELD_FLAGS) { entity.flags = in.byte(); }
+		}
+
+		inline uint8_t changedFields(const ReplicatedEntity& from, const ReplicatedEntity& to) noexcept {
+			const auto field = [](bool changed, EntityField f) noexcept {
+				return changed ? static_cast<uint8_t>(f) : uint8_t{ 0u };
+			};
+			return field(from.x != to.x, FIELD_X) | field(from.y != to.y, FIELD_Y)
+				| field(from.vx != to.vx, FIELD_VX) | field(from.vy != to.vy, FIELD_VY)
+				| field(from.clip != to.clip || from.clipStart != to.clipStart, FIELD_CLIP)
+				| field(from.flags != to.flags, FIELD_FLAGS);
+		}
+	}
+
+	void ReplicationEncoder::reset() noexcept {
+
+		for (Entry& entry : mHistory) {
+			entry.valid = false;
+		}
+		mAcked = UINT64_MAX;
+	}
+
+	void ReplicationEncoder::acknowledge(uint64_t tick) noexcept {
+
+		// acks can arrive out of order, only the newest matters
+		if (mAcked == UINT64_MAX || tick > mAcked) {
+			mAcked = tick;
+		}
+	}
+
+	void ReplicationEncoder::diffTiles(const Level& level, std::vector<TileEdit>& edits) {
+
+		edits.clear();
+
+		const int chunkWidth = TileHashGrid::CHUNK_WIDTH;
+		for (uint32_t c = 0u; c < level.tileHash.chunkCount(); c++) {
+			if (level.tileHash.chunkVersion(c) == mChunkVersions[c]) { continue; }
+			mChunkVersions[c] = level.tileHash.chunkVersion(c);
+
+			const int first = static_cast<int>(c) * chunkWidth;
+			const int last = std::min(first + chunkWidth, level.width);
+			for (int x = first; x < last; x++) {
+				const Tile* column = level.getTileColumn(x);
+				Tile* mirror = mTiles.data() + static_cast<size_t>(x) * level.height;
+				for (int y = 0; y < level.height; y++) {
+					if (column[y].mData != mirror[y].mData) {
+						edits.push_back({ static_cast<uint16_t>(x), static_cast<uint16_t>(y), column[y].mData });
+						mirror[y] = column[y];
+					}
+				}
+			}
+		}
+	}
+
+	bool ReplicationEncoder::encode(const Level& level, std::vector<uint8_t>& out) {
+
+		// a resized level starts over with a full state
+		if (level.tileHash.layout() != mTileLayout) {
+			reset();
+			mTileLayout = level.tileHash.layout();
+			mTiles.assign(level.tileData, level.tileData + static_cast<size_t>(level.width) * level.height);
+			mChunkVersions.resize(level.tileHash.chunkCount());
+			for (uint32_t c = 0u; c < level.tileHash.chunkCount(); c++) {
+				mChunkVersions[c] = level.tileHash.chunkVersion(c);
+			}
+		}
+
+		// encoding the same tick twice keeps the first entry's edits
+		Entry& entry = entryOf(level.tick);
+		if (!(entry.valid && entry.state.tick == level.tick)) {
+			capture(level, entry.state);
+			diffTiles(level, entry.edits);
+			entry.valid = true;
+		}
+
+		const ReplicatedState& state = entry.state;
+		const bool hasBaseline = mAcked != UINT64_MAX && mAcked < level.tick && level.tick - mAcked < replication::HISTORY
+			&& entryOf(mAcked).valid && entryOf(mAcked).state.tick == mAcked;
+		static const ReplicatedState EMPTY;
+		const ReplicatedState& base = hasBaseline ? entryOf(mAcked).state : EMPTY;
+
+		out.clear();
+		const uint32_t magic = MESSAGE_MAGIC;
+		out.resize(sizeof(uint32_t));
+		std::memcpy(out.data(), &magic, sizeof(uint32_t));
+		writeVarint(out, level.tick);
+		writeVarint(out, hasBaseline ? mAcked + 1u : 0u);
+
+		if (!hasBaseline) {
+			// every tile, run length encoded in memory order
+			writeVarint(out, static_cast<uint64_t>(level.width));
+			writeVarint(out, static_cast<uint64_t>(level.height));
+			const size_t count = static_cast<size_t>(level.width) * level.height;
+			for (size_t k = 0u; k < count;) {
+				size_t run = 1u;
+				while (k + run < count && level.tileData[k + run].mData == level.tileData[k].mData) { run++; }
+				writeVarint(out, run);
+				writeVarint(out, level.tileData[k].mData);
+				k += run;
+			}
+		}
+		else {
+			// the edits of every tick after the baseline, in order
+			size_t editCount = 0u;
+			for (uint64_t t = mAcked + 1u; t <= level.tick; t++) {
+				const Entry& e = entryOf(t);
+				editCount += e.valid && e.state.tick == t ? e.edits.size() : 0u;
+			}
+			writeVarint(out, editCount);
+			for (uint64_t t = mAcked + 1u; t <= level.tick; t++) {
+				const Entry& e = entryOf(t);
+				if (!(e.valid && e.state.tick == t)) { continue; }
+				for (const TileEdit& edit : e.edits) {
+					writeVarint(out, edit.x);
+					writeVarint(out, edit.y);
+					writeVarint(out, edit.tile);
+				}
+			}
+		}
+
+		writeVarint(out, state.players.size());
+		for (size_t p = 0u; p < state.players.size(); p++) {
+			const ReplicatedPlayer from = p < base.players.size() ? base.players[p] : ReplicatedPlayer{};
+			const ReplicatedPlayer& to = state.players[p];
+			writeDelta(out, from.x, to.x);
+			writeDelta(out, from.y, to.y);
+			writeDelta(out, from.vx, to.vx);
+			writeDelta(out, from.vy, to.vy);
+		}
+
+		// the removed entities, then the new and changed ones; ids as the gap from the one before
+		const std::vector<ReplicatedEntity>& now = state.entities;
+		const std::vector<ReplicatedEntity>& was = base.entities;
+
+		size_t removed = 0u;
+		for (size_t i = 0u, j = 0u; j < was.size(); j++) {
+			while (i < now.size() && now[i].id < was[j].id) { i++; }
+			removed += i >= now.size() || now[i].id != was[j].id ? 1u : 0u;
+		}
+		writeVarint(out, removed);
+		uint32_t lastId = 0u;
+		for (size_t i = 0u, j = 0u; j < was.size(); j++) {
+			while (i < now.size() && now[i].id < was[j].id) { i++; }
+			if (i >= now.size() || now[i].id != was[j].id) {
+				writeVarint(out, slotKey(was[j].id) - lastId);
+				lastId = slotKey(was[j].id);
+			}
+		}
+
+		// the count goes first, it is patched in once known
+		const size_t countAt = out.size();
+		out.resize(out.size() + 5u);
+		uint32_t changed = 0u;
+		lastId = 0u;
+		static const ReplicatedEntity ZERO{};
+		for (size_t i = 0u, j = 0u; i < now.size(); i++) {
+			while (j < was.size() && was[j].id < now[i].id) { j++; }
+			const bool known = j < was.size() && was[j].id == now[i].id;
+			const ReplicatedEntity& from = known ? was[j] : ZERO;
+			const uint8_t mask = known ? changedFields(from, now[i]) : static_cast<uint8_t>(FIELD_NEW | changedFields(from, now[i]));
+			if (mask == 0u) { continue; }
+
+			writeVarint(out, slotKey(now[i].id) - lastId);
+			lastId = slotKey(now[i].id);
+			writeEntity(out, from, now[i], mask);
+			changed++;
+		}
+
+		// a fixed five byte varint, so the entities do not have to move
+		for (int b = 0; b < 5; b++) {
+			out[countAt + b] = static_cast<uint8_t>(((changed >> (7 * b)) & 0x7Fu) | (b < 4 ? 0x80u : 0u));
+		}
+		return hasBaseline;
+	}
+
+	bool ReplicationDecoder::decode(const uint8_t* data, size_t size, Level& into) {
+
+		MessageReader in{ data, size };
+
+		uint32_t magic = 0u;
+		if (size < sizeof(uint32_t)) { return false; }
+		std::memcpy(&magic, data, sizeof(uint32_t));
+		in.at = sizeof(uint32_t);
+		if (magic != MESSAGE_MAGIC) { return false; }
+
+		const uint64_t tick = in.varint();
+		const uint64_t baselinePlusOne = in.varint();
+		if (!in.ok || (mLastTick != UINT64_MAX && tick <= mLastTick)) { return false; }
+
+		static const ReplicatedState EMPTY;
+		const ReplicatedState* base = &EMPTY;
+		if (baselinePlusOne != 0u) {
+			base = &mHistory[(baselinePlusOne - 1u) % replication::HISTORY];
+			if (base->tick != baselinePlusOne - 1u) { return false; }
+		}
+
+		// the tiles are only written into the level once the whole message was read
+		struct TileRun { uint64_t first, length, tile; };
+		struct TileEdit { uint64_t x, y, tile; };
+		std::vector<TileRun> runs;
+		std::vector<TileEdit> edits;
+		uint64_t width = 0u, height = 0u;
+		if (baselinePlusOne == 0u) {
+			width = in.varint();
+			height = in.varint();
+			if (width == 0u || height == 0u || width > UINT16_MAX || height > UINT16_MAX) { return false; }
+			for (uint64_t k = 0u; in.ok && k < width * height;) {
+				const uint64_t length = in.varint();
+				const uint64_t tile = in.varint();
+				if (length == 0u || k + length > width * height) { return false; }
+				runs.push_back({ k, length, tile });
+				k += length;
+			}
+		}
+		else {
+			const uint64_t count = in.varint();
+			for (uint64_t e = 0u; in.ok && e < count; e++) {
+				const uint64_t x = in.varint();
+				const uint64_t y = in.varint();
+				edits.push_back({ x, y, in.varint() });
+			}
+		}
+
+		// decoded into the slot of the tick, which is never the baseline's (that is less than HISTORY ticks older)
+		ReplicatedState& state = mHistory[tick % replication::HISTORY];
+		if (&state == base) { return false; }
+		state.tick = UINT64_MAX;
+
+		const uint64_t playerCount = in.varint();
+		if (playerCount > 64u) { return false; }
+		state.players.resize(static_cast<size_t>(playerCount));
+		for (size_t p = 0u; p < state.players.size(); p++) {
+			ReplicatedPlayer player = p < base->players.size() ? base->players[p] : ReplicatedPlayer{};
+			player.x = static_cast<int32_t>(in.delta(player.x));
+			player.y = static_cast<int32_t>(in.delta(player.y));
+			player.vx = static_cast<int32_t>(in.delta(player.vx));
+			player.vy = static_cast<int32_t>(in.delta(player.vy));
+			state.players[p] = player;
+		}
+
+		// the baseline without the removed entities, merged with the new and changed ones
+		const uint64_t removedCount = in.varint();
+		std::vector<uint32_t> removed;
+		uint32_t key = 0u;
+		for (uint64_t r = 0u; in.ok && r < removedCount; r++) {
+			key += static_cast<uint32_t>(in.varint());
+			removed.push_back(key);
+		}
+
+		const uint64_t changedCount = in.varint();
+		state.entities.clear();
+		size_t j = 0u, r = 0u;
+		const std::vector<ReplicatedEntity>& was = base->entities;
+		// keeps the baseline's entities before the slot, except the removed ones
+		const auto keep = [&](uint64_t until) {
+			for (; j < was.size() && slotKey(was[j].id) < until; j++) {
+				while (r < removed.size() && removed[r] < slotKey(was[j].id)) { r++; }
+				if (r < removed.size() && removed[r] == slotKey(was[j].id)) { continue; }
+				state.entities.push_back(was[j]);
+			}
+		};
+
+		key = 0u;
+		for (uint64_t c = 0u; in.ok && c < changedCount; c++) {
+			key += static_cast<uint32_t>(in.varint());
+			const uint8_t mask = in.byte();
+
+			keep(key);
+			ReplicatedEntity entity{};
+			if (mask & FIELD_NEW) {
+				// the entity that had the slot before was removed
+				if (j < was.size() && slotKey(was[j].id) == key) { j++; }
+				entity.id = key << GENERATION_BITS;
+			}
+			else {
+				if (j >= was.size() || slotKey(was[j].id) != key) { return false; }
+				entity = was[j++];
+			}
+			readEntity(in, entity, mask);
+			state.entities.push_back(entity);
+		}
+		keep(UINT64_MAX);
+
+		if (!in.ok) { return false; }
+
+		// everything was read, only now does the level change
+		if (baselinePlusOne == 0u) {
+			if (static_cast<int>(width) != into.width || static_cast<int>(height) != into.height) {
+				into.resizeTiles(static_cast<int>(width), static_cast<int>(height));
+			}
+			for (const TileRun& run : runs) {
+				Tile tile;
+				tile.mData = static_cast<uint16_t>(run.tile);
+				for (uint64_t k = run.first; k < run.first + run.length; k++) {
+					into.addTile(tile, static_cast<int>(k / height), static_cast<int>(k % height));
+				}
+			}
+		}
+		else {
+			for (const TileEdit& edit : edits) {
+				if (edit.x >= static_cast<uint64_t>(into.width) || edit.y >= static_cast<uint64_t>(into.height)) { continue; }
+				Tile tile;
+				tile.mData = static_cast<uint16_t>(edit.tile);
+				into.addTile(tile, static_cast<int>(edit.x), static_cast<int>(edit.y));
+			}
+		}
+
+		state.tick = tick;
+		mLastTick = tick;
+		apply(state, into);
+		return true;
+	}
+
+	void ReplicationDecoder::apply(const ReplicatedState& state, Level& into) {
+
+		into.tick = state.tick;
+
+		while (static_cast<size_t>(into.playerCount) < state.players.size()) {
+			into.addPlayer(new Player());
+		}
+		for (size_t p = 0u; p < state.players.size(); p++) {
+			Player* player = into.getPlayer(static_cast<uint32_t>(p));
+			player->position = { state.players[p].x / replication::POSITION_SCALE, state.players[p].y / replication::POSITION_SCALE };
+			player->velocity = { state.players[p].vx / replication::VELOCITY_SCALE, state.players[p].vy / replication::VELOCITY_SCALE };
+		}
+
+		// the entities are rebuilt in id order, the blocks keep their memory so this does not allocate once warm
+		into.entities.clear();
+		for (const ReplicatedEntity& e : state.entities) {
+			EntityBlock& block = into.entities.block(typeOf(e.id));
+			const uint32_t i = block.push(
+				{ e.x / replication::POSITION_SCALE, e.y / replication::POSITION_SCALE },
+				{ e.vx / replication::VELOCITY_SCALE, e.vy / replication::VELOCITY_SCALE },
+				{ 1.0f, 1.0f });
+			if (i == EntityBlock::NO_SLOT) { continue; }
+			block.flags[i] = e.flags;
+			block.clip[i] = e.clip;
+			block.clipStart[i] = e.clipStart;
+		}
+	}
+}
@@ -0,0 +1,151 @@
+#ifndef REPLICATION_H_
+#define REPLICATION_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../level/tile/tile.h"
+
+class Level;
+
+namespace net {
+
+	/**
+	* The state of an entity as a spectator sees it, quantized : positions to 1/256 of a tile, velocities to 1/4096
+	* of a tile per tick. The clip, the tick it started and the flags are what picks the entity's sprite and frame
+	*/
+	struct ReplicatedEntity {
+		// the type, pool slot and generation of the EntityId, packed in that order so walking the pools slot by slot
+		// gives the entities sorted by it
+		uint32_t id;
+		int32_t x, y;
+		int32_t vx, vy;
+		uint32_t clipStart;
+		uint16_t clip;
+		uint8_t flags;
+	};
+
+	/**
+	* A player as a spectator sees it, quantized like the entities
+	*/
+	struct ReplicatedPlayer {
+		int32_t x, y;
+		int32_t vx, vy;
+	};
+
+	/**
+	* A quantized view of a level at one tick
+	*/
+	struct ReplicatedState {
+		// UINT64_MAX for none
+		uint64_t tick{ UINT64_MAX };
+		std::vector<ReplicatedEntity> entities;
+		std::vector<ReplicatedPlayer> players;
+	};
+
+	namespace replication {
+
+		static constexpr float POSITION_SCALE = 256.0f;
+		static constexpr float VELOCITY_SCALE = 4096.0f;
+		// the states kept to delta against, a spectator that acks nothing this recent gets a full state
+		static constexpr uint32_t HISTORY = 32u;
+	}
+
+	/**
+	* Turns a level into a stream of messages for spectators, one per tick. A message holds what changed since the
+	* newest state the spectator acknowledged (its baseline) : the entities that were added, removed or changed,
+	* with only the fields that changed as varint deltas, the players, and the tiles that were edited. With no
+	* baseline (a new spectator, or one that has not acked anything for HISTORY ticks) the message holds everything,
+	* tiles included.
+	*
+	* Messages are unreliable : a lost one is simply never acked, and the next message is encoded against an older
+	* baseline until one gets through
+	*/
+	class ReplicationEncoder final {
+	public:
+
+		ReplicationEncoder() = default;
+
+		/**
+		* @brief Encodes the level's current tick against the acknowledged baseline
+		* @return false if there was no baseline and the message holds everything
+		*/
+		bool encode(const Level& level, std::vector<uint8_t>& out);
+
+		/**
+		* @brief The spectator decoded the message of this tick, later messages can be encoded against it
+		*/
+		void acknowledge(uint64_t tick) noexcept;
+
+		/**
+		* @brief Forgets every baseline, the next message holds everything
+		*/
+		void reset() noexcept;
+
+	private:
+
+		struct TileEdit {
+			uint16_t x, y;
+			uint16_t tile;
+		};
+
+		struct Entry {
+			ReplicatedState state;
+			// the tiles edited since the entry before
+			std::vector<TileEdit> edits;
+			bool valid{ false };
+		};
+
+		inline Entry& entryOf(uint64_t tick) noexcept {
+			return mHistory[tick % replication::HISTORY];
+		}
+
+		// finds the tiles that changed since the last encode
+		void diffTiles(const Level& level, std::vector<TileEdit>& edits);
+
+		std::array<Entry, replication::HISTORY> mHistory;
+		uint64_t mAcked{ UINT64_MAX };
+
+		// the tiles as of the last encode, and the chunk versions they were copied at
+		std::vector<Tile> mTiles;
+		std::vector<uint32_t> mChunkVersions;
+		uint32_t mTileLayout{ UINT32_MAX };
+	};
+
+	/**
+	* Rebuilds a render only level from a ReplicationEncoder's messages. The level is never simulated : its tiles,
+	* players and entities are overwritten with what the messages say, which is everything buildRenderList needs
+	*/
+	class ReplicationDecoder final {
+	public:
+
+		/**
+		* @brief Applies a message to the level
+		* @return false if the message was older than the last one, its baseline is unknown, or it is malformed;
+		* the level is left untouched
+		*/
+		bool decode(const uint8_t* data, size_t size, Level& into);
+
+		/**
+		* @return The tick of the last message decoded, to acknowledge
+		*/
+		inline uint64_t lastTick() const noexcept {
+			return mLastTick;
+		}
+
+		inline const ReplicatedState* latest() const noexcept {
+			return mLastTick == UINT64_MAX ? nullptr : &mHistory[mLastTick % replication::HISTORY];
+		}
+
+	private:
+
+		// writes a decoded state into the level's players and entities
+		void apply(const ReplicatedState& state, Level& into);
+
+		std::array<ReplicatedState, replication::HISTORY> mHistory;
+		uint64_t mLastTick{ UINT64_MAX };
+	};
+}
+
+#endif // !REPLICATION_H_
@@ -0,0 +1,271 @@
+#include "rollback.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "../level/level.h"
+#include "../level/snapshot.h"
+
+namespace net {
+
+	namespace {
+
+		using Clock = std::chrono::steady_clock;
+
+		inline double millisecondsSince(Clock::time_point start) noexcept {
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+
+		constexpr uint32_t PACKET_MAGIC = 'R' | ('B' << 8) | ('K' << 16) | (1u << 24);
+		// no hash in the packet
+		constexpr uint64_t NO_HASH_TICK = UINT64_MAX;
+
+		#pragma pack(1)
+
+		// followed by count inputs, the sender's inputs of the ticks [firstTick, firstTick + count)
+		struct InputPacket {
+			uint32_t magic;
+			uint8_t player;
+			uint8_t count;
+			uint16_t padding;
+			uint64_t firstTick;
+			// the sender has the receiver's inputs of every tick before this one
+			uint64_t ack;
+			// the state hash of the sender's newest confirmed tick
+			uint64_t hashTick;
+			uint64_t hash;
+		};
+
+		static_assert(sizeof(InputPacket) == 40);
+
+		#pragma pack()
+	}
+
+	uint64_t RollbackStats::getSustainableDepth() const noexcept {
+
+		constexpr double FRAME_MS = 1000.0 / 60.0;
+		if (ticks == 0u || resimulatedTicks == 0u) { return 0u; }
+
+		const double tick = tickMs / ticks;
+		const double restore = rollbacks > 0u ? restoreMs / rollbacks : 0.0;
+		const double resimulate = resimulateMs / resimulatedTicks;
+		const double budget = FRAME_MS - tick - restore;
+		return budget > 0.0 && resimulate > 0.0 ? static_cast<uint64_t>(budget / resimulate) : 0u;
+	}
+
+	RollbackSession::RollbackSession(Level& level, SnapshotRing& snapshots, int localPlayer) noexcept
+		: mLevel(level), mSnapshots(snapshots), mLocalPlayer(localPlayer), mPlayers(level.playerCount) {
+
+		mStartTick = level.tick;
+		for (PlayerInputs& player : mPlayers) {
+			player.confirmed = mStartTick;
+			player.acked = mStartTick;
+		}
+		mPlayers[localPlayer].connected = true;
+
+		// the tick everything starts from, the first one that can be rolled back to
+		mLevel.snapshots = &mSnapshots;
+		mSnapshots.clear();
+		mSnapshots.capture(mLevel);
+	}
+
+	void RollbackSession::addPeer(Transport* transport, int player) noexcept {
+
+		mPlayers[player].transport = transport;
+		mPlayers[player].connected = true;
+	}
+
+	uint64_t RollbackSession::getConfirmedTick() const noexcept {
+
+		uint64_t confirmed = UINT64_MAX;
+		for (const PlayerInputs& player : mPlayers) {
+			// players nobody controls never press anything, they never hold the others back
+			if (player.connected) {
+				confirmed = std::min(confirmed, player.confirmed);
+			}
+		}
+		return confirmed;
+	}
+
+	bool RollbackSession::getConfirmedHash(uint64_t tick, uint64_t& hash) const noexcept {
+
+		if (tick < mStartTick || tick >= getConfirmedTick() || tick >= mLevel.tick) { return false; }
+		if (mLevel.tick - tick > INPUT_HISTORY) { return false; }
+
+		hash = mHashes[tick % INPUT_HISTORY];
+		return true;
+	}
+
+	InputState RollbackSession::inputOf(const PlayerInputs& player, uint64_t tick) const noexcept {
+
+		if (tick < player.confirmed) {
+			return player.inputs[tick % INPUT_HISTORY];
+		}
+		// the prediction : the player still holds what they held last
+		return player.confirmed > mStartTick ? player.inputs[(player.confirmed - 1u) % INPUT_HISTORY] : InputState{};
+	}
+
+	bool RollbackSession::advance(InputState localInput) noexcept {
+
+		receive();
+
+		if (mRollbackTo != NO_ROLLBACK) {
+			rollback();
+		}
+
+		// the hashes the peers sent can only be compared once the rollback is done
+		for (PlayerInputs& player : mPlayers) {
+			uint64_t hash;
+			if (player.remoteHashTick != NO_HASH_TICK && getConfirmedHash(player.remoteHashTick, hash)) {
+				mStats.desyncs += hash != player.remoteHash ? 1u : 0u;
+				player.remoteHashTick = NO_HASH_TICK;
+			}
+		}
+
+		if (mLevel.tick - getConfirmedTick() >= MAX_PREDICTION) {
+			mStats.stalls++;
+			// still tells the peers what they are missing
+			send();
+			return false;
+		}
+
+		PlayerInputs& local = mPlayers[mLocalPlayer];
+		local.inputs[mLevel.tick % INPUT_HISTORY] = localInput;
+		local.confirmed = mLevel.tick + 1u;
+
+		const Clock::time_point start = Clock::now();
+		simulate();
+		mStats.tickMs += millisecondsSince(start);
+		mStats.ticks++;
+
+		send();
+		return true;
+	}
+
+	void RollbackSession::simulate() noexcept {
+
+		const uint64_t tick = mLevel.tick;
+		for (size_t p = 0u; p < mPlayers.size(); p++) {
+			const InputState input = inputOf(mPlayers[p], tick);
+			mPlayers[p].used[tick % INPUT_HISTORY] = input;
+			mLevel.getPlayer(static_cast<uint32_t>(p))->handleInput(input);
+		}
+
+		// captures the tick into the snapshots as well
+		mLevel.update();
+		mHashes[tick % INPUT_HISTORY] = mLevel.getStateHash().total;
+	}
+
+	void RollbackSession::rollback() noexcept {
+
+		const uint64_t to = mRollbackTo;
+		const uint64_t now = mLevel.tick;
+		mRollbackTo = NO_ROLLBACK;
+
+		const Clock::time_point start = Clock::now();
+		if (!mSnapshots.restore(mLevel, to)) {
+			// only if the ring is too small for MAX_PREDICTION, nothing can be done but carry on
+			return;
+		}
+		mStats.restoreMs += millisecondsSince(start);
+
+		const Clock::time_point resimulateStart = Clock::now();
+		while (mLevel.tick < now) {
+			simulate();
+		}
+		mStats.resimulateMs += millisecondsSince(resimulateStart);
+
+		mStats.rollbacks++;
+		mStats.resimulatedTicks += now - to;
+		mStats.maxDepth = std::max(mStats.maxDepth, now - to);
+	}
+
+	void RollbackSession::receive() noexcept {
+
+		uint8_t buffer[MAX_PACKET_SIZE];
+
+		for (PlayerInputs& peer : mPlayers) {
+			if (peer.transport == nullptr) { continue; }
+
+			size_t size;
+			while ((size = peer.transport->receive(buffer, sizeof(buffer))) > 0u) {
+				InputPacket packet;
+				if (size < sizeof(InputPacket)) { continue; }
+				std::memcpy(&packet, buffer, sizeof(InputPacket));
+				if (packet.magic != PACKET_MAGIC || size != sizeof(InputPacket) + packet.count * sizeof(uint16_t)) { continue; }
+				if (packet.player >= mPlayers.size() || mPlayers[packet.player].transport != peer.transport) { continue; }
+
+				PlayerInputs& player = mPlayers[packet.player];
+				player.acked = std::max(player.acked, packet.ack);
+				if (packet.hashTick != NO_HASH_TICK) {
+					player.remoteHashTick = packet.hashTick;
+					player.remoteHash = packet.hash;
+				}
+
+				// the inputs are only taken in order, a packet that starts after a gap waits for a resend
+				for (uint64_t t = packet.firstTick; t < packet.firstTick + packet.count; t++) {
+					if (t != player.confirmed) { continue; }
+
+					InputState input;
+					std::memcpy(&input.buttons, buffer + sizeof(InputPacket) + (t - packet.firstTick) * sizeof(uint16_t), sizeof(uint16_t));
+					player.inputs[t % INPUT_HISTORY] = input;
+					player.confirmed++;
+
+					// a tick that already ran on a wrong guess
+					if (t < mLevel.tick && !(player.used[t % INPUT_HISTORY] == input)) {
+						mRollbackTo = std::min(mRollbackTo, t);
+					}
+				}
+			}
+		}
+	}
+
+	void RollbackSession::send() noexcept {
+
+		uint8_t buffer[MAX_PACKET_SIZE];
+		const PlayerInputs& local = mPlayers[mLocalPlayer];
+
+		const uint64_t confirmed = std::min(getConfirmedTick(), mLevel.tick);
+		const bool hasHash = confirmed > mStartTick;
+
+		for (size_t p = 0u; p < mPlayers.size(); p++) {
+			const PlayerInputs& peer = mPlayers[p];
+			if (peer.transport == nullptr) { continue; }
+
+			// everything the peer has not acknowledged, the newest INPUT_HISTORY at most
+			const uint64_t first = std::max(peer.acked, local.confirmed > INPUT_HISTORY ? local.confirmed - INPUT_HISTORY : 0u);
+			const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(local.confirmed - std::min(first, local.confirmed), UINT8_MAX));
+
+			InputPacket packet{};
+			packet.magic = PACKET_MAGIC;
+			packet.player = static_cast<uint8_t>(mLocalPlayer);
+			packet.count = static_cast<uint8_t>(count);
+			packet.firstTick = first;
+			packet.ack = peer.confirmed;
+			packet.hashTick = hasHash ? confirmed - 1u : NO_HASH_TICK;
+			packet.hash = hasHash ? mHashes[(confirmed - 1u) % INPUT_HISTORY] : 0u;
+
+			std::memcpy(buffer, &packet, sizeof(InputPacket));
+			for (uint32_t i = 0u; i < count; i++) {
+				std::memcpy(buffer + sizeof(InputPacket) + i * sizeof(uint16_t), &local.inputs[(first + i) % INPUT_HISTORY].buttons, sizeof(uint16_t));
+			}
+
+			peer.transport->send(buffer, sizeof(InputPacket) + count * sizeof(uint16_t));
+		}
+	}
+
+	void RollbackSession::report(std::ostream& out) const {
+
+		const RollbackStats& s = mStats;
+		const auto average = [](double total, uint64_t count) { return count > 0u ? total / count : 0.0; };
+
+		out << "Rollback : " << s.ticks << " ticks, " << s.stalls << " stalls, " << s.rollbacks << " rollbacks ("
+			<< average(static_cast<double>(s.resimulatedTicks), s.rollbacks) << " ticks deep on average, "
+			<< s.maxDepth << " at most), " << s.desyncs << " desyncs\n";
+		out << "  tick " << average(s.tickMs, s.ticks) << " ms, restore " << average(s.restoreMs, s.rollbacks)
+			<< " ms, resimulated tick " << average(s.resimulateMs, s.resimulatedTicks) << " ms, rollback "
+			<< average(s.restoreMs + s.resimulateMs, s.rollbacks) << " ms\n";
+		out << "  deepest rollback that fits a 60 Hz frame : " << s.getSustainableDepth() << " ticks\n";
+	}
+}
@@ -0,0 +1,149 @@
+#ifndef ROLLBACK_H_
+#define ROLLBACK_H_
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "transport.h"
+#include "../controller.h"
+
+class Level;
+class SnapshotRing;
+
+namespace net {
+
+	/**
+	* What rolling back cost a session, see RollbackSession::report
+	*/
+	struct RollbackStats {
+		// the ticks simulated for the first time
+		uint64_t ticks{ 0u };
+		// the ticks that waited for a peer instead
+		uint64_t stalls{ 0u };
+		uint64_t rollbacks{ 0u };
+		uint64_t resimulatedTicks{ 0u };
+		uint64_t maxDepth{ 0u };
+		// confirmed ticks whose hash a peer disagreed with
+		uint64_t desyncs{ 0u };
+
+		double tickMs{ 0.0 };
+		double restoreMs{ 0.0 };
+		double resimulateMs{ 0.0 };
+
+		/**
+		* @return The deepest rollback that still fits a 60 Hz frame along with the tick itself, from the average
+		* costs : (frame - tick - restore) / resimulated tick
+		*/
+		uint64_t getSustainableDepth() const noexcept;
+	};
+
+	/**
+	* GGPO style rollback netcode for a level shared by a few players, one per machine.
+	*
+	* Every tick, the local player's input is simulated right away and sent to every peer, along with every input
+	* of theirs they have not acknowledged yet, so a lost packet is covered by the next one. The inputs of remote
+	* players that have not arrived yet are predicted to be the same as their last known input. Every tick is
+	* captured in the SnapshotRing; when a remote input arrives that differs from what was predicted, the level is
+	* restored to that tick and every tick since is simulated again with the real input.
+	*
+	* A tick is confirmed once the inputs of every player are known up to it; confirmed ticks never roll back, and
+	* their state hash is sent to the peers, which report a desync if theirs differs. When a peer falls more than
+	* MAX_PREDICTION ticks behind, the session stops advancing until it catches up instead of predicting further
+	*/
+	class RollbackSession final {
+	public:
+
+		static constexpr uint32_t MAX_PREDICTION = 8u;
+		// the inputs kept per player, enough for MAX_PREDICTION ticks and everything a peer has not acked
+		static constexpr uint32_t INPUT_HISTORY = 64u;
+
+		/**
+		* @param snapshots - Has to keep more than MAX_PREDICTION ticks; the session sets it as the level's
+		* snapshots and captures the current tick as the start
+		* @param level - Has to be playing, for every tick to be captured
+		* @param localPlayer - The player this machine controls
+		*/
+		RollbackSession(Level& level, SnapshotRing& snapshots, int localPlayer) noexcept;
+
+		/**
+		* @brief Connects the player controlled on the other end of the transport, which is not owned
+		*/
+		void addPeer(Transport* transport, int player) noexcept;
+
+		/**
+		* @brief Reads what the peers sent, rolls back if a prediction was wrong, then simulates the next tick with
+		* the local input and sends it
+		* @return false if the session stalled waiting for a peer, the input was not used and has to be given again
+		*/
+		bool advance(InputState localInput) noexcept;
+
+		/**
+		* @return The first tick that is not confirmed yet
+		*/
+		uint64_t getConfirmedTick() const noexcept;
+
+		/**
+		* @brief Gets the state hash of a confirmed tick, for comparing sessions
+		* @return false if the tick is not confirmed or no longer kept
+		*/
+		bool getConfirmedHash(uint64_t tick, uint64_t& hash) const noexcept;
+
+		inline const RollbackStats& getStats() const noexcept {
+			return mStats;
+		}
+
+		/**
+		* @brief Prints the rollback counts, the average cost of a restore and of a resimulated tick, and the
+		* deepest rollback that fits in a 60 Hz frame
+		*/
+		void report(std::ostream& out) const;
+
+	private:
+
+		struct PlayerInputs {
+			// the real inputs, by tick
+			std::array<InputState, INPUT_HISTORY> inputs{};
+			// what the simulation used, a prediction for ticks not confirmed when they were simulated
+			std::array<InputState, INPUT_HISTORY> used{};
+			// the inputs of every tick before this one are known
+			uint64_t confirmed{ 0u };
+
+			// the peer the player is on, null for the local player
+			Transport* transport{ nullptr };
+			// the peer has the local inputs of every tick before this one
+			uint64_t acked{ 0u };
+			bool connected{ false };
+
+			// the last state hash the peer sent, checked once the tick is confirmed here too
+			uint64_t remoteHashTick{ UINT64_MAX };
+			uint64_t remoteHash{ 0u };
+		};
+
+		InputState inputOf(const PlayerInputs& player, uint64_t tick) const noexcept;
+
+		void receive() noexcept;
+		void send() noexcept;
+		void rollback() noexcept;
+		void simulate() noexcept;
+
+		Level& mLevel;
+		SnapshotRing& mSnapshots;
+		int mLocalPlayer;
+		std::vector<PlayerInputs> mPlayers;
+
+		// the earliest tick simulated with a wrong prediction, NO_ROLLBACK if none
+		static constexpr uint64_t NO_ROLLBACK = UINT64_MAX;
+		uint64_t mRollbackTo{ NO_ROLLBACK };
+
+		// the state hash after every tick kept, by tick
+		std::array<uint64_t, INPUT_HISTORY> mHashes{};
+		// the tick the session started at, nothing before it is kept
+		uint64_t mStartTick{ 0u };
+
+		RollbackStats mStats;
+	};
+}
+
+#endif // !ROLLBACK_H_
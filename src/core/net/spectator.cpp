@@ -0,0 +1,146 @@
+#include "spectator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "../level/level.h"
+
+namespace net {
+
+	namespace {
+
+		using Clock = std::chrono::steady_clock;
+
+		inline double millisecondsSince(Clock::time_point start) noexcept {
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		}
+
+		constexpr uint32_t FRAGMENT_MAGIC = 'S' | ('P' << 8) | ('F' << 16) | (1u << 24);
+		constexpr uint32_t ACK_MAGIC = 'S' | ('P' << 8) | ('A' << 16) | (1u << 24);
+
+		#pragma pack(1)
+
+		// followed by up to FRAGMENT_SIZE bytes of the message
+		struct FragmentHeader {
+			uint32_t magic;
+			uint64_t tick;
+			uint32_t size;
+			uint16_t index;
+			uint16_t count;
+		};
+
+		static_assert(sizeof(FragmentHeader) == 20);
+
+		struct AckPacket {
+			uint32_t magic;
+			uint64_t tick;
+		};
+
+		static_assert(sizeof(AckPacket) == 12);
+
+		#pragma pack()
+
+		constexpr size_t FRAGMENT_SIZE = MAX_PACKET_SIZE - sizeof(FragmentHeader);
+	}
+
+	void SpectatorServer::send(const Level& level) {
+
+		uint8_t buffer[MAX_PACKET_SIZE];
+
+		size_t size;
+		while ((size = mTransport->receive(buffer, sizeof(buffer))) > 0u) {
+			AckPacket ack;
+			if (size != sizeof(AckPacket)) { continue; }
+			std::memcpy(&ack, buffer, sizeof(AckPacket));
+			if (ack.magic != ACK_MAGIC) { continue; }
+
+			mEncoder.acknowledge(ack.tick);
+			if (ack.tick == mFullTick) {
+				mFullTick = UINT64_MAX;
+			}
+		}
+
+		// the full state is resent as it was, until it is acked or too old to be a baseline
+		uint64_t tick = level.tick;
+		const bool resend = mFullTick != UINT64_MAX && level.tick - mFullTick < replication::HISTORY / 2u;
+		if (resend) {
+			tick = mFullTick;
+		}
+		else {
+			const Clock::time_point start = Clock::now();
+			const bool delta = mEncoder.encode(level, mMessage);
+			mEncodeMs += millisecondsSince(start);
+			mMessages++;
+
+			mFullTick = delta ? UINT64_MAX : level.tick;
+			mFullStates += delta ? 0u : 1u;
+		}
+
+		const uint32_t count = static_cast<uint32_t>((mMessage.size() + FRAGMENT_SIZE - 1u) / FRAGMENT_SIZE);
+		for (uint32_t f = 0u; f < count && count <= UINT16_MAX; f++) {
+			const size_t first = f * FRAGMENT_SIZE;
+			const size_t length = std::min(FRAGMENT_SIZE, mMessage.size() - first);
+
+			const FragmentHeader header{ FRAGMENT_MAGIC, tick, static_cast<uint32_t>(mMessage.size()),
+				static_cast<uint16_t>(f), static_cast<uint16_t>(count) };
+			std::memcpy(buffer, &header, sizeof(FragmentHeader));
+			std::memcpy(buffer + sizeof(FragmentHeader), mMessage.data() + first, length);
+
+			mTransport->send(buffer, sizeof(FragmentHeader) + length);
+			mSentBytes += sizeof(FragmentHeader) + length;
+		}
+	}
+
+	bool SpectatorClient::receive() {
+
+		uint8_t buffer[MAX_PACKET_SIZE];
+		bool changed = false;
+
+		size_t size;
+		while ((size = mTransport->receive(buffer, sizeof(buffer))) > 0u) {
+			FragmentHeader header;
+			if (size < sizeof(FragmentHeader)) { continue; }
+			std::memcpy(&header, buffer, sizeof(FragmentHeader));
+
+			const size_t first = static_cast<size_t>(header.index) * FRAGMENT_SIZE;
+			const size_t length = size - sizeof(FragmentHeader);
+			if (header.magic != FRAGMENT_MAGIC || header.index >= header.count || first + length > header.size) { continue; }
+
+			// a message older than the last one decoded could not be decoded anyway
+			const uint64_t decoded = mDecoder.lastTick();
+			if (decoded != UINT64_MAX && header.tick <= decoded) { continue; }
+
+			Assembly& assembly = mAssemblies[header.tick % ASSEMBLIES];
+			if (assembly.tick != UINT64_MAX && header.tick < assembly.tick) { continue; }
+			if (header.tick != assembly.tick || header.size != assembly.message.size()) {
+				assembly.tick = header.tick;
+				assembly.message.assign(header.size, 0u);
+				assembly.received.assign(header.count, 0u);
+				assembly.missing = header.count;
+			}
+
+			if (assembly.received[header.index]) { continue; }
+			assembly.received[header.index] = 1u;
+			assembly.missing--;
+			std::memcpy(assembly.message.data() + first, buffer + sizeof(FragmentHeader), length);
+
+			if (assembly.missing > 0u) { continue; }
+
+			const Clock::time_point start = Clock::now();
+			const bool ok = mDecoder.decode(assembly.message.data(), assembly.message.size(), mView);
+			mDecodeMs += millisecondsSince(start);
+			assembly.tick = UINT64_MAX;
+
+			if (ok) {
+				mDecoded++;
+				changed = true;
+
+				const AckPacket ack{ ACK_MAGIC, mDecoder.lastTick() };
+				mTransport->send(reinterpret_cast<const uint8_t*>(&ack), sizeof(AckPacket));
+			}
+		}
+
+		return changed;
+	}
+}
@@ -0,0 +1,88 @@
+#ifndef SPECTATOR_H_
+#define SPECTATOR_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "replication.h"
+#include "transport.h"
+
+class Level;
+
+namespace net {
+
+	/**
+	* Sends a level's replication stream to one spectator. Messages larger than a packet are split into fragments,
+	* and the spectator acks every message it decodes. A full state that is not acked yet is sent again as it was,
+	* so the spectator can complete it from the fragments of several sends even when some are lost
+	*/
+	class SpectatorServer final {
+	public:
+
+		explicit SpectatorServer(Transport* transport) noexcept : mTransport(transport) {}
+
+		/**
+		* @brief Reads the spectator's acks, then encodes and sends the level's current tick
+		*/
+		void send(const Level& level);
+
+		inline uint64_t getSentBytes() const noexcept { return mSentBytes; }
+		inline uint64_t getMessageCount() const noexcept { return mMessages; }
+		inline uint64_t getFullStateCount() const noexcept { return mFullStates; }
+		inline double getEncodeMs() const noexcept { return mEncodeMs; }
+
+	private:
+		Transport* mTransport;
+		ReplicationEncoder mEncoder;
+		std::vector<uint8_t> mMessage;
+		// the tick of the full state being resent, UINT64_MAX if the last message was a delta
+		uint64_t mFullTick{ UINT64_MAX };
+
+		uint64_t mSentBytes{ 0u };
+		uint64_t mMessages{ 0u };
+		uint64_t mFullStates{ 0u };
+		double mEncodeMs{ 0.0 };
+	};
+
+	/**
+	* Receives a SpectatorServer's stream into a render only level, see ReplicationDecoder
+	*/
+	class SpectatorClient final {
+	public:
+
+		SpectatorClient(Transport* transport, Level& view) noexcept : mTransport(transport), mView(view) {}
+
+		/**
+		* @brief Reads every fragment that arrived, decodes the messages they complete and acks them
+		* @return true if the view changed
+		*/
+		bool receive();
+
+		inline const ReplicationDecoder& getDecoder() const noexcept { return mDecoder; }
+		inline uint64_t getDecodedCount() const noexcept { return mDecoded; }
+		inline double getDecodeMs() const noexcept { return mDecodeMs; }
+
+	private:
+		Transport* mTransport;
+		Level& mView;
+		ReplicationDecoder mDecoder;
+
+		// a message being put together from its fragments
+		struct Assembly {
+			uint64_t tick{ UINT64_MAX };
+			std::vector<uint8_t> message;
+			std::vector<uint8_t> received;
+			uint32_t missing{ 0u };
+		};
+
+		// the fragments of consecutive messages arrive mixed up when the link jitters, a few are put together at once
+		static constexpr uint32_t ASSEMBLIES = 4u;
+		std::array<Assembly, ASSEMBLIES> mAssemblies;
+
+		uint64_t mDecoded{ 0u };
+		double mDecodeMs{ 0.0 };
+	};
+}
+
+#endif // !SPECTATOR_H_
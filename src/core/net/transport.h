@@ -0,0 +1,35 @@
+#ifndef TRANSPORT_H_
+#define TRANSPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace net {
+
+	// small enough to never be fragmented
+	static constexpr size_t MAX_PACKET_SIZE = 1200u;
+
+	/**
+	* An unreliable, unordered datagram link to one peer, like UDP. Packets may be lost, duplicated or arrive out
+	* of order; whatever runs on top (RollbackSession) has to cope with that
+	*/
+	class Transport {
+	public:
+
+		virtual ~Transport() = default;
+
+		/**
+		* @brief Sends a packet of at most MAX_PACKET_SIZE bytes
+		* @return false if it could not be sent; true does not mean it will arrive
+		*/
+		virtual bool send(const uint8_t* data, size_t size) noexcept = 0;
+
+		/**
+		* @brief Takes the next packet that arrived, without blocking
+		* @return The size of the packet, 0 if there was none
+		*/
+		virtual size_t receive(uint8_t* buffer, size_t capacity) noexcept = 0;
+	};
+}
+
+#endif // !TRANSPORT_H_
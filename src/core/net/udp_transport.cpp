@@ -0,0 +1,153 @@
+#include "udp_transport.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	#pragma comment(lib, "Ws2_32.lib")
+
+	using NativeSocket = SOCKET;
+	using SocketLength = int;
+#else
+	#include <arpa/inet.h>
+	#include <fcntl.h>
+	#include <netdb.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
+	#include <unistd.h>
+
+	using NativeSocket = int;
+	using SocketLength = socklen_t;
+#endif
+
+namespace net {
+
+	namespace {
+
+		inline NativeSocket native(intptr_t socket) noexcept {
+			return static_cast<NativeSocket>(socket);
+		}
+
+#ifdef _WIN32
+		// WSAStartup is reference counted, one per open socket
+		inline bool startup() noexcept {
+			WSADATA data;
+			return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		}
+
+		inline void cleanup() noexcept {
+			WSACleanup();
+		}
+
+		inline void closeSocket(intptr_t socket) noexcept {
+			closesocket(native(socket));
+		}
+
+		inline bool makeNonBlocking(intptr_t socket) noexcept {
+			u_long nonBlocking = 1;
+			return ioctlsocket(native(socket), FIONBIO, &nonBlocking) == 0;
+		}
+#else
+		inline bool startup() noexcept { return true; }
+		inline void cleanup() noexcept {}
+
+		inline void closeSocket(intptr_t socket) noexcept {
+			::close(native(socket));
+		}
+
+		inline bool makeNonBlocking(intptr_t socket) noexcept {
+			const int flags = fcntl(native(socket), F_GETFL, 0);
+			return flags >= 0 && fcntl(native(socket), F_SETFL, flags | O_NONBLOCK) == 0;
+		}
+#endif
+	}
+
+	UdpTransport::~UdpTransport() noexcept {
+		close();
+	}
+
+	bool UdpTransport::open(uint16_t localPort, const char* remoteHost, uint16_t remotePort) noexcept {
+
+		close();
+		if (!startup()) {
+			std::cerr << "Could not start the socket library\n";
+			return false;
+		}
+
+		addrinfo hints{};
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_DGRAM;
+		addrinfo* remote = nullptr;
+		if (getaddrinfo(remoteHost, nullptr, &hints, &remote) != 0 || remote == nullptr) {
+			std::cerr << "Could not resolve [ " << remoteHost << " ]\n";
+			cleanup();
+			return false;
+		}
+		mRemoteAddress = reinterpret_cast<const sockaddr_in*>(remote->ai_addr)->sin_addr.s_addr;
+		mRemotePort = htons(remotePort);
+		freeaddrinfo(remote);
+
+		const intptr_t s = static_cast<intptr_t>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+		if (s == INVALID) {
+			std::cerr << "Could not open a UDP socket\n";
+			cleanup();
+			return false;
+		}
+
+		sockaddr_in local{};
+		local.sin_family = AF_INET;
+		local.sin_addr.s_addr = htonl(INADDR_ANY);
+		local.sin_port = htons(localPort);
+		if (bind(native(s), reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 || !makeNonBlocking(s)) {
+			std::cerr << "Could not bind UDP port " << localPort << "\n";
+			closeSocket(s);
+			cleanup();
+			return false;
+		}
+
+		mSocket = s;
+		return true;
+	}
+
+	void UdpTransport::close() noexcept {
+
+		if (mSocket == INVALID) { return; }
+		closeSocket(mSocket);
+		cleanup();
+		mSocket = INVALID;
+	}
+
+	bool UdpTransport::send(const uint8_t* data, size_t size) noexcept {
+
+		if (mSocket == INVALID || size > MAX_PACKET_SIZE) { return false; }
+
+		sockaddr_in remote{};
+		remote.sin_family = AF_INET;
+		remote.sin_addr.s_addr = mRemoteAddress;
+		remote.sin_port = mRemotePort;
+
+		// a full send buffer is the same as a lost packet
+		return sendto(native(mSocket), reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+			reinterpret_cast<const sockaddr*>(&remote), sizeof(remote)) == static_cast<int>(size);
+	}
+
+	size_t UdpTransport::receive(uint8_t* buffer, size_t capacity) noexcept {
+
+		if (mSocket == INVALID) { return 0u; }
+
+		// skips what came from anyone else, until there is nothing left to read
+		for (;;) {
+			sockaddr_in from{};
+			SocketLength fromLength = sizeof(from);
+			const auto size = recvfrom(native(mSocket), reinterpret_cast<char*>(buffer), static_cast<int>(capacity), 0,
+				reinterpret_cast<sockaddr*>(&from), &fromLength);
+			if (size <= 0) { return 0u; }
+
+			if (from.sin_addr.s_addr == mRemoteAddress && from.sin_port == mRemotePort) {
+				return static_cast<size_t>(size);
+			}
+		}
+	}
+}
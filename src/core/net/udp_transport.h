@@ -0,0 +1,47 @@
+#ifndef UDP_TRANSPORT_H_
+#define UDP_TRANSPORT_H_
+
+#include "transport.h"
+
+namespace net {
+
+	/**
+	* A non blocking UDP socket bound to a local port, talking to one remote address. Packets from any other
+	* address are dropped
+	*/
+	class UdpTransport final : public Transport {
+	public:
+
+		UdpTransport() noexcept = default;
+		~UdpTransport() noexcept override;
+
+		UdpTransport(const UdpTransport&) = delete;
+		UdpTransport& operator=(const UdpTransport&) = delete;
+
+		/**
+		* @brief Binds the local port and resolves the remote host (a name or a dotted address)
+		* @return false if the socket could not be opened, the error is printed
+		*/
+		bool open(uint16_t localPort, const char* remoteHost, uint16_t remotePort) noexcept;
+
+		void close() noexcept;
+
+		inline bool isOpen() const noexcept {
+			return mSocket != INVALID;
+		}
+
+		bool send(const uint8_t* data, size_t size) noexcept override;
+		size_t receive(uint8_t* buffer, size_t capacity) noexcept override;
+
+	private:
+		// a SOCKET on Windows and an int everywhere else, both fit
+		static constexpr intptr_t INVALID = -1;
+
+		intptr_t mSocket{ INVALID };
+		// the remote IPv4 address and port, in network order
+		uint32_t mRemoteAddress{ 0u };
+		uint16_t mRemotePort{ 0u };
+	};
+}
+
+#endif // !UDP_TRANSPORT_H_
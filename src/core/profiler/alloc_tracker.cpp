@@ -0,0 +1,158 @@
+#include "alloc_tracker.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <vector>
+
+namespace profiler {
+
+	std::atomic<bool> gTrackAllocations{ false };
+
+	namespace {
+
+		std::atomic<uint64_t> gAllocations{ 0u };
+		std::atomic<uint64_t> gBytes{ 0u };
+
+		// trivially constructed, so touching it from operator new never allocates
+		thread_local AllocCount tAllocations{ 0u, 0u };
+	}
+
+	// called by the operators below, for every allocation of the program
+	inline void countAllocation(std::size_t size) noexcept {
+		if (!trackingAllocations()) { return; }
+
+		tAllocations.allocations++;
+		tAllocations.bytes += size;
+		gAllocations.fetch_add(1u, std::memory_order_relaxed);
+		gBytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void setAllocTracking(bool tracking) noexcept {
+		gTrackAllocations.store(tracking, std::memory_order_relaxed);
+	}
+
+	AllocCount allocations() noexcept {
+		return { gAllocations.load(std::memory_order_relaxed), gBytes.load(std::memory_order_relaxed) };
+	}
+
+	AllocCount threadAllocations() noexcept {
+		return tAllocations;
+	}
+
+	void writeAllocationReport(std::ostream& out, double threshold) {
+		const uint32_t frames = frameCount();
+		if (frames == 0u) {
+			out << "No frames recorded\n";
+			return;
+		}
+
+		AllocCount total{ 0u, 0u };
+		const Frame* worst = &getFrame(0u);
+		for (uint32_t age = 0u; age < frames; age++) {
+			const Frame& frame = getFrame(age);
+			total.allocations += frame.allocations;
+			total.bytes += frame.allocatedBytes;
+			if (frame.allocations > worst->allocations) {
+				worst = &frame;
+			}
+		}
+
+		const double perFrame = static_cast<double>(total.allocations) / frames;
+		const double bytesPerFrame = static_cast<double>(total.bytes) / frames;
+
+		out << std::fixed << std::setprecision(2);
+		out << "Allocations over the last " << frames << " frames : " << perFrame << " per frame (" << bytesPerFrame
+			<< " bytes), worst frame #" << worst->index << " with " << worst->allocations << "\n";
+
+		// the scopes' own allocations, most first
+		std::vector<ScopeStats> scopes;
+		double inScopes = 0.0;
+		for (const ScopeStats& stats : getStats()) {
+			inScopes += stats.allocations;
+			if (stats.allocations > threshold) {
+				scopes.push_back(stats);
+			}
+		}
+		std::sort(scopes.begin(), scopes.end(), [](const ScopeStats& a, const ScopeStats& b) {
+			return a.allocations > b.allocations;
+		});
+
+		const double outside = std::max(0.0, perFrame - inScopes);
+		if (scopes.empty() && outside <= threshold) {
+			out << "  No scope allocates more than " << threshold << " times per frame\n" << std::defaultfloat;
+			return;
+		}
+
+		out << "  allocs/frame  bytes/frame  scope\n";
+		for (const ScopeStats& stats : scopes) {
+			out << "  " << std::setw(12) << stats.allocations << " " << std::setw(12) << stats.allocatedBytes
+				<< "  " << stats.name << "\n";
+		}
+		if (outside > threshold) {
+			out << "  " << std::setw(12) << outside << " " << std::setw(12) << "" << "  (outside scopes)\n";
+		}
+		out << std::defaultfloat;
+	}
+}
+
+#if ENABLE_ALLOC_TRACKING
+
+namespace {
+
+	void* allocateAligned(std::size_t size, std::size_t alignment) noexcept {
+#ifdef _MSC_VER
+		return _aligned_malloc(size, alignment);
+#else
+		void* pointer = nullptr;
+		return posix_memalign(&pointer, std::max(alignment, sizeof(void*)), size) == 0 ? pointer : nullptr;
+#endif
+	}
+
+	void freeAligned(void* pointer) noexcept {
+#ifdef _MSC_VER
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+// Only the basic forms are replaced : the array and nothrow forms the standard library provides all end up calling
+// these. The sized deletes are defined as well, so they never reach the library's own
+
+void* operator new(std::size_t size) {
+	void* pointer = std::malloc(size > 0u ? size : 1u);
+	if (pointer == nullptr) { throw std::bad_alloc(); }
+
+	profiler::countAllocation(size);
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+	::operator delete(pointer);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	void* pointer = allocateAligned(size > 0u ? size : 1u, static_cast<std::size_t>(alignment));
+	if (pointer == nullptr) { throw std::bad_alloc(); }
+
+	profiler::countAllocation(size);
+	return pointer;
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+	freeAligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+	::operator delete(pointer, alignment);
+}
+
+#endif
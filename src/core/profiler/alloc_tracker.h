@@ -0,0 +1,54 @@
+#ifndef ALLOC_TRACKER_H_
+#define ALLOC_TRACKER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// 1 replaces the global operator new and delete so allocations can be counted; opt-in, since it is for every target
+// linked with it (the CMake build sets it with -DPLATFORMER_ALLOC_TRACKING=ON). 0 leaves them alone
+#ifndef ENABLE_ALLOC_TRACKING
+#define ENABLE_ALLOC_TRACKING 0
+#endif
+
+namespace profiler {
+
+	/**
+	* Heap allocations, counted while tracking is on
+	*/
+	struct AllocCount {
+		uint64_t allocations;
+		uint64_t bytes;
+	};
+
+	extern std::atomic<bool> gTrackAllocations;
+
+	inline bool trackingAllocations() noexcept {
+		return ENABLE_ALLOC_TRACKING && gTrackAllocations.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Starts or stops counting every operator new, on every thread. Off by default, an allocation costs one
+	* relaxed load while it is off, and a few atomic adds while it is on
+	*/
+	void setAllocTracking(bool tracking) noexcept;
+
+	/**
+	* @return What every thread allocated while tracking was on, since the start of the program
+	*/
+	AllocCount allocations() noexcept;
+
+	/**
+	* @return What the calling thread allocated while tracking was on, since it started
+	*/
+	AllocCount threadAllocations() noexcept;
+
+	/**
+	* @brief Writes what the frames of the history allocated, and the scopes that allocated more than threshold
+	* times per frame on average (their own allocations, not their children's), most first. What was allocated
+	* outside of any scope is listed as "(outside scopes)"
+	*/
+	void writeAllocationReport(std::ostream& out, double threshold);
+}
+
+#endif // !ALLOC_TRACKER_H_
@@ -0,0 +1,364 @@
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include "trace_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <numeric>
+
+namespace profiler {
+
+	std::atomic<bool> gEnabled{ true };
+
+	namespace {
+
+		/**
+		* The events of one thread, written only by that thread and read only by endFrame, so neither side takes a lock
+		*/
+		struct ThreadRing {
+			std::array<Event, RING_CAPACITY> events;
+			// ever increasing, the ring holds [tail, head)
+			std::atomic<uint64_t> head{ 0u };
+			std::atomic<uint64_t> tail{ 0u };
+			uint16_t index{ 0u };
+			// guarded by gRingsMutex
+			std::string name;
+		};
+
+		/**
+		* The time spent in each scope name during one frame, indices into gNames
+		*/
+		struct FrameTotal {
+			uint32_t name;
+			uint32_t calls;
+			uint64_t nanoseconds;
+			uint64_t allocations;
+			uint64_t allocatedBytes;
+		};
+
+		// only taken when a thread records its first scope, and by endFrame to walk the rings
+		std::mutex gRingsMutex;
+		std::vector<std::unique_ptr<ThreadRing>> gRings;
+		std::atomic<uint64_t> gDropped{ 0u };
+
+		// the counters sampled since the last frame, from any thread
+		std::mutex gCountersMutex;
+		std::vector<CounterSample> gCounters;
+
+		thread_local ThreadRing* tRing = nullptr;
+		thread_local uint16_t tDepth = 0u;
+		// what the thread had allocated when each of its open scopes started
+		thread_local std::array<AllocCount, MAX_ALLOC_DEPTH> tAllocStart;
+
+		// the frame history, a ring of FRAME_HISTORY frames and their totals
+		std::vector<Frame> gFrames(FRAME_HISTORY);
+		std::vector<std::vector<FrameTotal>> gTotals(FRAME_HISTORY);
+		uint32_t gNewest{ 0u };
+		uint32_t gCount{ 0u };
+		uint64_t gFrameIndex{ 0u };
+		uint64_t gLastEnd{ 0u };
+		AllocCount gLastAllocations{ 0u, 0u };
+
+		// while walking a frame's events, the open event of each thread at each depth, to take the children's
+		// allocations out of their parent's
+		std::vector<uint32_t> gOpenEvents;
+		std::vector<AllocCount> gOwnAllocations;
+
+		std::vector<const char*> gNames;
+		std::vector<ScopeStats> gStats;
+		bool gStatsDirty{ false };
+
+		// after the rings, so it is destroyed (and its thread joined) before them
+		TraceWriter gTrace;
+
+		ThreadRing& threadRing() noexcept {
+			if (tRing == nullptr) {
+				std::lock_guard<std::mutex> lock(gRingsMutex);
+				gRings.push_back(std::make_unique<ThreadRing>());
+				tRing = gRings.back().get();
+				tRing->index = static_cast<uint16_t>(gRings.size() - 1u);
+			}
+			return *tRing;
+		}
+
+		void push(ThreadRing& ring, const Event& event) noexcept {
+			const uint64_t head = ring.head.load(std::memory_order_relaxed);
+			if (head - ring.tail.load(std::memory_order_acquire) == RING_CAPACITY) {
+				gDropped.fetch_add(1u, std::memory_order_relaxed);
+				return;
+			}
+
+			ring.events[head % RING_CAPACITY] = event;
+			ring.head.store(head + 1u, std::memory_order_release);
+		}
+
+		uint32_t nameIndex(const char* name) {
+			// the same literal is usually the same pointer, the compare is for the ones merged differently
+			for (uint32_t i = 0u; i < gNames.size(); i++) {
+				if (gNames[i] == name) { return i; }
+			}
+			for (uint32_t i = 0u; i < gNames.size(); i++) {
+				if (std::strcmp(gNames[i], name) == 0) { return i; }
+			}
+			gNames.push_back(name);
+			return static_cast<uint32_t>(gNames.size() - 1u);
+		}
+
+		inline uint32_t slotOf(uint32_t age) noexcept {
+			return (gNewest + FRAME_HISTORY - age) % FRAME_HISTORY;
+		}
+	}
+
+	void setEnabled(bool enabled) noexcept {
+		gEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	uint64_t now() noexcept {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	uint64_t enter() noexcept {
+		// the counts only move while tracking, so they are read either way
+		if (tDepth < MAX_ALLOC_DEPTH) {
+			tAllocStart[tDepth] = threadAllocations();
+		}
+		tDepth++;
+		return now();
+	}
+
+	void leave(const char* name, uint64_t start) noexcept {
+		const uint64_t end = now();
+		tDepth--;
+
+		AllocCount allocated{ 0u, 0u };
+		if (tDepth < MAX_ALLOC_DEPTH) {
+			const AllocCount current = threadAllocations();
+			allocated = { current.allocations - tAllocStart[tDepth].allocations, current.bytes - tAllocStart[tDepth].bytes };
+		}
+
+		ThreadRing& ring = threadRing();
+		push(ring, Event{ name, start, end, ring.index, tDepth, static_cast<uint32_t>(allocated.allocations),
+			static_cast<uint32_t>(allocated.bytes) });
+	}
+
+	uint16_t createTrack(const std::string& name) {
+		std::lock_guard<std::mutex> lock(gRingsMutex);
+		gRings.push_back(std::make_unique<ThreadRing>());
+		gRings.back()->index = static_cast<uint16_t>(gRings.size() - 1u);
+		gRings.back()->name = name;
+		return gRings.back()->index;
+	}
+
+	void record(uint16_t track, const char* name, uint64_t start, uint64_t end, uint16_t depth) noexcept {
+		if (!enabled()) { return; }
+
+		ThreadRing* ring;
+		{
+			std::lock_guard<std::mutex> lock(gRingsMutex);
+			if (track >= gRings.size()) { return; }
+			ring = gRings[track].get();
+		}
+		push(*ring, Event{ name, start, end, track, depth, 0u, 0u });
+	}
+
+	void counter(const char* name, double value) noexcept {
+		if (!enabled()) { return; }
+
+		const uint64_t time = now();
+		std::lock_guard<std::mutex> lock(gCountersMutex);
+		gCounters.push_back({ name, time, value });
+	}
+
+	void setThreadName(const std::string& name) {
+		ThreadRing& ring = threadRing();
+		std::lock_guard<std::mutex> lock(gRingsMutex);
+		ring.name = name;
+	}
+
+	std::string getThreadName(uint16_t thread) {
+		std::lock_guard<std::mutex> lock(gRingsMutex);
+		if (thread < gRings.size() && !gRings[thread]->name.empty()) {
+			return gRings[thread]->name;
+		}
+		return "thread " + std::to_string(thread);
+	}
+
+	void endFrame() noexcept {
+		const uint64_t end = now();
+
+		const uint32_t slot = gCount == 0u ? 0u : (gNewest + 1u) % FRAME_HISTORY;
+		Frame& frame = gFrames[slot];
+		frame.index = gFrameIndex++;
+		frame.start = gLastEnd != 0u ? gLastEnd : end;
+		frame.end = end;
+		frame.events.clear();
+
+		const AllocCount allocated = allocations();
+		frame.allocations = allocated.allocations - gLastAllocations.allocations;
+		frame.allocatedBytes = allocated.bytes - gLastAllocations.bytes;
+		gLastAllocations = allocated;
+
+		uint32_t threads = 0u;
+		{
+			std::lock_guard<std::mutex> lock(gRingsMutex);
+			threads = static_cast<uint32_t>(gRings.size());
+			for (const std::unique_ptr<ThreadRing>& ring : gRings) {
+				const uint64_t head = ring->head.load(std::memory_order_acquire);
+				for (uint64_t e = ring->tail.load(std::memory_order_relaxed); e < head; e++) {
+					frame.events.push_back(ring->events[e % RING_CAPACITY]);
+				}
+				ring->tail.store(head, std::memory_order_release);
+			}
+		}
+
+		{
+			// copied rather than swapped, the frame's buffer came from 300 frames ago and sampling a counter must not
+			// have to grow it again
+			std::lock_guard<std::mutex> lock(gCountersMutex);
+			frame.counters.assign(gCounters.begin(), gCounters.end());
+			gCounters.clear();
+		}
+
+		// the first frame only has what was recorded before it
+		if (gLastEnd == 0u) {
+			for (const Event& event : frame.events) {
+				frame.start = std::min(frame.start, event.start);
+			}
+		}
+		gLastEnd = end;
+
+		// outer scopes close last, sorted by start they are in the order they were opened
+		std::sort(frame.events.begin(), frame.events.end(), [](const Event& a, const Event& b) {
+			return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+		});
+
+		// what each event allocated itself, its allocations minus its children's. In start order a thread's parent
+		// event is the last one seen one level up (none when it was recorded in an earlier frame)
+		gOpenEvents.resize(std::max<size_t>(gOpenEvents.size(), threads * MAX_ALLOC_DEPTH));
+		std::fill(gOpenEvents.begin(), gOpenEvents.end(), UINT32_MAX);
+		gOwnAllocations.resize(std::max(gOwnAllocations.size(), frame.events.size()));
+		for (uint32_t e = 0u; e < frame.events.size(); e++) {
+			const Event& event = frame.events[e];
+			gOwnAllocations[e] = { event.allocations, event.allocatedBytes };
+			if (event.depth >= MAX_ALLOC_DEPTH || event.thread >= threads) { continue; }
+
+			uint32_t* open = &gOpenEvents[event.thread * MAX_ALLOC_DEPTH];
+			open[event.depth] = e;
+			if (event.depth > 0u && open[event.depth - 1u] != UINT32_MAX) {
+				AllocCount& parent = gOwnAllocations[open[event.depth - 1u]];
+				parent.allocations -= std::min<uint64_t>(parent.allocations, event.allocations);
+				parent.bytes -= std::min<uint64_t>(parent.bytes, event.allocatedBytes);
+			}
+		}
+
+		// what each scope name added up to, for the stats
+		std::vector<FrameTotal>& totals = gTotals[slot];
+		totals.clear();
+		for (uint32_t e = 0u; e < frame.events.size(); e++) {
+			const Event& event = frame.events[e];
+			const uint32_t name = nameIndex(event.name);
+			auto total = std::find_if(totals.begin(), totals.end(), [name](const FrameTotal& t) { return t.name == name; });
+			if (total == totals.end()) {
+				totals.push_back({ name, 0u, 0u, 0u, 0u });
+				total = totals.end() - 1;
+			}
+			total->calls++;
+			total->nanoseconds += event.end - event.start;
+			total->allocations += gOwnAllocations[e].allocations;
+			total->allocatedBytes += gOwnAllocations[e].bytes;
+		}
+
+		gNewest = slot;
+		gCount = std::min(gCount + 1u, FRAME_HISTORY);
+		gStatsDirty = true;
+
+		gTrace.push(frame);
+	}
+
+	bool startCapture(const std::string& path, uint32_t frames) {
+		return gTrace.open(path, frames);
+	}
+
+	void stopCapture() noexcept {
+		gTrace.close();
+	}
+
+	bool capturing() noexcept {
+		return gTrace.capturing();
+	}
+
+	void clearHistory() noexcept {
+		gCount = 0u;
+		gNewest = 0u;
+		gNames.clear();
+		gStats.clear();
+		gStatsDirty = false;
+	}
+
+	uint32_t frameCount() noexcept {
+		return gCount;
+	}
+
+	const Frame& getFrame(uint32_t age) noexcept {
+		return gFrames[slotOf(std::min(age, gCount > 0u ? gCount - 1u : 0u))];
+	}
+
+	std::vector<uint32_t> worstFrames(uint32_t count) {
+		std::vector<uint32_t> ages(gCount);
+		std::iota(ages.begin(), ages.end(), 0u);
+
+		count = std::min(count, gCount);
+		std::partial_sort(ages.begin(), ages.begin() + count, ages.end(), [](uint32_t a, uint32_t b) {
+			const Frame& fa = getFrame(a);
+			const Frame& fb = getFrame(b);
+			return fa.end - fa.start > fb.end - fb.start;
+		});
+		ages.resize(count);
+		return ages;
+	}
+
+	const std::vector<ScopeStats>& getStats() noexcept {
+		if (!gStatsDirty || gCount == 0u) { return gStats; }
+		gStatsDirty = false;
+
+		gStats.assign(gNames.size(), ScopeStats{ nullptr, 0.0, 0.0, 0.0, 0.0, 0.0 });
+		for (uint32_t i = 0u; i < gNames.size(); i++) {
+			gStats[i].name = gNames[i];
+		}
+
+		for (uint32_t age = 0u; age < gCount; age++) {
+			for (const FrameTotal& total : gTotals[slotOf(age)]) {
+				ScopeStats& stats = gStats[total.name];
+				const double ms = static_cast<double>(total.nanoseconds) / 1e6;
+				stats.averageMs += ms;
+				stats.worstMs = std::max(stats.worstMs, ms);
+				stats.calls += total.calls;
+				stats.allocations += static_cast<double>(total.allocations);
+				stats.allocatedBytes += static_cast<double>(total.allocatedBytes);
+			}
+		}
+
+		// a scope missing from a frame took 0 ms in it
+		for (ScopeStats& stats : gStats) {
+			stats.averageMs /= gCount;
+			stats.calls /= gCount;
+			stats.allocations /= gCount;
+			stats.allocatedBytes /= gCount;
+		}
+		return gStats;
+	}
+
+	uint32_t threadCount() noexcept {
+		std::lock_guard<std::mutex> lock(gRingsMutex);
+		return static_cast<uint32_t>(gRings.size());
+	}
+
+	uint64_t getDroppedCount() noexcept {
+		return gDropped.load(std::memory_order_relaxed);
+	}
+}
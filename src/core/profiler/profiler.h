@@ -0,0 +1,235 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 0 compiles every PROFILE_SCOPE out, nothing is timed or recorded
+#ifndef ENABLE_PROFILER
+#define ENABLE_PROFILER 1
+#endif
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#if ENABLE_PROFILER
+/**
+* Times the rest of the enclosing block. The name must be a string literal (only the pointer is kept), and scopes
+* with the same name are added up in the stats
+*/
+#define PROFILE_SCOPE(name) profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+/**
+* Samples a value into the frame, shown as a counter track in captured traces. The name must be a string literal
+*/
+#define PROFILE_COUNTER(name, value) profiler::counter(name, static_cast<double>(value))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#endif
+
+namespace profiler {
+
+	/**
+	* One timed scope, in nanoseconds of the steady clock
+	*/
+	struct Event {
+		const char* name;
+		uint64_t start;
+		uint64_t end;
+		// the order the thread first recorded something (or was named) in, see getThreadName
+		uint16_t thread;
+		// how many scopes of the same thread it is nested in
+		uint16_t depth;
+		// what the thread allocated from its start to its end (its children's included), while tracking allocations
+		uint32_t allocations;
+		uint32_t allocatedBytes;
+	};
+
+	/**
+	* One value of a counter, at the time it was sampled
+	*/
+	struct CounterSample {
+		const char* name;
+		uint64_t time;
+		double value;
+	};
+
+	/**
+	* Everything recorded between two calls to endFrame
+	*/
+	struct Frame {
+		uint64_t index;
+		uint64_t start;
+		uint64_t end;
+		std::vector<Event> events;
+		std::vector<CounterSample> counters;
+		// what every thread allocated since the last frame, while tracking allocations
+		uint64_t allocations;
+		uint64_t allocatedBytes;
+
+		inline double milliseconds() const noexcept {
+			return static_cast<double>(end - start) / 1e6;
+		}
+	};
+
+	/**
+	* The time spent in one scope name per frame (every call on every thread added up), over the frame history
+	*/
+	struct ScopeStats {
+		const char* name;
+		double averageMs;
+		double worstMs;
+		// calls per frame, on average
+		double calls;
+		// what the scope allocated itself per frame (its children's left out), on average
+		double allocations;
+		double allocatedBytes;
+	};
+
+	// the frames kept for the stats and the panel, 5 seconds at 60 Hz
+	static constexpr uint32_t FRAME_HISTORY = 300u;
+	// the events a thread can record in a frame, the rest are dropped
+	static constexpr uint32_t RING_CAPACITY = 8192u;
+	// scopes nested deeper than this are recorded without their allocations
+	static constexpr uint32_t MAX_ALLOC_DEPTH = 32u;
+
+	extern std::atomic<bool> gEnabled;
+
+	inline bool enabled() noexcept {
+		return gEnabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	* @brief Starts or stops recording, scopes cost one relaxed load while it is stopped
+	*/
+	void setEnabled(bool enabled) noexcept;
+
+	/**
+	* @return The steady clock, in nanoseconds
+	*/
+	uint64_t now() noexcept;
+
+	/**
+	* @brief Opens a scope on the calling thread
+	* @return Its start
+	*/
+	uint64_t enter() noexcept;
+
+	/**
+	* @brief Closes the calling thread's innermost scope, writing it into the thread's ring
+	*/
+	void leave(const char* name, uint64_t start) noexcept;
+
+	/**
+	* @brief Makes a track for events timed some other way than by a thread's scopes (the GPU's passes), shown like
+	* a thread of its own
+	* @return The track, an Event thread index
+	*/
+	uint16_t createTrack(const std::string& name);
+
+	/**
+	* @brief Records an event on a track. A track must only be recorded into from one thread
+	* @param start, end - On the steady clock, in nanoseconds (see now)
+	*/
+	void record(uint16_t track, const char* name, uint64_t start, uint64_t end, uint16_t depth) noexcept;
+
+	/**
+	* @brief Samples a counter, from any thread
+	*/
+	void counter(const char* name, double value) noexcept;
+
+	/**
+	* @brief Names the calling thread in captured traces, threads are called "thread N" otherwise
+	*/
+	void setThreadName(const std::string& name);
+
+	/**
+	* @param thread - An Event's thread
+	*/
+	std::string getThreadName(uint16_t thread);
+
+	/**
+	* @brief Closes the frame : collects what every thread recorded since the last call, updates the stats, and hands
+	* the frame to the capture if there is one. Call once per frame, from the thread that reads the history
+	*/
+	void endFrame() noexcept;
+
+	/**
+	* @brief Starts writing the next frames into a Chrome trace event file (see TraceWriter), ending any capture
+	* already running. Scopes are only recorded while the profiler is enabled
+	* @param frames - The number of frames to capture, 0 captures until stopCapture (or the end of the program)
+	* @return false if the file could not be created
+	*/
+	bool startCapture(const std::string& path, uint32_t frames = 0u);
+
+	/**
+	* @brief Ends the capture, waiting for what is left of it to be written
+	*/
+	void stopCapture() noexcept;
+
+	/**
+	* @return true while frames are being captured
+	*/
+	bool capturing() noexcept;
+
+	/**
+	* @brief Forgets every frame and stat, what the threads are recording is kept for the next frame
+	*/
+	void clearHistory() noexcept;
+
+	/**
+	* @return The frames in the history
+	*/
+	uint32_t frameCount() noexcept;
+
+	/**
+	* @param age - 0 for the last frame, up to frameCount() - 1 for the oldest
+	*/
+	const Frame& getFrame(uint32_t age) noexcept;
+
+	/**
+	* @return The ages of the longest frames in the history, longest first
+	*/
+	std::vector<uint32_t> worstFrames(uint32_t count);
+
+	/**
+	* @return Every scope name seen in the history, in the order they were first seen
+	*/
+	const std::vector<ScopeStats>& getStats() noexcept;
+
+	/**
+	* @return The number of threads that ever recorded a scope
+	*/
+	uint32_t threadCount() noexcept;
+
+	/**
+	* @return The events dropped because a thread's ring was full
+	*/
+	uint64_t getDroppedCount() noexcept;
+
+	/**
+	* Records the time from its construction to its destruction, through PROFILE_SCOPE
+	*/
+	class Scope final {
+	public:
+
+		explicit Scope(const char* name) noexcept : mName(enabled() ? name : nullptr) {
+			if (mName != nullptr) { mStart = enter(); }
+		}
+
+		~Scope() noexcept {
+			if (mName != nullptr) { leave(mName, mStart); }
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* mName;
+		uint64_t mStart{ 0u };
+	};
+}
+
+#endif // !PROFILER_H_
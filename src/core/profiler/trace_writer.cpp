@@ -0,0 +1,196 @@
+#include "trace_writer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace profiler {
+
+	namespace {
+
+		void appendString(std::string& out, const char* text) {
+			out += '"';
+			for (const char* c = text; *c != '\0'; c++) {
+				if (*c == '"' || *c == '\\') {
+					out += '\\';
+					out += *c;
+				}
+				else if (static_cast<unsigned char>(*c) < 0x20u) {
+					out += ' ';
+				}
+				else {
+					out += *c;
+				}
+			}
+			out += '"';
+		}
+
+		// trace timestamps are in microseconds
+		inline double micros(uint64_t time, uint64_t base) noexcept {
+			return time >= base ? static_cast<double>(time - base) / 1e3 : -static_cast<double>(base - time) / 1e3;
+		}
+	}
+
+	TraceWriter::~TraceWriter() noexcept {
+		close();
+	}
+
+	bool TraceWriter::open(const std::string& path, uint32_t frames) {
+		close();
+
+		mFile.open(path, std::ios::binary | std::ios::trunc);
+		if (!mFile.is_open()) { return false; }
+
+		mFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		mFirstEvent = true;
+		mBase = 0u;
+		mNamed.clear();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFramesLeft = frames > 0u ? frames : UINT32_MAX;
+			mStop = false;
+		}
+		mThread = std::thread(&TraceWriter::run, this);
+		return true;
+	}
+
+	bool TraceWriter::push(const Frame& frame) {
+		std::unique_ptr<Frame> copy;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			if (mFramesLeft == 0u || mStop) { return false; }
+			if (mQueue.size() >= MAX_QUEUED) {
+				PROFILE_SCOPE("trace stall");
+				mRoom.wait(lock, [this]() { return mQueue.size() < MAX_QUEUED; });
+			}
+			if (!mFree.empty()) {
+				copy = std::move(mFree.back());
+				mFree.pop_back();
+			}
+		}
+
+		// the copy is made outside of the lock, the writing thread never sees this buffer until it is queued
+		if (copy == nullptr) {
+			copy = std::make_unique<Frame>();
+		}
+		*copy = frame;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQueue.push_back(std::move(copy));
+			if (mFramesLeft != UINT32_MAX) {
+				mFramesLeft--;
+			}
+		}
+		mWake.notify_one();
+		return true;
+	}
+
+	void TraceWriter::close() noexcept {
+		if (!mThread.joinable()) { return; }
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mWake.notify_one();
+		mThread.join();
+	}
+
+	bool TraceWriter::capturing() noexcept {
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mThread.joinable() && mFramesLeft > 0u && !mStop;
+	}
+
+	void TraceWriter::run() noexcept {
+		std::unique_lock<std::mutex> lock(mMutex);
+		for (;;) {
+			mWake.wait(lock, [this]() { return mStop || mFramesLeft == 0u || !mQueue.empty(); });
+
+			if (!mQueue.empty()) {
+				std::unique_ptr<Frame> frame = std::move(mQueue.front());
+				mQueue.pop_front();
+				mRoom.notify_one();
+
+				lock.unlock();
+				writeFrame(*frame);
+				lock.lock();
+
+				mFree.push_back(std::move(frame));
+				continue;
+			}
+
+			// everything queued is written
+			if (mStop || mFramesLeft == 0u) { break; }
+		}
+		lock.unlock();
+
+		mFile << "\n]}\n";
+		mFile.close();
+	}
+
+	void TraceWriter::writeFrame(const Frame& frame) {
+		mText.clear();
+
+		auto separate = [this]() {
+			if (!mFirstEvent) { mText += ",\n"; }
+			mFirstEvent = false;
+		};
+
+		// the trace starts at 0 with the first frame
+		if (mBase == 0u) {
+			mBase = frame.start;
+			for (const Event& event : frame.events) {
+				mBase = std::min(mBase, event.start);
+			}
+		}
+
+		char buffer[160];
+
+		for (const Event& event : frame.events) {
+			if (event.thread >= mNamed.size()) {
+				mNamed.resize(event.thread + 1u, false);
+			}
+			if (!mNamed[event.thread]) {
+				mNamed[event.thread] = true;
+				separate();
+				std::snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+					static_cast<unsigned>(event.thread));
+				mText += buffer;
+				appendString(mText, getThreadName(event.thread).c_str());
+				mText += "}}";
+			}
+		}
+
+		separate();
+		std::snprintf(buffer, sizeof(buffer), "{\"name\":\"frame %llu\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%.3f}",
+			static_cast<unsigned long long>(frame.index), micros(frame.start, mBase));
+		mText += buffer;
+
+		for (const Event& event : frame.events) {
+			separate();
+			mText += "{\"name\":";
+			appendString(mText, event.name);
+			std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+				static_cast<unsigned>(event.thread), micros(event.start, mBase), static_cast<double>(event.end - event.start) / 1e3);
+			mText += buffer;
+			if (event.allocations > 0u) {
+				std::snprintf(buffer, sizeof(buffer), ",\"args\":{\"allocations\":%u,\"bytes\":%u}",
+					static_cast<unsigned>(event.allocations), static_cast<unsigned>(event.allocatedBytes));
+				mText += buffer;
+			}
+			mText += '}';
+		}
+
+		for (const CounterSample& sample : frame.counters) {
+			separate();
+			mText += "{\"name\":";
+			appendString(mText, sample.name);
+			std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"C\",\"pid\":1,\"tid\":0,\"ts\":%.3f,\"args\":{\"value\":%.17g}}",
+				micros(sample.time, mBase), sample.value);
+			mText += buffer;
+		}
+
+		mFile.write(mText.data(), static_cast<std::streamsize>(mText.size()));
+	}
+}
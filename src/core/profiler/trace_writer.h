@@ -0,0 +1,89 @@
+#ifndef TRACE_WRITER_H_
+#define TRACE_WRITER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "profiler.h"
+
+namespace profiler {
+
+	/**
+	* Streams frames into a Chrome trace event JSON file, which chrome://tracing and ui.perfetto.dev open : a complete
+	* event per scope on the track of its thread, a counter track per counter, and an instant event marking the start
+	* of every frame.
+	*
+	* The frames are copied into a queue and formatted and written by a thread of its own, so the frame loop only
+	* pays for the copy. Queued frames are recycled, nothing is allocated once the queue has been as deep as it gets.
+	* No frame is ever dropped : when MAX_QUEUED frames are waiting (frames much shorter than writing them, like a
+	* headless replay), push waits for room, and the wait shows up in the trace as a "trace stall" scope
+	*/
+	class TraceWriter final {
+	public:
+
+		static constexpr uint32_t MAX_QUEUED = 120u;
+
+		TraceWriter() = default;
+		~TraceWriter() noexcept;
+
+		TraceWriter(const TraceWriter&) = delete;
+		TraceWriter& operator=(const TraceWriter&) = delete;
+
+		/**
+		* @brief Creates the file and starts the writing thread, closing the last capture first
+		* @param frames - The frames to write before the file is ended, 0 for every frame until close
+		* @return false if the file could not be created
+		*/
+		bool open(const std::string& path, uint32_t frames);
+
+		/**
+		* @brief Queues a copy of the frame to be written
+		* @return false if the capture does not want any more frames
+		*/
+		bool push(const Frame& frame);
+
+		/**
+		* @brief Writes what is still queued, ends the file and joins the writing thread
+		*/
+		void close() noexcept;
+
+		/**
+		* @return true while the capture wants frames
+		*/
+		bool capturing() noexcept;
+
+	private:
+
+		void run() noexcept;
+		void writeFrame(const Frame& frame);
+
+		std::ofstream mFile;
+		std::thread mThread;
+
+		// guards everything below, shared with the writing thread
+		std::mutex mMutex;
+		std::condition_variable mWake;
+		// signaled whenever the writing thread takes a frame off the queue
+		std::condition_variable mRoom;
+		std::deque<std::unique_ptr<Frame>> mQueue;
+		std::vector<std::unique_ptr<Frame>> mFree;
+		// the frames still wanted, UINT32_MAX until close
+		uint32_t mFramesLeft{ 0u };
+		bool mStop{ false };
+
+		// only touched by the writing thread
+		std::string mText;
+		std::vector<bool> mNamed;
+		uint64_t mBase{ 0u };
+		bool mFirstEvent{ true };
+	};
+}
+
+#endif // !TRACE_WRITER_H_
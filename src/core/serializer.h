@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include <fstream>
+#include <vector>
 
 namespace serializer {
 
@@ -12,7 +13,10 @@ namespace serializer {
 		// file meta data and constants
 		static char FILE_IDENTITY__[4] = "LVL";
 		static uint32_t FILE_IDENTITY = *(uint32_t*)&FILE_IDENTITY__;
-		static constexpr uint32_t FILE_VERSION = 1UL;
+		// version 1 : tiles stored row major
+		// version 2 : tiles stored column major, the same order they are in memory
+		// version 3 : the entities are stored after their count, as EntityRecords
+		static constexpr uint32_t FILE_VERSION = 3UL;
 
 		// disable padding
 		#pragma pack(1)
@@ -48,10 +52,48 @@ namespace serializer {
 
 		static_assert(sizeof(EntityDataHeader) == 4);
 
+		// An entity as it is spawned, its type's kernel sets up the rest
+		struct EntityRecord {
+			uint32_t type;
+			float x;
+			float y;
+		};
+
+		static_assert(sizeof(EntityRecord) == 12);
+
 		// enable padding again
 		#pragma pack()
 	}
 
+	namespace detail {
+
+		// Writes the height tiles of one column, each as a 32 bit value; packed is scratch space
+		static void writeColumn(std::ofstream* out, const Tile* column, int height, std::vector<uint32_t>& packed) noexcept {
+			packed.resize(height);
+			for (int j = 0; j < height; j++) { // y
+				packed[j] = column[j].mData;
+			}
+			out->write((char*)packed.data(), height * sizeof(uint32_t));
+		}
+
+		static void writeTiles(std::ofstream* out, Level* fromLevel) noexcept {
+
+			TileDataHeader tileDataHeader {};
+			tileDataHeader.width = fromLevel->width;
+			tileDataHeader.height = fromLevel->height;
+
+			out->write((char*)&tileDataHeader, sizeof(detail::TileDataHeader));
+			out->flush();
+			
+			// walk the tiles in memory order, one column at a time
+			std::vector<uint32_t> packed;
+			for (int i = 0; i < fromLevel->width; i++) { // x
+				writeColumn(out, fromLevel->getTileColumn(i), fromLevel->height, packed);
+			}
+			out->flush();
+		}
+	}
+
 	/**
 	* Load a level from a file
 	* @param intoScene - The level to be loaded into
@@ -75,20 +117,50 @@ namespace serializer {
 			detail::TileDataHeader tileDataHeader; // create and read
 			in.read((char*)&tileDataHeader, sizeof(detail::TileDataHeader));
 
-			intoLevel->width = tileDataHeader.width;
-			intoLevel->height = tileDataHeader.height;
-			//intoLevel->allocateForTileData();
+			// the tiles must fit in an int each way and in what is left of the file, before anything is allocated for them
+			const int width = static_cast<int>(tileDataHeader.width);
+			const int height = static_cast<int>(tileDataHeader.height);
+			const std::streampos tilesStart = in.tellg();
+			in.seekg(0, std::ios::end);
+			const std::streamoff remaining = in.tellg() - tilesStart;
+			in.seekg(tilesStart);
+			if (!in || width <= 0 || height <= 0
+				|| static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * sizeof(uint32_t) > static_cast<uint64_t>(remaining)) {
+				std::cerr << "Invalid level size " << width << " x " << height << " in " << fromFile << std::endl;
+				return -1;
+			}
 
-			in.read((char*)&intoLevel->tileData[0], sizeof(uint32_t) * tileDataHeader.width * tileDataHeader.height);
+			intoLevel->resizeTiles(width, height);
+
+			// Tiles are stored as 32 bit values on disk, the low 16 bits are the packed tile
+			const bool columnMajor = fileHeader.version >= 2UL;
+			const int outer = columnMajor ? intoLevel->width : intoLevel->height;
+			const int inner = columnMajor ? intoLevel->height : intoLevel->width;
+			std::vector<uint32_t> packed(inner);
+			for (int i = 0; i < outer; i++) {
+				in.read((char*)packed.data(), inner * sizeof(uint32_t));
+				for (int j = 0; j < inner; j++) {
+					Tile tile;
+					tile.mData = static_cast<uint16_t>(packed[j]);
+					if (columnMajor) { intoLevel->addTile(tile, i, j); }
+					else { intoLevel->addTile(tile, j, i); }
+				}
+			}
 
 			// Read the entity data into the level
 			detail::EntityDataHeader entityDataHeader; // create and read
 			in.read((char*)&entityDataHeader, sizeof(detail::EntityDataHeader));
 
-			intoLevel->entityCount = entityDataHeader.count;
-			//intoLevel->allocateForEntityData();
-
-			//in.read((char*)&intoLevel->entityData[0], sizeof(Entity) * entityDataHeader.count);
+			// older files only have the count, the level keeps its entities
+			if (fileHeader.version >= 3UL) {
+				intoLevel->entities.clear();
+				for (uint32_t i = 0u; i < entityDataHeader.count && in; i++) {
+					detail::EntityRecord record;
+					in.read((char*)&record, sizeof(detail::EntityRecord));
+					if (record.type == 0u || record.type >= ENTITY_TYPE_COUNT) { continue; }
+					intoLevel->addEntity(static_cast<EntityType>(record.type), { record.x, record.y });
+				}
+			}
 
 			in.close();
 
@@ -124,10 +196,9 @@ namespace serializer {
 		out.flush();
 
 
-		// Write all tiles
+		// Write the tile data header and all tiles
 		// Each tile should be an unsigned integer
-		out.write((char*)&fromLevel->tileData[0], sizeof(uint32_t) * fromLevel->width * fromLevel->height);
-		out.flush();
+		detail::writeTiles(&out, fromLevel);
 		
 		// Write all tile entities
 		detail::TileEntityDataHeader tileEntityDataHeader;
@@ -135,18 +206,21 @@ namespace serializer {
 
 		//out.write((char*)&tileEntityDataHeader, );
 
-		// Write all entities
+		// Create and write the entity data header, then every living entity
+		std::vector<detail::EntityRecord> records;
+		records.reserve(fromLevel->getEntityCount());
+		fromLevel->entities.forEachBlock([&records](EntityBlock& block) {
+			for (uint32_t i = 0u; i < block.size(); i++) {
+				if (!block.alive(i)) { continue; }
+				records.push_back({ static_cast<uint32_t>(block.type), block.position[i].x, block.position[i].y });
+			}
+		});
 
-		
-		// Create and write the entity data header to file and flush
 		detail::EntityDataHeader entityDataHeader;
-		entityDataHeader.count = fromLevel->entityCount;
+		entityDataHeader.count = static_cast<uint32_t>(records.size());
 
 		out.write((char*)&entityDataHeader, sizeof(detail::EntityDataHeader));
-		out.flush();
-
-		// Write the entities to file and flush
-		//out.write((char*)&fromLevel->entityData[0], sizeof(Entity) * fromLevel->entityCount);
+		out.write((char*)records.data(), records.size() * sizeof(detail::EntityRecord));
 		out.flush();
 
 		// close the file here
@@ -154,30 +228,6 @@ namespace serializer {
 
 		return 0;
 	}
-
-
-
-	namespace detail {
-
-		static void writeTiles(std::ofstream* out, Level* fromLevel) noexcept {
-
-			TileDataHeader tileDataHeader {};
-			tileDataHeader.width = fromLevel->width;
-			tileDataHeader.height = fromLevel->height;
-
-			out->write((char*)&tileDataHeader, sizeof(detail::TileDataHeader));
-			out->flush();
-			
-			for (int i = 0; i < fromLevel->width; i++) { // x
-				for (int j = 0; j < fromLevel->width; j++) { // y
-					//out->write((char*)&fromLevel->getTile(i, j), sizeof(uint32_t));
-				}
-				out->flush(); // flush after every vertical layer
-			}
-
-
-		}
-	}
 }
 
 #endif // !SERIALIZER_H_
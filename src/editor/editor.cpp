@@ -1,8 +1,8 @@
 #include "editor.h"
 
 Editor::Editor(Application* application) : mApplication(application), shouldDrawGrid(true), shouldDrawColliders(false), shouldDrawSelector(true),
-shouldDrawSettings(true), shouldLimitFramerate(true), mSaveState(SaveState::NEW), mCurrentSelection(0), mCurrentSelectionType(0), mMouseLeftHeld(false),
-mMouseRightHeld(false), mMouseMiddleHeld(false), mCameraPanSpeed(1.0), mActive(false), mLevel(nullptr)
+shouldDrawSettings(true), shouldLimitFramerate(true), shouldDrawProfiler(false), mSaveState(SaveState::NEW), mProfilerFrame(UINT64_MAX), mCaptureFrames(300), mAllocBudget(0), mCurrentSelection(0), mCurrentSelectionType(0), mMouseLeftHeld(false),
+mMouseRightHeld(false), mMouseMiddleHeld(false), mCameraPanSpeed(1.0), mActive(false), mLevel(nullptr), mFileBrowser(".lvl", "levels")
 {
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
@@ -34,8 +34,8 @@ mMouseRightHeld(false), mMouseMiddleHeld(false), mCameraPanSpeed(1.0), mActive(f
 	mTypeNames = new std::string [mTypeCount];
 	mTypeCounts = new int[mTypeCount];
 	for (auto it = editorConfig["type_names_counts"].begin(); it != editorConfig["type_names_counts"].end(); it++) {
-		mTypeNames[it.value()["id"]] = it.value()["name"];
-		mTypeCounts[it.value()["id"]] = it.value()["count"];
+		mTypeNames[it.value()["id"].get<int>()] = it.value()["name"];
+		mTypeCounts[it.value()["id"].get<int>()] = it.value()["count"];
 	}
 
 	// Set up the selections
@@ -59,7 +59,7 @@ mMouseRightHeld(false), mMouseMiddleHeld(false), mCameraPanSpeed(1.0), mActive(f
 				it.value()["w"],
 				it.value()["h"]);
 
-			mSelections[typeIdx][it.value()["id"]] = selection;
+			mSelections[typeIdx][it.value()["id"].get<int>()] = selection;
 		}
 	}
 }
@@ -83,6 +83,8 @@ Editor::~Editor()
 
 void Editor::draw() noexcept
 {
+	PROFILE_SCOPE("Editor::draw");
+
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -113,8 +115,8 @@ void Editor::draw() noexcept
 
 	if (shouldDrawColliders) {
 		mApplication->mLineRenderer->clear();
-		for (auto i = 0; i < mLevel->entityCount; i++) {
-			mLevel->getEntity(i)->drawCollider(mApplication->mLineRenderer);
+		for (uint32_t i = 0u; i < mLevel->getEntityCount(); i++) {
+			mLevel->getEntity(i).drawCollider(mApplication->mLineRenderer);
 		}
 		mApplication->mLineRenderer->render(mCamera);
 	}
@@ -123,6 +125,10 @@ void Editor::draw() noexcept
 		drawSelectionMenu();
 	}
 
+	if (shouldDrawProfiler) {
+		drawProfiler();
+	}
+
 	if (mMouseLeftHeld) {
 
 		glm::ivec2 pos = getCursorToWorldCoords();
@@ -144,19 +150,19 @@ void Editor::draw() noexcept
 			case SelectionType::TILE:
 				switch (mCurrentSelection) {
 				case TileSelection::CLOUD:
-					mLevel->addTile(Tile(true, mApplication->mRenderer->getSpriteID("cloud")), pos.x, pos.y);
+					mLevel->addTile(Tile(true, Sprites::CLOUD), pos.x, pos.y);
 					break;
 				case TileSelection::FENCE:
-					mLevel->addTile(Tile(false, mApplication->mRenderer->getSpriteID("fence")), pos.x, pos.y);
+					mLevel->addTile(Tile(false, Sprites::FENCE), pos.x, pos.y);
 					break;
 				case TileSelection::GROUND:
-					mLevel->addTile(Tile(true, mApplication->mRenderer->getSpriteID("ground_1")), pos.x, pos.y);
+					mLevel->addTile(Tile(true, Sprites::GROUND_1), pos.x, pos.y);
 					break;
 				case TileSelection::GROUND_2:
-					mLevel->addTile(Tile(true, mApplication->mRenderer->getSpriteID("ground_2")), pos.x, pos.y);
+					mLevel->addTile(Tile(true, Sprites::GROUND_2), pos.x, pos.y);
 					break;
 				case TileSelection::WATER:
-					mLevel->addTile(Tile(false, mApplication->mRenderer->getSpriteID("water")), pos.x, pos.y);
+					mLevel->addTile(Tile(false, Sprites::WATER), pos.x, pos.y);
 					break;
 				default:
 					std::cerr << "Invalid Tile Selection!\n";
@@ -228,7 +234,7 @@ void Editor::draw() noexcept
 				updateWindowTitle();
 			}
 
-			mLevel->addTile(Tile(false, mApplication->mRenderer->getSpriteID("none")), pos.x, pos.y);
+			mLevel->addTile(Tile(false, Sprites::NONE), pos.x, pos.y);
 		}
 	}
 	if (mMouseMiddleHeld) {
@@ -239,7 +245,10 @@ void Editor::draw() noexcept
 	}
 
 	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	{
+		GpuPass pass(&mApplication->mRenderer->getGpuTimer(), "GPU ImGui");
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	}
 }
 
 void Editor::onMouseEvent(GLFWwindow* window, int button, int action, int bits) noexcept {
@@ -394,23 +403,6 @@ void Editor::drawSelectionMenu() noexcept
 	ImGui::End();
 }
 
-static const auto getOpenFileName = [](GLFWwindow* parentWindow)->OPENFILENAMEA
-{
-	// open a file menu and prompt user to create a file to save into
-	OPENFILENAMEA ofn;
-	CHAR szFile[255] = { 0 };
-	ZeroMemory(&ofn, sizeof(OPENFILENAME));
-	ofn.lStructSize = sizeof(OPENFILENAME);
-	ofn.hwndOwner = glfwGetWin32Window(parentWindow);
-	ofn.lpstrFile = szFile;
-	ofn.nMaxFile = sizeof(szFile);
-	ofn.nFilterIndex = 1;
-	ofn.lpstrFilter = "Level File (*.lvl)\0*.lvl\0";
-	ofn.Flags = OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_NOCHANGEDIR;
-
-	return ofn;
-};
-
 void Editor::drawFileMenu() noexcept
 {
 	if (ImGui::BeginMainMenuBar())
@@ -427,31 +419,15 @@ void Editor::drawFileMenu() noexcept
 
 			if (ImGui::MenuItem("Open...", "Ctrl+O"))
 			{
-				// open a file menu and prompt user to create a file to save into
-				auto ofn = getOpenFileName(mApplication->mWindow);
-				if (GetOpenFileNameA(&ofn) == TRUE)
-				{
-					// deserialize the file and load in into the scene
-					serializer::loadLevel(mLevel, lastPath = ofn.lpstrFile);
-
-					this->mSaveState = SaveState::SAVED;
-					updateWindowTitle();
-				}
+				// prompt the user for a level file to load, it is loaded once picked
+				mFileBrowser.open(FileBrowser::Mode::OPEN);
 			}
 
 			if (ImGui::MenuItem("Save", "Ctrl+S"))
 			{
 				if (this->mSaveState == SaveState::NEW || this->mSaveState == SaveState::NEW_UNSAVED)
 				{
-					auto ofn = getOpenFileName(mApplication->mWindow);
-					if (GetSaveFileNameA(&ofn) == TRUE)
-					{
-						std::string path(ofn.lpstrFile); path += ".lvl";
-						serializer::saveLevel(mLevel, lastPath = path);
-
-						mSaveState = SaveState::SAVED;
-						updateWindowTitle();
-					}
+					mFileBrowser.open(FileBrowser::Mode::SAVE);
 				}
 				// If the user has saved the scene before, but is unsaved
 				else if (mSaveState == SaveState::UNSAVED)
@@ -466,16 +442,8 @@ void Editor::drawFileMenu() noexcept
 
 			if (ImGui::MenuItem("Save as...", "Ctrl+Shift+S"))
 			{
-				auto ofn = getOpenFileName(mApplication->mWindow);
-				if (GetSaveFileNameA(&ofn) == TRUE)
-				{
-					// serialize the scene to binary and save into the file
-					std::string path(ofn.lpstrFile); path += ".lvl";
-					serializer::saveLevel(mLevel, lastPath = path);
-
-					mSaveState = SaveState::SAVED;
-					updateWindowTitle();
-				}
+				// prompt the user for a file to save into, the level is saved once picked
+				mFileBrowser.open(FileBrowser::Mode::SAVE);
 			}
 
 			ImGui::Separator();
@@ -493,6 +461,19 @@ void Editor::drawFileMenu() noexcept
 			ImGui::Checkbox("Draw Grid", &shouldDrawGrid);
 			ImGui::Checkbox("Draw Colliders", &shouldDrawColliders);
 			ImGui::Checkbox("Simulate", &mLevel->play);
+			if (mLevel->snapshots != nullptr && mLevel->snapshots->size() > 1u) {
+				SnapshotRing* history = mLevel->snapshots;
+				ImGui::Text("History : %u ticks", history->size());
+				if (ImGui::Button("Step back")) {
+					history->restore(*mLevel, history->newestTick() - 1u);
+				}
+				ImGui::SameLine();
+				if (ImGui::Button("Rewind 1s")) {
+					history->restore(*mLevel, std::max(history->oldestTick(), history->newestTick() - 60u));
+				}
+			}
+			ImGui::Text("Entities : %u active, %u sleeping", mLevel->getActiveEntityCount(), mLevel->getSleepingEntityCount());
+			ImGui::Checkbox("Profiler", &shouldDrawProfiler);
 			if (ImGui::Checkbox("Limit Framerate", &shouldLimitFramerate)) {
 				if (shouldLimitFramerate) {
 					glfwSwapInterval(1);
@@ -507,6 +488,195 @@ void Editor::drawFileMenu() noexcept
 
 		ImGui::EndMainMenuBar();
 	}
+
+	if (mFileBrowser.draw())
+	{
+		lastPath = mFileBrowser.path();
+		if (mFileBrowser.mode() == FileBrowser::Mode::OPEN)
+		{
+			// deserialize the file and load in into the scene
+			serializer::loadLevel(mLevel, lastPath);
+		}
+		else
+		{
+			// serialize the scene to binary and save into the file
+			serializer::saveLevel(mLevel, lastPath);
+		}
+
+		mSaveState = SaveState::SAVED;
+		updateWindowTitle();
+	}
+}
+
+void Editor::drawProfiler() noexcept
+{
+	ImGui::Begin("Profiler", &shouldDrawProfiler);
+
+	bool recording = profiler::enabled();
+	if (ImGui::Checkbox("Record", &recording)) {
+		profiler::setEnabled(recording);
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Clear")) {
+		profiler::clearHistory();
+		mProfilerFrame = UINT64_MAX;
+	}
+
+	// Captures to a file chrome://tracing or ui.perfetto.dev can open
+	if (profiler::capturing()) {
+		ImGui::Text("Capturing to trace.json...");
+		ImGui::SameLine();
+		if (ImGui::Button("Stop")) {
+			profiler::stopCapture();
+		}
+	}
+	else {
+		ImGui::SetNextItemWidth(100.0f);
+		ImGui::InputInt("frames", &mCaptureFrames);
+		mCaptureFrames = std::max(mCaptureFrames, 1);
+		ImGui::SameLine();
+		if (ImGui::Button("Capture trace")) {
+			profiler::startCapture("trace.json", static_cast<uint32_t>(mCaptureFrames));
+		}
+	}
+
+	uint32_t frames = profiler::frameCount();
+	if (frames == 0u) {
+		ImGui::Text("No frames recorded");
+		ImGui::End();
+		return;
+	}
+	ImGui::SameLine();
+	ImGui::Text("%u frames, %u threads, %llu events dropped", frames, profiler::threadCount(),
+		static_cast<unsigned long long>(profiler::getDroppedCount()));
+	ImGui::Text("GPU : %.3f ms (%u frames behind)", mApplication->mRenderer->getGpuTimer().getLastFrameMs(),
+		QueryGpuTimer::FRAMES_IN_FLIGHT - 1u);
+
+	// Every operator new of the program, checked against the budget
+	bool tracking = profiler::trackingAllocations();
+	if (ImGui::Checkbox("Track allocations", &tracking)) {
+		profiler::setAllocTracking(tracking);
+	}
+	if (tracking) {
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(100.0f);
+		ImGui::InputInt("budget", &mAllocBudget);
+		mAllocBudget = std::max(mAllocBudget, 0);
+
+		uint32_t overBudget = 0u;
+		for (uint32_t f = 0u; f < frames; f++) {
+			overBudget += profiler::getFrame(f).allocations > static_cast<uint64_t>(mAllocBudget) ? 1u : 0u;
+		}
+		const profiler::Frame& last = profiler::getFrame(0u);
+		const ImVec4 color = overBudget > 0u ? ImVec4(1.0f, 0.4f, 0.4f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+		ImGui::TextColored(color, "Last frame : %llu allocations (%llu bytes), %u of %u frames over budget",
+			static_cast<unsigned long long>(last.allocations), static_cast<unsigned long long>(last.allocatedBytes),
+			overBudget, frames);
+	}
+
+	// The frame times, oldest first
+	ImGui::PlotHistogram("##frames", [](void* data, int i) {
+		const uint32_t count = *static_cast<uint32_t*>(data);
+		return static_cast<float>(profiler::getFrame(count - 1u - static_cast<uint32_t>(i)).milliseconds());
+	}, &frames, static_cast<int>(frames), 0, "frame ms", 0.0f, 33.3f, ImVec2(-1.0f, 60.0f));
+
+	// The frame the flame graph shows, if it is still in the history
+	const uint64_t newest = profiler::getFrame(0u).index;
+	uint32_t age = 0u;
+	if (mProfilerFrame != UINT64_MAX && newest - mProfilerFrame < frames) {
+		age = static_cast<uint32_t>(newest - mProfilerFrame);
+	}
+	else {
+		mProfilerFrame = UINT64_MAX;
+	}
+
+	if (ImGui::Selectable("Follow the last frame", mProfilerFrame == UINT64_MAX)) {
+		mProfilerFrame = UINT64_MAX;
+	}
+	ImGui::Text("Worst frames :");
+	for (const uint32_t worst : profiler::worstFrames(5u)) {
+		const profiler::Frame& frame = profiler::getFrame(worst);
+		char label[64];
+		std::snprintf(label, sizeof(label), "#%llu  %.3f ms", static_cast<unsigned long long>(frame.index), frame.milliseconds());
+		if (ImGui::Selectable(label, mProfilerFrame == frame.index)) {
+			mProfilerFrame = frame.index;
+		}
+	}
+
+	ImGui::Separator();
+
+	// The flame graph : a band per thread, a row per depth, and a box per scope, as wide as it took
+	const profiler::Frame& frame = profiler::getFrame(age);
+	ImGui::Text("Frame #%llu : %.3f ms", static_cast<unsigned long long>(frame.index), frame.milliseconds());
+
+	std::vector<uint32_t> firstRow(profiler::threadCount() + 1u, 0u);
+	for (const profiler::Event& event : frame.events) {
+		firstRow[event.thread + 1u] = std::max(firstRow[event.thread + 1u], static_cast<uint32_t>(event.depth) + 1u);
+	}
+	for (size_t t = 1u; t < firstRow.size(); t++) {
+		firstRow[t] += firstRow[t - 1u];
+	}
+
+	const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+	const ImVec2 origin = ImGui::GetCursorScreenPos();
+	const float width = std::max(ImGui::GetContentRegionAvail().x, 1.0f);
+	const double scale = width / static_cast<double>(std::max<uint64_t>(frame.end - frame.start, 1u));
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+	for (const profiler::Event& event : frame.events) {
+		// the GPU's passes are read back frames after they ran, they are only in the stats and the traces
+		if (event.end <= frame.start) { continue; }
+
+		// scopes opened in the frame before start at its edge
+		const uint64_t start = std::max(event.start, frame.start);
+		const float x0 = origin.x + static_cast<float>((start - frame.start) * scale);
+		const float x1 = std::max(x0 + 1.0f, origin.x + static_cast<float>((event.end - frame.start) * scale));
+		const float y0 = origin.y + (firstRow[event.thread] + event.depth) * rowHeight;
+		const ImVec2 min{ x0, y0 };
+		const ImVec2 max{ x1, y0 + rowHeight - 1.0f };
+
+		// the same scope is always the same color
+		uint32_t hash = 2166136261u;
+		for (const char* c = event.name; *c != '\0'; c++) {
+			hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+		}
+		const float hue = static_cast<float>(hash % 360u) / 360.0f;
+		drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.7f));
+		if (ImGui::CalcTextSize(event.name).x < x1 - x0 - 4.0f) {
+			drawList->AddText({ x0 + 2.0f, y0 }, IM_COL32_WHITE, event.name);
+		}
+
+		if (ImGui::IsMouseHoveringRect(min, max)) {
+			ImGui::SetTooltip("%s\nthread %u\n%.3f ms\n%u allocations (%u bytes)", event.name,
+				static_cast<unsigned>(event.thread), static_cast<double>(event.end - event.start) / 1e6,
+				static_cast<unsigned>(event.allocations), static_cast<unsigned>(event.allocatedBytes));
+		}
+	}
+	ImGui::Dummy(ImVec2(width, firstRow.back() * rowHeight));
+
+	ImGui::Separator();
+
+	// The time spent in each scope per frame, every call on every thread added up
+	// and what they allocated themselves, per frame
+	ImGui::Columns(6, "##scopes");
+	ImGui::Text("Scope"); ImGui::NextColumn();
+	ImGui::Text("Average ms"); ImGui::NextColumn();
+	ImGui::Text("Worst ms"); ImGui::NextColumn();
+	ImGui::Text("Calls"); ImGui::NextColumn();
+	ImGui::Text("Allocs"); ImGui::NextColumn();
+	ImGui::Text("Bytes"); ImGui::NextColumn();
+	ImGui::Separator();
+	for (const profiler::ScopeStats& stats : profiler::getStats()) {
+		ImGui::Text("%s", stats.name); ImGui::NextColumn();
+		ImGui::Text("%.3f", stats.averageMs); ImGui::NextColumn();
+		ImGui::Text("%.3f", stats.worstMs); ImGui::NextColumn();
+		ImGui::Text("%.1f", stats.calls); ImGui::NextColumn();
+		ImGui::Text("%.1f", stats.allocations); ImGui::NextColumn();
+		ImGui::Text("%.0f", stats.allocatedBytes); ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+
+	ImGui::End();
 }
 
 void Editor::updateWindowTitle() noexcept {
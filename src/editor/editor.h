@@ -14,25 +14,21 @@
 #include "../core/level/level.h"
 #include "../core/hitbox.h"
 #include "../graphics/sprite.h"
+#include "../graphics/sprite_ids.h"
 #include "../core/hitbox.h"
 #include "../core/serializer.h"
 #include "selection.h"
+#include "file_browser.h"
 #include "../core/json.h"
+#include "../core/profiler/profiler.h"
+#include "../core/profiler/alloc_tracker.h"
 
 #include "../app/application.h"
 
 class Application;
 
 #include <glad/glad.h>
-#include <glfw/glfw3.h>
-
-// to avoid warning: defined in both glad.h and windows.h
-#undef APIENTRY
-#include <Windows.h>
-#include <commdlg.h>
-
-#define GLFW_EXPOSE_NATIVE_WIN32
-#include <glfw/glfw3native.h>
+#include <GLFW/glfw3.h>
 
 // Some features are unused today
 #define ENABLE_ADVANCED 0
@@ -87,6 +83,11 @@ private:
 	*/
 	void drawFileMenu() noexcept;
 
+	/**
+	* @brief Draws the profiler's window : the frame times, a flame graph of one frame, and the time spent in each scope
+	*/
+	void drawProfiler() noexcept;
+
 	void updateWindowTitle() noexcept;
 
 private:
@@ -169,12 +170,22 @@ private:
 	bool shouldDrawSelector;
 	bool shouldDrawSettings;
 	bool shouldLimitFramerate;
+	bool shouldDrawProfiler;
 	SaveState mSaveState;
 
+	// the frame the profiler's flame graph shows, UINT64_MAX follows the last one
+	uint64_t mProfilerFrame;
+	// the frames the profiler's capture button writes to trace.json
+	int mCaptureFrames;
+	// the allocations a frame may make before the profiler shows it in red
+	int mAllocBudget;
+
 	bool mActive;
 
 	ImGuiIO* imgui_io;
 	std::string lastPath;
+	// open and save as, the levels are in levels/
+	FileBrowser mFileBrowser;
 
 #if ENABLE_ADVANCED
 
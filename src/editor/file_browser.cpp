@@ -0,0 +1,140 @@
+#include "file_browser.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <system_error>
+
+#include "imgui/imgui.h"
+
+namespace fs = std::filesystem;
+
+// the same id whatever the title, so opening and drawing agree on which popup it is
+static constexpr const char* POPUP_ID = "###FileBrowser";
+
+FileBrowser::FileBrowser(const char* extension, const char* directory) : mExtension(extension), mName{ 0 },
+mMode(Mode::OPEN), mOpenRequested(false)
+{
+	std::error_code error;
+	mDirectory = fs::absolute(fs::is_directory(directory, error) ? fs::path(directory) : fs::current_path(error), error);
+}
+
+void FileBrowser::open(Mode mode) noexcept
+{
+	mMode = mode;
+	mOpenRequested = true;
+}
+
+void FileBrowser::refresh() noexcept
+{
+	mEntries.clear();
+	mError.clear();
+
+	std::error_code error;
+	for (fs::directory_iterator it(mDirectory, error), end; !error && it != end; it.increment(error)) {
+		std::error_code typeError;
+		const bool directory = it->is_directory(typeError);
+		if (typeError) { continue; }
+
+		const fs::path& path = it->path();
+		if (directory || path.extension() == mExtension) {
+			mEntries.push_back({ path.filename().string(), directory });
+		}
+	}
+	if (error) {
+		mError = "Could not list " + mDirectory.string() + " : " + error.message();
+	}
+
+	std::sort(mEntries.begin(), mEntries.end(), [](const Entry& a, const Entry& b) {
+		return a.directory != b.directory ? a.directory : a.name < b.name;
+	});
+}
+
+bool FileBrowser::confirm() noexcept
+{
+	if (mName[0] == '\0') { return false; }
+
+	fs::path path = mDirectory / mName;
+	std::error_code error;
+	if (mMode == Mode::OPEN) {
+		if (!fs::is_regular_file(path, error)) {
+			mError = std::string(mName) + " does not exist";
+			return false;
+		}
+	}
+	else if (path.extension() != mExtension) {
+		path += mExtension;
+	}
+
+	mPath = path.string();
+	return true;
+}
+
+bool FileBrowser::draw() noexcept
+{
+	if (mOpenRequested) {
+		mOpenRequested = false;
+		mName[0] = '\0';
+		refresh();
+		ImGui::OpenPopup(POPUP_ID);
+	}
+
+	const char* title = mMode == Mode::OPEN ? "Open level###FileBrowser" : "Save level###FileBrowser";
+	ImGui::SetNextWindowSize(ImVec2(520.0f, 360.0f), ImGuiCond_Appearing);
+	if (!ImGui::BeginPopupModal(title)) {
+		return false;
+	}
+
+	bool picked = false;
+
+	// Going into a folder is only done after the list is drawn, it changes the list
+	fs::path next;
+	if (ImGui::Button("Up")) {
+		next = mDirectory.parent_path();
+	}
+	ImGui::SameLine();
+	ImGui::TextUnformatted(mDirectory.string().c_str());
+
+	const float footer = ImGui::GetFrameHeightWithSpacing() * (mError.empty() ? 1.0f : 2.0f);
+	ImGui::BeginChild("##entries", ImVec2(0.0f, -footer), true);
+	for (const Entry& entry : mEntries) {
+		const std::string label = entry.directory ? entry.name + "/" : entry.name;
+		const bool selected = !entry.directory && entry.name == mName;
+		if (ImGui::Selectable(label.c_str(), selected, ImGuiSelectableFlags_AllowDoubleClick)) {
+			if (entry.directory) {
+				next = mDirectory / entry.name;
+			}
+			else {
+				std::snprintf(mName, sizeof(mName), "%s", entry.name.c_str());
+				if (ImGui::IsMouseDoubleClicked(0)) {
+					picked = confirm();
+				}
+			}
+		}
+	}
+	ImGui::EndChild();
+
+	if (!next.empty() && next != mDirectory) {
+		mDirectory = next;
+		refresh();
+	}
+
+	if (!mError.empty()) {
+		ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", mError.c_str());
+	}
+
+	ImGui::SetNextItemWidth(-140.0f);
+	if (ImGui::InputText("##name", mName, sizeof(mName), ImGuiInputTextFlags_EnterReturnsTrue)) {
+		picked = confirm();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button(mMode == Mode::OPEN ? "Open" : "Save", ImVec2(60.0f, 0.0f))) {
+		picked = confirm();
+	}
+	ImGui::SameLine();
+	if (ImGui::Button("Cancel", ImVec2(60.0f, 0.0f)) || picked) {
+		ImGui::CloseCurrentPopup();
+	}
+
+	ImGui::EndPopup();
+	return picked;
+}
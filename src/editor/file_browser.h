@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+* A file dialog drawn with ImGui, so opening and saving levels works the same on every platform : it lists the
+* folders of a directory and its files with one extension, and gives back the path the user picked
+*/
+class FileBrowser final {
+public:
+
+	enum class Mode : char {
+		OPEN,
+		SAVE
+	};
+
+	/**
+	* @param extension - The extension of the files listed, with its dot (".lvl"); saved paths get it if they lack it
+	* @param directory - Where the browser starts, the current directory if it does not exist
+	*/
+	FileBrowser(const char* extension, const char* directory);
+
+	/**
+	* @brief Opens the dialog on the next draw. It is a popup of its own, so it can be opened from inside a menu
+	*/
+	void open(Mode mode) noexcept;
+
+	/**
+	* @brief Draws the dialog while it is open
+	* @return true on the frame the user picked a file, path() is the file then
+	*/
+	bool draw() noexcept;
+
+	inline const std::string& path() const noexcept {
+		return mPath;
+	}
+
+	inline Mode mode() const noexcept {
+		return mMode;
+	}
+
+private:
+
+	struct Entry {
+		std::string name;
+		bool directory;
+	};
+
+	/**
+	* @brief Lists the directory again : its folders then its files, each sorted by name
+	*/
+	void refresh() noexcept;
+
+	/**
+	* @brief Picks the file named in the name field, if there is one to open or a name to save to
+	* @return true if the dialog is done
+	*/
+	bool confirm() noexcept;
+
+	std::string mExtension;
+	std::filesystem::path mDirectory;
+	std::vector<Entry> mEntries;
+
+	// the name field, filled when a file is clicked
+	char mName[256];
+	std::string mPath;
+	std::string mError;
+
+	Mode mMode;
+	bool mOpenRequested;
+};
@@ -0,0 +1,117 @@
+#ifndef ANIMATION_H_
+#define ANIMATION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "sprite_ids.h"
+
+/**
+* The ids of every animation clip in the "animations" of resources/files/texture_atlas.json
+* @note - Must be kept in sync with the atlas
+*/
+namespace Clips {
+
+	enum : uint16_t {
+		// draws nothing, an entity playing it is not drawn
+		NONE = 0,
+		GOOMBA_WALK = 1,
+		GOOMBA_STOMPED = 2,
+		KOOPA_WALK = 3,
+		KOOPA_SHELL = 4,
+		COIN = 5,
+		QUESTION_BLOCK = 6,
+		COIN_POP = 7,
+		FIREBALL = 8,
+		COUNT
+	};
+}
+
+/**
+* A looping sequence of sprites, each shown for the same number of ticks
+*/
+struct AnimationClip {
+	// the clip's first frame in AnimationTable's frames
+	uint32_t firstFrame{ 0u };
+	uint16_t length{ 0u };
+	// ticks per frame
+	uint16_t duration{ 1u };
+};
+
+/**
+* Every animation clip, loaded with the atlas. Nothing animated keeps any animation state of its own but the clip it
+* plays and the tick it started at : the frame to draw at any tick is computed from those, so nothing has to be
+* updated every tick to animate, and two entities playing the same clip from different ticks are out of step
+*/
+class AnimationTable final {
+public:
+
+	/**
+	* @brief Adds or replaces a clip
+	* @param frames - The sprite of each frame
+	*/
+	void set(uint16_t clip, const std::vector<uint32_t>& frames, uint16_t duration) {
+		if (clip >= mClips.size()) {
+			mClips.resize(clip + 1u);
+		}
+		mClips[clip] = { static_cast<uint32_t>(mFrames.size()), static_cast<uint16_t>(frames.size()),
+			duration > 0u ? duration : static_cast<uint16_t>(1u) };
+		mFrames.insert(mFrames.end(), frames.begin(), frames.end());
+	}
+
+	/**
+	* @brief Makes every tile drawn with the sprite play the clip instead, all in step
+	*/
+	void setTileClip(uint32_t sprite, uint16_t clip) {
+		if (sprite >= mTileClips.size()) {
+			mTileClips.resize(sprite + 1u, Clips::NONE);
+		}
+		mTileClips[sprite] = clip;
+	}
+
+	void clear() noexcept {
+		mClips.clear();
+		mFrames.clear();
+		mTileClips.clear();
+	}
+
+	/**
+	* @return The sprite of the clip at the tick : (tick - start) / duration % length, the same as the sprite shader.
+	* Clips the table does not have draw Sprites::NONE
+	*/
+	inline uint32_t frame(uint16_t clip, uint32_t start, uint32_t tick) const noexcept {
+		if (clip >= mClips.size() || mClips[clip].length == 0u) { return Sprites::NONE; }
+		const AnimationClip& c = mClips[clip];
+		return mFrames[c.firstFrame + (tick - start) / c.duration % c.length];
+	}
+
+	/**
+	* @return The clip tiles with the sprite play, Clips::NONE if they are not animated
+	*/
+	inline uint16_t tileClip(uint32_t sprite) const noexcept {
+		return sprite < mTileClips.size() ? mTileClips[sprite] : static_cast<uint16_t>(Clips::NONE);
+	}
+
+	inline uint32_t clipCount() const noexcept {
+		return static_cast<uint32_t>(mClips.size());
+	}
+
+	inline const AnimationClip& getClip(uint16_t clip) const noexcept {
+		return mClips[clip];
+	}
+
+	/**
+	* @return The sprites of every clip's frames, AnimationClip::firstFrame indexes into them
+	*/
+	inline const std::vector<uint32_t>& getFrames() const noexcept {
+		return mFrames;
+	}
+
+private:
+	std::vector<AnimationClip> mClips;
+	std::vector<uint32_t> mFrames;
+	// indexed by sprite
+	std::vector<uint16_t> mTileClips;
+};
+
+#endif // !ANIMATION_H_
@@ -0,0 +1,34 @@
+#include "clip_table.h"
+
+#include "animation.h"
+#include "sprite_atlas.h"
+
+void ClipTable::build(const AnimationTable& animations, const SpriteAtlas& atlas)
+{
+    // clip 0 (Clips::NONE) stays empty, the shader never reads it
+    mClips.assign(animations.clipCount() > 0u ? animations.clipCount() : 1u, ClipRecord{ 0u, 0u, 1u, 0u });
+
+    const std::vector<uint32_t>& frames = animations.getFrames();
+    mFrames.resize(frames.size());
+    for (size_t f = 0u; f < frames.size(); f++) {
+        const Sprite& sprite = atlas.getSprite(frames[f]);
+        mFrames[f] = { sprite.topLeft, sprite.bottomRight };
+    }
+
+    for (uint32_t c = 1u; c < animations.clipCount(); c++) {
+        const AnimationClip& clip = animations.getClip(static_cast<uint16_t>(c));
+        mClips[c] = { clip.firstFrame, clip.length, clip.duration, 0u };
+    }
+}
+
+glm::vec2 ClipTable::resolve(const Vertex& vertex, uint32_t corner, uint32_t tick) const noexcept
+{
+    if (vertex.clip == 0u || vertex.clip >= mClips.size() || mClips[vertex.clip].length == 0u) {
+        return vertex.texCoords;
+    }
+
+    // must match resources/shaders/textured/vertex.txt
+    const ClipRecord& clip = mClips[vertex.clip];
+    const FrameRect& frame = mFrames[clip.firstFrame + (tick - vertex.start) / clip.duration % clip.length];
+    return { (corner & 1u) ? frame.bottomRight.x : frame.topLeft.x, (corner & 2u) ? frame.bottomRight.y : frame.topLeft.y };
+}
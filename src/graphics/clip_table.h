@@ -0,0 +1,73 @@
+#ifndef CLIP_TABLE_H_
+#define CLIP_TABLE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "vertex.h"
+
+class AnimationTable;
+class SpriteAtlas;
+
+/**
+* One clip, as a texel of the shader's clip table (RGBA32UI)
+*/
+struct ClipRecord {
+	// the clip's first frame in the frame table
+	uint32_t firstFrame;
+	uint32_t length;
+	// ticks per frame
+	uint32_t duration;
+	uint32_t unused;
+};
+
+static_assert(sizeof(ClipRecord) == 16, "A clip record must be one RGBA32UI texel");
+
+/**
+* The texture coordinates of one frame, as a texel of the shader's frame table (RGBA32F). Sprites are axis aligned,
+* so the other two corners are made of these
+*/
+struct FrameRect {
+	glm::vec2 topLeft;
+	glm::vec2 bottomRight;
+};
+
+static_assert(sizeof(FrameRect) == 16, "A frame rect must be one RGBA32F texel");
+
+/**
+* The animation clips laid out the way the sprite shader reads them : a clip table indexed by clip id, and a frame
+* table of texture coordinates. The renderer uploads both once, then every animated vertex resolves its frame on
+* the GPU from its clip, its start tick and the tick uniform, so nothing animated is resubmitted to change frames.
+*
+* resolve does on the CPU exactly what the shader does, so what the GPU would draw can be checked without a GPU
+*/
+class ClipTable final {
+public:
+
+	/**
+	* @brief Rebuilds the tables from the clips, with the frames' texture coordinates from the atlas
+	*/
+	void build(const AnimationTable& animations, const SpriteAtlas& atlas);
+
+	/**
+	* @param corner - The vertex's corner in its quad, 0 to 3 (top left, top right, bottom left, bottom right)
+	* @return The texture coordinates the shader gives the vertex at the tick
+	*/
+	glm::vec2 resolve(const Vertex& vertex, uint32_t corner, uint32_t tick) const noexcept;
+
+	inline const std::vector<ClipRecord>& getClips() const noexcept {
+		return mClips;
+	}
+
+	inline const std::vector<FrameRect>& getFrames() const noexcept {
+		return mFrames;
+	}
+
+private:
+	std::vector<ClipRecord> mClips;
+	std::vector<FrameRect> mFrames;
+};
+
+#endif // !CLIP_TABLE_H_
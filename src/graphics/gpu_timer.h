@@ -0,0 +1,66 @@
+#ifndef GPU_TIMER_H_
+#define GPU_TIMER_H_
+
+/**
+* Times passes of GPU work. The results come back frames later, and go into the profiler on a track of their own,
+* on the same timeline as the CPU's scopes
+*/
+class GpuTimer {
+public:
+	virtual ~GpuTimer() = default;
+
+	/**
+	* @brief Starts timing the GPU commands issued from now on, passes can be nested. The name must be a string literal
+	*/
+	virtual void begin(const char* name) noexcept = 0;
+
+	/**
+	* @brief Ends the innermost pass
+	*/
+	virtual void end() noexcept = 0;
+
+	/**
+	* @brief Ends the frame's passes, and hands the profiler the passes of older frames the GPU has finished. Never
+	* waits for the GPU. Call once per frame, after the last pass
+	*/
+	virtual void endFrame() noexcept = 0;
+
+	/**
+	* @return The GPU time of the passes of the last frame that was read back (the outermost passes added up), in ms
+	*/
+	virtual double getLastFrameMs() const noexcept = 0;
+};
+
+/**
+* A GpuTimer that times nothing, for backends without a GPU
+*/
+class NullGpuTimer final : public GpuTimer {
+public:
+	void begin(const char*) noexcept override {}
+	void end() noexcept override {}
+	void endFrame() noexcept override {}
+	double getLastFrameMs() const noexcept override { return 0.0; }
+};
+
+/**
+* Times the GPU commands of a block, with any timer (or none)
+*/
+class GpuPass final {
+public:
+
+	GpuPass(GpuTimer* timer, const char* name) noexcept : mTimer(timer) {
+		if (mTimer != nullptr) { mTimer->begin(name); }
+	}
+
+	~GpuPass() noexcept {
+		if (mTimer != nullptr) { mTimer->end(); }
+	}
+
+	GpuPass(const GpuPass&) = delete;
+	GpuPass& operator=(const GpuPass&) = delete;
+
+private:
+	GpuTimer* mTimer;
+};
+
+#endif // !GPU_TIMER_H_
@@ -1,5 +1,7 @@
 #include "line_renderer.h"
 
+#include "../core/profiler/profiler.h"
+
 #define MAX_LINES 1000
 
 LineRenderer::LineRenderer() : count(0)
@@ -42,6 +44,9 @@ void LineRenderer::buffer(glm::vec2 start, glm::vec2 end) noexcept {
 
 void LineRenderer::render(const Camera* camera) noexcept {
 
+	PROFILE_SCOPE("LineRenderer::render");
+	GpuPass pass(gpuTimer, "GPU lines");
+
 	mShader.use();
 	mShader.setMat4("projection", camera->getProjection());
 
@@ -2,6 +2,7 @@
 
 #include <glm/vec2.hpp>
 
+#include "gpu_timer.h"
 #include "shader_program.h"
 #include "../core/camera.h"
 
@@ -17,6 +18,8 @@ public:
 
     void render(const Camera* camera) noexcept;
 
+    // times the lines' draws, or null
+    GpuTimer* gpuTimer{ nullptr };
 
 private:
     ShaderProgram mShader;
@@ -0,0 +1,146 @@
+#include "particle.h"
+
+#include <algorithm>
+
+#include "sprite_ids.h"
+
+namespace {
+
+    // the same pull as the entities', in tiles per tick squared
+    constexpr float PARTICLE_GRAVITY = 9.8f / (60.0f * 60.0f);
+
+    const ParticleEmitter EMITTERS[PARTICLE_TYPE_COUNT] = {
+        // BRICK_DEBRIS : thrown up and out, falls off the screen
+        { Sprites::BRICK_TOP, Clips::NONE, 90u, { PARTICLE_GRAVITY, 0.4f, 1.0f, false } },
+        // COIN_POP : spins up out of the block and falls back into it as it dies (launched at 0.3, 2 * 0.3 / 30)
+        { Sprites::COIN_P_1, Clips::COIN_POP, 30u, { 0.02f, 0.4f, 1.0f, false } },
+        // STOMP_PUFF : drifts and slows down
+        { Sprites::CLOUD, Clips::NONE, 20u, { 0.0f, 0.4f, 0.9f, false } },
+        // FIREBALL_TRAIL : hangs where it was left
+        { Sprites::BOWSER_FIRE_1, Clips::FIREBALL, 12u, { -0.002f, 0.4f, 0.8f, false } },
+    };
+}
+
+const ParticleEmitter& ParticleSystem::emitter(ParticleType type) noexcept
+{
+    return EMITTERS[static_cast<size_t>(type)];
+}
+
+ParticleSystem::ParticleSystem(uint32_t capacity) : mCapacity(capacity)
+{
+    for (ParticlePool& pool : mPools) {
+        pool.position.resize(capacity);
+        pool.velocity.resize(capacity);
+        pool.death.resize(capacity);
+    }
+}
+
+void ParticleSystem::emit(ParticleType type, glm::vec2 position, glm::vec2 velocity, uint32_t tick) noexcept
+{
+    // a tick being simulated again already emitted its particles
+    if (mStarted && tick <= mTick) { return; }
+
+    ParticlePool& pool = mPools[static_cast<size_t>(type)];
+    if (pool.count == mCapacity) {
+        mDropped++;
+        return;
+    }
+
+    const uint32_t i = pool.count++;
+    pool.position[i] = position;
+    pool.velocity[i] = velocity;
+    pool.death[i] = tick + emitter(type).lifetime;
+    pool.nextDeath = std::min(pool.nextDeath, pool.death[i]);
+}
+
+void ParticleSystem::burst(ParticleType type, glm::vec2 position, uint32_t tick) noexcept
+{
+    switch (type) {
+    case ParticleType::BRICK_DEBRIS:
+        // a piece from each corner of the brick
+        emit(type, position + glm::vec2(0.0f, 0.5f), { -0.05f, 0.25f }, tick);
+        emit(type, position + glm::vec2(0.5f, 0.5f), { 0.05f, 0.25f }, tick);
+        emit(type, position, { -0.05f, 0.15f }, tick);
+        emit(type, position + glm::vec2(0.5f, 0.0f), { 0.05f, 0.15f }, tick);
+        break;
+    case ParticleType::COIN_POP:
+        emit(type, position + glm::vec2(0.0f, 1.0f), { 0.0f, 0.3f }, tick);
+        break;
+    case ParticleType::STOMP_PUFF:
+        emit(type, position + glm::vec2(-0.25f, 0.0f), { -0.03f, 0.0f }, tick);
+        emit(type, position + glm::vec2(0.25f, 0.0f), { 0.03f, 0.0f }, tick);
+        break;
+    default:
+        emit(type, position, { 0.0f, 0.0f }, tick);
+        break;
+    }
+}
+
+void ParticleSystem::update(uint32_t tick) noexcept
+{
+    if (mStarted && tick <= mTick) { return; }
+    mStarted = true;
+    mTick = tick;
+
+    for (size_t t = 0u; t < PARTICLE_TYPE_COUNT; t++) {
+        ParticlePool& pool = mPools[t];
+
+        // the whole pool at once, on the motion kernels' SIMD paths
+        motion::integrate(pool.position.data(), pool.velocity.data(), pool.count, EMITTERS[t].motion);
+
+        if (tick < pool.nextDeath) { continue; }
+
+        // the dead are replaced with the last particle, which is checked again in their place
+        uint32_t nextDeath = UINT32_MAX;
+        for (uint32_t i = 0u; i < pool.count;) {
+            if (pool.death[i] <= tick) {
+                const uint32_t last = --pool.count;
+                pool.position[i] = pool.position[last];
+                pool.velocity[i] = pool.velocity[last];
+                pool.death[i] = pool.death[last];
+                continue;
+            }
+            nextDeath = std::min(nextDeath, pool.death[i]);
+            i++;
+        }
+        pool.nextDeath = nextDeath;
+    }
+}
+
+void ParticleSystem::draw(RenderList& list) const
+{
+    for (size_t t = 0u; t < PARTICLE_TYPE_COUNT; t++) {
+        const ParticlePool& pool = mPools[t];
+        const ParticleEmitter& type = EMITTERS[t];
+
+        if (type.clip == Clips::NONE) {
+            for (uint32_t i = 0u; i < pool.count; i++) {
+                list.buffer(pool.position[i], type.sprite);
+            }
+        }
+        else {
+            // every particle of a type lives as long, so the tick it was emitted at is its death minus that
+            for (uint32_t i = 0u; i < pool.count; i++) {
+                list.bufferClip(pool.position[i], type.clip, pool.death[i] - type.lifetime);
+            }
+        }
+    }
+}
+
+void ParticleSystem::clear() noexcept
+{
+    for (ParticlePool& pool : mPools) {
+        pool.count = 0u;
+        pool.nextDeath = UINT32_MAX;
+    }
+    mStarted = false;
+}
+
+uint32_t ParticleSystem::size() const noexcept
+{
+    uint32_t total = 0u;
+    for (const ParticlePool& pool : mPools) {
+        total += pool.count;
+    }
+    return total;
+}
@@ -1,35 +1,131 @@
 #ifndef PARTICLE_H_
 #define PARTICLE_H_
 
-#include "renderer.h"
+#include <array>
+#include <cstdint>
+#include <vector>
 
-class Particle
-{
+#include <glm/vec2.hpp>
+
+#include "animation.h"
+#include "render_list.h"
+#include "../core/level/entity/motion.h"
+
+/**
+* The kinds of particles, each has a pool of its own
+*/
+enum class ParticleType : uint8_t {
+	BRICK_DEBRIS,
+	COIN_POP,
+	STOMP_PUFF,
+	FIREBALL_TRAIL,
+	COUNT
+};
+
+static constexpr size_t PARTICLE_TYPE_COUNT = static_cast<size_t>(ParticleType::COUNT);
+
+/**
+* How every particle of a type looks and moves
+*/
+struct ParticleEmitter {
+	// the sprite of the particles, when they play no clip
+	uint32_t sprite;
+	// the clip they play from the tick they are emitted, Clips::NONE for the still sprite
+	uint16_t clip;
+	// ticks a particle lives
+	uint32_t lifetime;
+	// particles fly through the tiles, tileCollision is ignored
+	motion::MotionParams motion;
+};
+
+/**
+* A fixed capacity pool of particles of one type, one array per component. Particles are removed by moving the last
+* one into their place, so the live ones always fill [0, count)
+*/
+struct ParticlePool {
+	std::vector<glm::vec2> position;
+	std::vector<glm::vec2> velocity;
+	// the tick the particle dies at
+	std::vector<uint32_t> death;
+	uint32_t count{ 0u };
+	// the earliest death in the pool, nothing is scanned for removal before it
+	uint32_t nextDeath{ UINT32_MAX };
+};
+
+/**
+* Every particle of a level, cosmetic only : nothing in the simulation reads them back, and they are not part of
+* the level's snapshots or hashes.
+*
+* The level emits particles while it simulates a tick and updates them once at its end, then draws them into its
+* render list. Emitting from a tick the particles were already updated past does nothing, so a level replaying
+* ticks (a rollback) does not emit their particles twice. The pools never grow, particles emitted into a full pool
+* are dropped
+*/
+class ParticleSystem final {
 public:
-	Particle(glm::vec2 origin, uint32_t sprite, uint32_t duration, glm::vec2(*lambda)(uint32_t))
-	{
-		this->position = origin;
-		this->sprite = sprite;
-		this->duration = duration;
-		this->velocityFunction = lambda;
+
+	static constexpr uint32_t DEFAULT_CAPACITY = 16384u;
+
+	/**
+	* @param capacity - The most particles of each type alive at once
+	*/
+	explicit ParticleSystem(uint32_t capacity = DEFAULT_CAPACITY);
+
+	/**
+	* @brief Adds a particle, it is dropped if its pool is full or its tick was already updated past
+	*/
+	void emit(ParticleType type, glm::vec2 position, glm::vec2 velocity, uint32_t tick) noexcept;
+
+	/**
+	* @brief Emits what the type looks like when it happens once : the four pieces of a brick, a coin, a puff...
+	* @param position - The bottom left of the tile or entity it comes from
+	*/
+	void burst(ParticleType type, glm::vec2 position, uint32_t tick) noexcept;
+
+	/**
+	* @brief Moves every particle to the tick and removes the ones that died, once per tick (older ticks are ignored)
+	*/
+	void update(uint32_t tick) noexcept;
+
+	/**
+	* @brief Buffers every live particle
+	*/
+	void draw(RenderList& list) const;
+
+	/**
+	* @brief Removes every particle, the memory is kept
+	*/
+	void clear() noexcept;
+
+	/**
+	* @return The particles alive, of every type
+	*/
+	uint32_t size() const noexcept;
+
+	inline uint32_t capacity() const noexcept {
+		return mCapacity;
 	}
 
-	inline void update() noexcept
-	{
-		position += velocityFunction(duration--);
+	inline const ParticlePool& pool(ParticleType type) const noexcept {
+		return mPools[static_cast<size_t>(type)];
 	}
 
-	inline void draw(Renderer* renderer) const noexcept
-	{
-		//renderer->buffer(this->position, this->sprite);
+	/**
+	* @return The particles dropped because their pool was full
+	*/
+	inline uint64_t getDroppedCount() const noexcept {
+		return mDropped;
 	}
-private:
 
-	glm::vec2 position;
-	uint32_t sprite;
-	uint32_t duration;
-	glm::vec2(*velocityFunction)(uint32_t);
+	static const ParticleEmitter& emitter(ParticleType type) noexcept;
 
+private:
+	std::array<ParticlePool, PARTICLE_TYPE_COUNT> mPools;
+	uint32_t mCapacity;
+	// the last tick update ran for
+	uint32_t mTick{ 0u };
+	bool mStarted{ false };
+	uint64_t mDropped{ 0u };
 };
 
-#endif // !PARTICLE_H_
\ No newline at end of file
+#endif // !PARTICLE_H_
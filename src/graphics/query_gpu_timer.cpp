@@ -0,0 +1,107 @@
+#include "query_gpu_timer.h"
+
+#include "../core/profiler/profiler.h"
+
+QueryGpuTimer::QueryGpuTimer() : mTrack(profiler::createTrack("GPU"))
+{
+    for (FrameQueries& frame : mFrames) {
+        glGenQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    }
+    calibrate();
+}
+
+QueryGpuTimer::~QueryGpuTimer() noexcept
+{
+    for (FrameQueries& frame : mFrames) {
+        glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    }
+}
+
+void QueryGpuTimer::begin(const char* name) noexcept
+{
+    FrameQueries& frame = mFrames[mCurrent];
+
+    uint32_t pass = NO_PASS;
+    if (ENABLE_PROFILER && profiler::enabled() && frame.count < MAX_PASSES && mDepth < MAX_DEPTH) {
+        pass = frame.count++;
+        frame.passes[pass] = { name, static_cast<uint16_t>(mDepth), false };
+        glQueryCounter(frame.queries[2u * pass], GL_TIMESTAMP);
+        frame.last = frame.queries[2u * pass];
+    }
+
+    if (mDepth < MAX_DEPTH) {
+        mOpen[mDepth] = pass;
+    }
+    mDepth++;
+}
+
+void QueryGpuTimer::end() noexcept
+{
+    if (mDepth == 0u) { return; }
+    mDepth--;
+
+    if (mDepth >= MAX_DEPTH || mOpen[mDepth] == NO_PASS) { return; }
+
+    FrameQueries& frame = mFrames[mCurrent];
+    const uint32_t pass = mOpen[mDepth];
+    glQueryCounter(frame.queries[2u * pass + 1u], GL_TIMESTAMP);
+    frame.last = frame.queries[2u * pass + 1u];
+    frame.passes[pass].ended = true;
+}
+
+void QueryGpuTimer::endFrame() noexcept
+{
+    // passes left open are not timed
+    mDepth = 0u;
+    mCurrent = (mCurrent + 1u) % FRAMES_IN_FLIGHT;
+
+    // the oldest frame in flight, its queries are reused from now on
+    FrameQueries& oldest = mFrames[mCurrent];
+    if (oldest.count > 0u) {
+        GLint available = 0;
+        glGetQueryObjectiv(oldest.last, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            collect(oldest);
+        }
+        else {
+            mDropped++;
+        }
+    }
+    oldest.count = 0u;
+
+    // the two clocks drift apart
+    if (++mSinceCalibration >= CALIBRATION_INTERVAL) {
+        calibrate();
+    }
+}
+
+void QueryGpuTimer::calibrate() noexcept
+{
+    GLint64 gpu = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu);
+    mClockOffset = static_cast<int64_t>(profiler::now()) - static_cast<int64_t>(gpu);
+    mSinceCalibration = 0u;
+}
+
+void QueryGpuTimer::collect(const FrameQueries& frame) noexcept
+{
+    uint64_t total = 0u;
+    for (uint32_t p = 0u; p < frame.count; p++) {
+        const Pass& pass = frame.passes[p];
+        if (!pass.ended) { continue; }
+
+        GLuint64 start = 0u, end = 0u;
+        glGetQueryObjectui64v(frame.queries[2u * p], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(frame.queries[2u * p + 1u], GL_QUERY_RESULT, &end);
+        if (end < start) { continue; }
+
+        profiler::record(mTrack, pass.name, static_cast<uint64_t>(static_cast<int64_t>(start) + mClockOffset),
+            static_cast<uint64_t>(static_cast<int64_t>(end) + mClockOffset), pass.depth);
+        if (pass.depth == 0u) {
+            total += end - start;
+        }
+    }
+
+    mLastFrameMs = static_cast<double>(total) / 1e6;
+    PROFILE_COUNTER("gpu ms", mLastFrameMs);
+}
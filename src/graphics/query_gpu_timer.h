@@ -0,0 +1,91 @@
+#ifndef QUERY_GPU_TIMER_H_
+#define QUERY_GPU_TIMER_H_
+
+#include <array>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "gpu_timer.h"
+
+/**
+* The OpenGL GpuTimer, a GL_TIMESTAMP query at both ends of every pass.
+*
+* Each frame's queries are read back FRAMES_IN_FLIGHT - 1 frames later, when the GPU is done with them, so reading
+* them never stalls; a frame whose queries are still not done by the time they are needed again is dropped. The GPU
+* clock is calibrated against the CPU's every CALIBRATION_INTERVAL frames, so the passes line up with the CPU scopes
+* that issued them. Nothing is queried while the profiler is not recording
+*/
+class QueryGpuTimer final : public GpuTimer {
+public:
+
+	static constexpr uint32_t FRAMES_IN_FLIGHT = 3u;
+	static constexpr uint32_t MAX_PASSES = 32u;
+	static constexpr uint32_t MAX_DEPTH = 8u;
+	static constexpr uint32_t CALIBRATION_INTERVAL = 300u;
+
+	/**
+	* @note Needs a current GL context
+	*/
+	QueryGpuTimer();
+	~QueryGpuTimer() noexcept;
+
+	QueryGpuTimer(const QueryGpuTimer&) = delete;
+	QueryGpuTimer& operator=(const QueryGpuTimer&) = delete;
+
+	void begin(const char* name) noexcept override;
+	void end() noexcept override;
+	void endFrame() noexcept override;
+
+	inline double getLastFrameMs() const noexcept override {
+		return mLastFrameMs;
+	}
+
+	/**
+	* @return The frames whose queries were not done in time
+	*/
+	inline uint64_t getDroppedFrames() const noexcept {
+		return mDropped;
+	}
+
+private:
+
+	static constexpr uint32_t NO_PASS = UINT32_MAX;
+
+	struct Pass {
+		const char* name;
+		uint16_t depth;
+		bool ended;
+	};
+
+	/**
+	* The queries of one frame in flight, two per pass (its start and its end)
+	*/
+	struct FrameQueries {
+		std::array<GLuint, 2u * MAX_PASSES> queries;
+		std::array<Pass, MAX_PASSES> passes;
+		uint32_t count{ 0u };
+		// the query issued last, the GPU finishes them in order
+		GLuint last{ 0u };
+	};
+
+	void calibrate() noexcept;
+	void collect(const FrameQueries& frame) noexcept;
+
+	std::array<FrameQueries, FRAMES_IN_FLIGHT> mFrames;
+	uint32_t mCurrent{ 0u };
+
+	// the passes open in the current frame, NO_PASS for the ones that are not timed
+	std::array<uint32_t, MAX_DEPTH> mOpen;
+	uint32_t mDepth{ 0u };
+
+	// CPU time minus GPU time, in nanoseconds
+	int64_t mClockOffset{ 0 };
+	uint32_t mSinceCalibration{ 0u };
+
+	uint16_t mTrack;
+	double mLastFrameMs{ 0.0 };
+	uint64_t mDropped{ 0u };
+};
+
+#endif // !QUERY_GPU_TIMER_H_
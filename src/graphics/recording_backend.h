@@ -0,0 +1,77 @@
+#ifndef RECORDING_BACKEND_H_
+#define RECORDING_BACKEND_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "clip_table.h"
+#include "render_backend.h"
+
+struct RecordedFrame {
+	uint64_t tick;
+	uint32_t quadCount;
+	// FNV-1a of the batch's vertices, two runs that drew the same thing have the same checksums
+	uint64_t checksum;
+};
+
+/**
+* A RenderBackend without a GPU, it records what every submitted batch contained. Used for headless runs and
+* to compare what two builds drew
+*/
+class RecordingBackend final : public RenderBackend {
+public:
+
+	/**
+	* @param clips - Resolves the frames of animated vertices the way the shader would, so the checksums cover the
+	* frames that would be shown; when null, the vertices are checksummed as they are
+	*/
+	explicit RecordingBackend(const ClipTable* clips = nullptr) noexcept : mClips(clips) {}
+
+	void submit(const SpriteBatch& batch, const Camera*) noexcept override {
+
+		uint64_t hash = 14695981039346656037ull;
+		const uint32_t vertexCount = 4u * batch.getQuadCount();
+		for (uint32_t v = 0u; v < vertexCount; v++) {
+			Vertex vertex = batch.getVertices()[v];
+			if (mClips != nullptr) {
+				vertex.texCoords = mClips->resolve(vertex, v & 3u, static_cast<uint32_t>(batch.tick));
+			}
+
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+			for (size_t i = 0u; i < sizeof(Vertex); i++) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+		}
+
+		mFrames.push_back({ batch.tick, batch.getQuadCount(), hash });
+	}
+
+	/**
+	* @return A timer that times nothing, there is no GPU
+	*/
+	GpuTimer& getGpuTimer() noexcept override {
+		return mGpuTimer;
+	}
+
+	inline const std::vector<RecordedFrame>& getFrames() const noexcept {
+		return mFrames;
+	}
+
+	inline void clear() noexcept {
+		mFrames.clear();
+	}
+
+	/**
+	* @brief Makes room for frames, so recording them does not allocate
+	*/
+	inline void reserve(size_t frames) {
+		mFrames.reserve(frames);
+	}
+
+private:
+	const ClipTable* mClips;
+	std::vector<RecordedFrame> mFrames;
+	NullGpuTimer mGpuTimer;
+};
+
+#endif // !RECORDING_BACKEND_H_
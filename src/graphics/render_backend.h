@@ -0,0 +1,27 @@
+#ifndef RENDER_BACKEND_H_
+#define RENDER_BACKEND_H_
+
+#include "gpu_timer.h"
+#include "sprite_batch.h"
+
+class Camera;
+
+/**
+* Where a finished SpriteBatch goes: the GL Renderer draws it, the RecordingBackend keeps a record of it for headless runs
+*/
+class RenderBackend {
+public:
+	virtual ~RenderBackend() = default;
+
+	/**
+	* @brief Draws the batch with the camera's projection; called on the thread that owns the backend
+	*/
+	virtual void submit(const SpriteBatch& batch, const Camera* camera) noexcept = 0;
+
+	/**
+	* @return What times the backend's GPU work, and any other GPU pass drawn into the same frame
+	*/
+	virtual GpuTimer& getGpuTimer() noexcept = 0;
+};
+
+#endif // !RENDER_BACKEND_H_
@@ -0,0 +1,70 @@
+#ifndef RENDER_LIST_H_
+#define RENDER_LIST_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "animation.h"
+
+struct SpriteInstance {
+	glm::vec2 position;
+	// the sprite, unused when the instance plays a clip
+	uint16_t sprite;
+	uint16_t clip;
+	// the tick the clip started at
+	uint32_t start;
+};
+
+static_assert(sizeof(SpriteInstance) == 16, "Sprite instances are written for every sprite of every frame, keep them small");
+
+/**
+* Everything one tick wants drawn, as plain sprite ids and positions. The simulation fills it and the render side
+* reads it, it holds no GL state so it can be built on any thread. Animated sprites are listed by clip and start
+* tick, the GPU picks their frame
+*/
+class RenderList final {
+public:
+
+	inline void clear() noexcept {
+		mSprites.clear();
+	}
+
+	inline void buffer(glm::vec2 position, uint32_t sprite) {
+		append(position, static_cast<uint16_t>(sprite), Clips::NONE, 0u);
+	}
+
+	/**
+	* @brief Buffers a sprite that plays the clip from the start tick
+	*/
+	inline void bufferClip(glm::vec2 position, uint16_t clip, uint32_t start) {
+		append(position, Sprites::NONE, clip, start);
+	}
+
+	inline uint32_t size() const noexcept {
+		return static_cast<uint32_t>(mSprites.size());
+	}
+
+	inline const SpriteInstance* data() const noexcept {
+		return mSprites.data();
+	}
+
+	// the tick of the level this list was built from
+	uint64_t tick{ 0u };
+
+private:
+
+	// written in place : copying in a temporary built from 2 and 4 byte fields stalls on every sprite
+	inline void append(glm::vec2 position, uint16_t sprite, uint16_t clip, uint32_t start) {
+		SpriteInstance& instance = mSprites.emplace_back();
+		instance.position = position;
+		instance.sprite = sprite;
+		instance.clip = clip;
+		instance.start = start;
+	}
+
+	std::vector<SpriteInstance> mSprites;
+};
+
+#endif // !RENDER_LIST_H_
@@ -1,61 +1,8 @@
 #include "renderer.h"
 
-/**
-* @brief Creates the indices for a Quad in an index buffer
-* @param count - The place to write the data to in the index buffer
-* @param indexData - The index buffer to write to
-*/
-void Renderer::createQuadIndices() noexcept
-{
-    /**
-    * @note - fill index data
-    *                         ____
-    * First triangle [0 -> 2]:|  /
-    *                         | /
-    *                         |/
-    */
-    indexData[count * 6 + 0] = count * 4 + 0;
-    indexData[count * 6 + 1] = count * 4 + 1;
-    indexData[count * 6 + 2] = count * 4 + 2;
-    /**
-    * Second triangle [3 -> 5]: /|
-    *                          / |
-    *                         /__|
-    */
-    indexData[count * 6 + 3] = count * 4 + 1;
-    indexData[count * 6 + 4] = count * 4 + 2;
-    indexData[count * 6 + 5] = count * 4 + 3;
-}
+#include "../core/profiler/profiler.h"
 
-/**
-* @brief Creates the vertices for a Quad in an vertex buffer
-* @param count - The place to write the data to in the index buffer
-* @param vertexData - The vertex buffer to write to
-* @param sprite - The Sprite the quad will have
-* @param origin - The position the Quad will be placed in the world
-* @param width - The width of the quad ; default = 1.0f
-* @param height - The height of the quad ; default = 1.0f
-*/
-void Renderer::createQuadVertices(const Sprite* sprite, glm::vec2 origin) noexcept
-{
-    // default size is 16 x 16 px
-    float width = (float)sprite->getWidth() / 16.0f;
-    float height = (float)sprite->getHeight() / 16.0f;
-
-    /**
-    * @note - Fill the vertex data
-    * @index 0 - the Top Left of the quad
-    * @index 1 - the Top Right of the quad
-    * @index 2 - the Bottom Left of the quad
-    * @index 3 - the Bottom Right of the quad
-    */
-    vertexData[count * 4 + 0] = { {origin.x, origin.y + height}, {sprite->topLeft} };
-    vertexData[count * 4 + 1] = { {origin.x + width, origin.y + height}, {sprite->topRight} };
-    vertexData[count * 4 + 2] = { {origin.x, origin.y}, {sprite->bottomLeft} };
-    vertexData[count * 4 + 3] = { {origin.x + width, origin.y}, {sprite->bottomRight} };
-}
-
-Renderer::Renderer() : count(0u), vertexData(nullptr), indexData(nullptr)
+Renderer::Renderer()
 {
     glfwSwapInterval(1); // 60 fps
     glEnable(GL_BLEND); // enable opacity for sprites
@@ -63,33 +10,9 @@ Renderer::Renderer() : count(0u), vertexData(nullptr), indexData(nullptr)
     glClearColor(142.f / 255.f, 144.f / 255.f, 253.f / 255.f, 1.0f);
 
     mShader = ShaderProgram("resources/shaders/textured/vertex.txt", "resources/shaders/textured/fragment.txt");
-    
-    vertexData = new Vertex[4LL * static_cast<long>(mMaxQuads)];
-    indexData = new unsigned int[6LL * static_cast<long>(mMaxQuads)];
 
     // @start sprites setup
-    std::ifstream spritesJson;
-    spritesJson.open("resources/files/texture_atlas.json");
-    nlohmann::json j;
-    spritesJson >> j;
-
-    mSpriteSheet;
-
-    this->spriteCount = j["count"];
-    this->sprites = new Sprite[this->spriteCount];
-
-    const auto spriteData = j["sprites"];
-    for (auto it = spriteData.begin(); it != spriteData.end(); it++) {
-        auto name = it.value()["name"];
-        auto id = it.value()["id"];
-        mSpriteNamesToIndex.insert(std::pair<std::string, int>{ it.value()["name"], it.value()["id"] });
-        this->sprites[it.value()["id"]] = createSprite(
-                &this->mSpriteSheet,
-                it.value()["x"], 
-                it.value()["y"], 
-                it.value()["w"], 
-                it.value()["h"]);
-    }
+    mAtlas.load("resources/files/texture_atlas.json", mSpriteSheet.getWidth(), mSpriteSheet.getHeight());
 
     // setup renderer
     glActiveTexture(GL_TEXTURE1);
@@ -97,7 +20,7 @@ Renderer::Renderer() : count(0u), vertexData(nullptr), indexData(nullptr)
 
     /**
     * @note - vertex data
-    * @size - equal to 10000 quads * 4 vertices * sizeof(Vertex)
+    * @size - equal to mMaxQuads quads * 4 vertices * sizeof(Vertex)
     */
     glGenBuffers(1, &this->vertexBuffer);
     glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuffer);
@@ -105,7 +28,7 @@ Renderer::Renderer() : count(0u), vertexData(nullptr), indexData(nullptr)
 
     /**
     * @note - index data
-    * @size - equal to 10000 quads * 6 indices * sizeof(unsigned int)
+    * @size - equal to mMaxQuads quads * 6 indices * sizeof(unsigned int)
     */
     glGenBuffers(1, &this->indexBuffer);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->indexBuffer);
@@ -121,6 +44,7 @@ Renderer::Renderer() : count(0u), vertexData(nullptr), indexData(nullptr)
     * @note - setup the vertex attributes
     * @first - Attribute for the position of each vertex
     * @second - Atttribute for the texture coordinates of each vertex
+    * @third - Attributes for the clip and start tick of animated vertices, integers
     */
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(0));
@@ -128,8 +52,18 @@ Renderer::Renderer() : count(0u), vertexData(nullptr), indexData(nullptr)
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offsetof(Vertex, texCoords)));
 
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)(offsetof(Vertex, clip)));
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Vertex), (void*)(offsetof(Vertex, start)));
+
+    uploadClipTable();
+
     mShader.use();
     mShader.setInt("sprite_sheet", 0);
+    mShader.setInt("clip_table", 2);
+    mShader.setInt("frame_table", 3);
 }
 
 Renderer::~Renderer() noexcept
@@ -137,63 +71,94 @@ Renderer::~Renderer() noexcept
     glDeleteVertexArrays(1, &this->vertexAttributes);
     glDeleteBuffers(1, &this->vertexBuffer);
     glDeleteBuffers(1, &this->indexBuffer);
-
-    delete[] this->vertexData;
-    delete[] this->indexData;
-
-    delete[] this->sprites;
+    glDeleteTextures(1, &this->clipTexture);
+    glDeleteTextures(1, &this->frameTexture);
+    glDeleteBuffers(1, &this->clipBuffer);
+    glDeleteBuffers(1, &this->frameBuffer);
 }
 
 int Renderer::getSpriteCount(void) const noexcept {
-    return this->spriteCount;
+    return mAtlas.getSpriteCount();
 }
 
 int Renderer::getSpriteID(const std::string& name) const noexcept {
-    if (mSpriteNamesToIndex.find(name) != mSpriteNamesToIndex.end()) {
-        return mSpriteNamesToIndex.at(name);
-    }
-    else {
-        std::cerr << __FUNCTION__ << "Could not find sprite with name \"" << name << "\"\n";
-        return 0;
-    }
+    return mAtlas.getSpriteID(name);
 }
 
-// resets the renderer for the next cycle
-void Renderer::clear(void) noexcept
+void Renderer::uploadClipTable() noexcept
 {
-    this->count = 0;
+    const ClipTable& table = mAtlas.getClipTable();
+
+    // a texture buffer can't be empty, both tables always have at least one texel
+    const ClipRecord noClip{ 0u, 0u, 1u, 0u };
+    const FrameRect noFrame{};
+    const void* clips = table.getClips().empty() ? (const void*)&noClip : (const void*)table.getClips().data();
+    const void* frames = table.getFrames().empty() ? (const void*)&noFrame : (const void*)table.getFrames().data();
+    const size_t clipCount = table.getClips().empty() ? 1u : table.getClips().size();
+    const size_t frameCount = table.getFrames().empty() ? 1u : table.getFrames().size();
+
+    glGenBuffers(1, &this->clipBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, this->clipBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(ClipRecord) * clipCount, clips, GL_STATIC_DRAW);
+
+    glGenBuffers(1, &this->frameBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, this->frameBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(FrameRect) * frameCount, frames, GL_STATIC_DRAW);
+
+    glGenTextures(1, &this->clipTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, this->clipTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, this->clipBuffer);
+
+    glGenTextures(1, &this->frameTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, this->frameTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, this->frameBuffer);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
 }
 
-// buffer a new sprite
-void Renderer::buffer(glm::vec2 position, uint32_t spriteIndex) noexcept
+void Renderer::reserveQuads(uint32_t quads) noexcept
 {
-    createQuadIndices();
-    createQuadVertices(&sprites[spriteIndex], position);
+    if (quads <= mMaxQuads) { return; }
 
-    this->count++;
+    // grow by half again, so a slowly growing level doesn't reallocate every frame
+    mMaxQuads = quads + quads / 2u;
 }
 
-// draws everything that has been buffered
-void Renderer::render(const Camera* camera) noexcept
+// draws the batch
+void Renderer::submit(const SpriteBatch& batch, const Camera* camera) noexcept
 {
+    PROFILE_SCOPE("Renderer::submit");
+    GpuPass pass(&mGpuTimer, "GPU sprites");
+
     /** @note we just need projection here */
     mShader.use();
     mShader.setMat4("projection", camera->getProjection());
+    // animated vertices pick their frame from the tick the batch was built at
+    mShader.setUint("tick", static_cast<unsigned int>(batch.tick));
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, this->clipTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, this->frameTexture);
 
     glActiveTexture(GL_TEXTURE1);
 
-    if (this->count > 0)
+    const uint32_t count = batch.getQuadCount();
+    if (count > 0)
     {
+        reserveQuads(count);
+
         glBindVertexArray(this->vertexAttributes);
 
+        // orphan the old storage so the driver doesn't wait on the last frame's draw
         glBindBuffer(GL_ARRAY_BUFFER, this->vertexBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * 4 * mMaxQuads, NULL, GL_DYNAMIC_DRAW);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * 4 * this->count, vertexData);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * 4 * count, batch.getVertices());
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->indexBuffer);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * 6 * mMaxQuads, NULL, GL_DYNAMIC_DRAW);
-        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(unsigned int) * 6 * this->count, indexData);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(unsigned int) * 6 * count, batch.getIndices());
 
-        glDrawElements(GL_TRIANGLES, 6 * this->count, GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_INT, 0);
     }
 }
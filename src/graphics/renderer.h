@@ -1,20 +1,21 @@
 #ifndef RENDERER_H_
 #define RENDERER_H_
 
-#include <map>
-
 #include "../core/camera.h"
 #include "../core/transform.h"
 #include "../graphics/shader_program.h"
 #include "../graphics/sprite_sheet.h"
-#include "../core/transform.h"
 #include "../graphics/animator.h"
 #include "../graphics/sprite.h"
+#include "../graphics/sprite_atlas.h"
 #include "../graphics/vertex.h"
-#include "../core/camera.h"
-#include "../core/json.h"
+#include "../graphics/render_backend.h"
+#include "../graphics/query_gpu_timer.h"
 
-class Renderer
+/**
+* The OpenGL RenderBackend, owns the sprite sheet texture and the buffers the batches are uploaded into
+*/
+class Renderer final : public RenderBackend
 {
 public:
     friend class Editor;
@@ -22,47 +23,57 @@ public:
     explicit Renderer();
     ~Renderer() noexcept;
 
-    void buffer(glm::vec2 position, uint32_t spriteIndex) noexcept;
+    /**
+    * @brief Uploads the batch and draws it
+    */
+    void submit(const SpriteBatch& batch, const Camera* camera) noexcept override;
 
-    void clear() noexcept;
-
-    void render(const Camera* camera) noexcept;
+    inline GpuTimer& getGpuTimer() noexcept override {
+        return mGpuTimer;
+    }
 
     int getSpriteCount(void) const noexcept;
 
     int getSpriteID(const std::string& name) const noexcept;
 
-private:
-
-    void createQuadIndices() noexcept;
-    void createQuadVertices(const Sprite* sprite, glm::vec2 origin) noexcept;
+    inline const SpriteAtlas& getAtlas() const noexcept {
+        return mAtlas;
+    }
 
 private:
 
-    std::map<std::string, int> mSpriteNamesToIndex;
+    /**
+    * @brief Reallocates the GPU buffers if the batch has more quads than they can hold
+    */
+    void reserveQuads(uint32_t quads) noexcept;
 
-    GLFWwindow* mWindow;
-    ShaderProgram mShader;
+    /**
+    * @brief Uploads the atlas's clip table into the texture buffers the shader resolves animated vertices with
+    */
+    void uploadClipTable() noexcept;
 
-    // TODO: make sure this is dynamic, in case we go over this limit
-    int mMaxQuads = 10000;
+    ShaderProgram mShader;
 
-    int count;
+    // The number of quads the GPU buffers can hold, grows with the biggest batch
+    uint32_t mMaxQuads = 10000u;
 
     GLuint vertexAttributes;
 
     GLuint vertexBuffer;
     GLuint indexBuffer;
 
-    Vertex* vertexData;
-    GLuint* indexData;
+    // The clip table and the frame table (see ClipTable), as texture buffers on units 2 and 3
+    GLuint clipBuffer;
+    GLuint clipTexture;
+    GLuint frameBuffer;
+    GLuint frameTexture;
 
     // TODO fix
     SpriteSheet mSpriteSheet = loadSpriteSheet("resources/sprites/smb1_sprites.png");
 
-    Sprite* sprites;
-    int spriteCount;
+    SpriteAtlas mAtlas;
+
+    QueryGpuTimer mGpuTimer;
 };
 
 #endif // !RENDERER_H_
-
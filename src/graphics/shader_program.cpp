@@ -87,6 +87,11 @@ void ShaderProgram::setInt(const char* uniformName, int value) const
     glUniform1i(this->getUniformLocation(uniformName), value);
 }
 
+void ShaderProgram::setUint(const char* uniformName, unsigned int value) const
+{
+    glUniform1ui(this->getUniformLocation(uniformName), value);
+}
+
 void ShaderProgram::setFloat(const char* uniformName, float value) const
 {
     glUniform1f(this->getUniformLocation(uniformName), value);
@@ -33,6 +33,7 @@ public:
 
     void setBool (const char* uniformName, bool  value) const;
     void setInt  (const char* uniformName, int   value) const;
+    void setUint (const char* uniformName, unsigned int value) const;
     void setFloat(const char* uniformName, float value) const;
 
     void setVec2(const char* uniformName, const glm::vec2& value)             const;
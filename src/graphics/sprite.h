@@ -43,32 +43,33 @@ struct Sprite
 */
 
 /**
-* @brief Creates a sprite given a sprite sheet
-* @param spriteSheet - The SpriteSheet to source from ; sprites are unique to a single SpriteSheet
+* @brief Creates a sprite from its place in a sprite sheet of the given size, no texture needed
+* @param sheetWidth - The width of the whole sprite sheet (in pixels)
+* @param sheetHeight - The height of the whole sprite sheet (in pixels)
 * @param origin - The origin of the image in an image editor, usually the top left (in pixels)
 * @param width - The desired width of the sprite (in pixels) ; default = 16 pixels
 * @param height - The desired height of the sprite (in pixels) ; default = 16 pixels
 */
-static Sprite createSprite(const SpriteSheet* spriteSheet, int x, int y,
+static Sprite createSprite(unsigned int sheetWidth, unsigned int sheetHeight, int x, int y,
 	int width = 16u, int height = 16u) noexcept
 {
-	float sheetWidth = (float)spriteSheet->getWidth();
-	float sheetHeight = (float)spriteSheet->getHeight();
+	const float w = (float)sheetWidth;
+	const float h = (float)sheetHeight;
 
 	Sprite sprite;
 	/** @note - all coordinates range from 0.0f to 1.0f */
 
 	// top left
-	sprite.topLeft = { (float)x / sheetWidth, (float)y / sheetHeight };
+	sprite.topLeft = { (float)x / w, (float)y / h };
 
 	// bottom left
-	sprite.bottomLeft = { (float)x / sheetWidth, ((float)y + (float)height) / sheetHeight };
+	sprite.bottomLeft = { (float)x / w, ((float)y + (float)height) / h };
 	
 	// top right
-	sprite.topRight = { ((float)x + (float)width) / sheetWidth, (float)y / sheetHeight };
+	sprite.topRight = { ((float)x + (float)width) / w, (float)y / h };
 
 	// bottom right
-	sprite.bottomRight = { ((float)x + (float)width) / sheetWidth, ((float)y + (float)height) / sheetHeight };
+	sprite.bottomRight = { ((float)x + (float)width) / w, ((float)y + (float)height) / h };
 
 	// width and height
 	sprite.width = width;
@@ -77,6 +78,19 @@ static Sprite createSprite(const SpriteSheet* spriteSheet, int x, int y,
 	return sprite;
 }
 
+/**
+* @brief Creates a sprite given a sprite sheet
+* @param spriteSheet - The SpriteSheet to source from ; sprites are unique to a single SpriteSheet
+* @param origin - The origin of the image in an image editor, usually the top left (in pixels)
+* @param width - The desired width of the sprite (in pixels) ; default = 16 pixels
+* @param height - The desired height of the sprite (in pixels) ; default = 16 pixels
+*/
+static Sprite createSprite(const SpriteSheet* spriteSheet, int x, int y,
+	int width = 16u, int height = 16u) noexcept
+{
+	return createSprite(spriteSheet->getWidth(), spriteSheet->getHeight(), x, y, width, height);
+}
+
 /**
 * @brief Creates a sprite given a sprite sheet and coordinates
 * @note - A sprite at coordinates 48, 16 should be recieving (x, y) pair of (3, 1)
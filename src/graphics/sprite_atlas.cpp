@@ -0,0 +1,73 @@
+#include "sprite_atlas.h"
+
+#include <fstream>
+
+#include "../core/json.h"
+
+bool SpriteAtlas::load(const std::string& path, unsigned int sheetWidth, unsigned int sheetHeight)
+{
+    std::ifstream spritesJson(path);
+    if (!spritesJson.is_open()) {
+        std::cerr << __FUNCTION__ << " Could not open sprite atlas \"" << path << "\"\n";
+        mSprites.assign(1u, Sprite{});
+        return false;
+    }
+
+    nlohmann::json j;
+    spritesJson >> j;
+
+    // always keep sprite 0 around, out of range ids fall back to it
+    const int count = j["count"].get<int>();
+    mSprites.assign(count > 0 ? count : 1, Sprite{});
+    mSpriteNamesToIndex.clear();
+
+    for (const auto& sprite : j["sprites"]) {
+        const int id = sprite["id"].get<int>();
+        if (id < 0 || id >= static_cast<int>(mSprites.size())) { continue; }
+
+        mSpriteNamesToIndex.insert({ sprite["name"].get<std::string>(), id });
+        mSprites[id] = createSprite(sheetWidth, sheetHeight,
+            sprite["x"].get<int>(),
+            sprite["y"].get<int>(),
+            sprite["w"].get<int>(),
+            sprite["h"].get<int>());
+    }
+
+    // the clips name their frames, so they are read once every sprite has its id
+    mAnimations.clear();
+    if (j.contains("animations")) {
+        std::vector<uint32_t> frames;
+        for (const auto& clip : j["animations"]) {
+            const int id = clip["id"].get<int>();
+            if (id <= 0 || id > UINT16_MAX) { continue; }
+
+            frames.clear();
+            for (const auto& frame : clip["frames"]) {
+                frames.push_back(static_cast<uint32_t>(getSpriteID(frame.get<std::string>())));
+            }
+            mAnimations.set(static_cast<uint16_t>(id), frames, static_cast<uint16_t>(clip["duration"].get<int>()));
+
+            // tiles drawn with the first frame play the whole clip
+            if (clip.contains("tiles") && clip["tiles"].get<bool>() && !frames.empty()) {
+                mAnimations.setTileClip(frames[0], static_cast<uint16_t>(id));
+            }
+        }
+    }
+    mClipTable.build(mAnimations, *this);
+
+    return true;
+}
+
+int SpriteAtlas::getSpriteCount(void) const noexcept {
+    return static_cast<int>(mSprites.size());
+}
+
+int SpriteAtlas::getSpriteID(const std::string& name) const noexcept {
+    const auto it = mSpriteNamesToIndex.find(name);
+    if (it != mSpriteNamesToIndex.end()) {
+        return it->second;
+    }
+
+    std::cerr << __FUNCTION__ << "Could not find sprite with name \"" << name << "\"\n";
+    return 0;
+}
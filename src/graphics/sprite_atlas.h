@@ -0,0 +1,55 @@
+#ifndef SPRITE_ATLAS_H_
+#define SPRITE_ATLAS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "animation.h"
+#include "clip_table.h"
+#include "sprite.h"
+
+/**
+* The sprites of the texture atlas (resources/files/texture_atlas.json), by id and by name, and the animation clips
+* made of them, also laid out for the GPU. Only the size of the sprite sheet is needed to build it, so it works
+* without a GL context
+*/
+class SpriteAtlas final {
+public:
+
+	/**
+	* @brief Reads the atlas description, sprites and animations
+	* @param path - The path to the atlas json
+	* @param sheetWidth - The width of the sprite sheet the atlas describes (in pixels)
+	* @param sheetHeight - The height of the sprite sheet (in pixels)
+	* @return false if the file could not be read
+	*/
+	bool load(const std::string& path, unsigned int sheetWidth, unsigned int sheetHeight);
+
+	int getSpriteCount(void) const noexcept;
+
+	int getSpriteID(const std::string& name) const noexcept;
+
+	/**
+	* @return The sprite with the id, ids out of range get sprite 0
+	*/
+	inline const Sprite& getSprite(uint32_t id) const noexcept {
+		return mSprites[id < mSprites.size() ? id : 0u];
+	}
+
+	inline const AnimationTable& getAnimations() const noexcept {
+		return mAnimations;
+	}
+
+	inline const ClipTable& getClipTable() const noexcept {
+		return mClipTable;
+	}
+
+private:
+	std::vector<Sprite> mSprites;
+	AnimationTable mAnimations;
+	ClipTable mClipTable;
+	std::map<std::string, int> mSpriteNamesToIndex;
+};
+
+#endif // !SPRITE_ATLAS_H_
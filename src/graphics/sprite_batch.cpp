@@ -0,0 +1,63 @@
+#include "sprite_batch.h"
+
+#include "../core/profiler/profiler.h"
+
+void SpriteBatch::build(const RenderList& list, const SpriteAtlas& atlas)
+{
+    PROFILE_SCOPE("SpriteBatch::build");
+
+    const uint32_t quads = list.size();
+
+    if (mVertices.size() < 4ull * quads) {
+        mVertices.resize(4ull * quads);
+    }
+
+    // the indices are the same every frame, only the new ones are written
+    const uint32_t indexedQuads = static_cast<uint32_t>(mIndices.size() / 6u);
+    if (indexedQuads < quads) {
+        mIndices.resize(6ull * quads);
+        for (uint32_t q = indexedQuads; q < quads; q++) {
+            /**
+            * @note - First triangle [0 -> 2], second triangle [3 -> 5]
+            *   ____       /|
+            *   |  /      / |
+            *   | /      /  |
+            *   |/      /___|
+            */
+            mIndices[q * 6 + 0] = q * 4 + 0;
+            mIndices[q * 6 + 1] = q * 4 + 1;
+            mIndices[q * 6 + 2] = q * 4 + 2;
+            mIndices[q * 6 + 3] = q * 4 + 1;
+            mIndices[q * 6 + 4] = q * 4 + 2;
+            mIndices[q * 6 + 5] = q * 4 + 3;
+        }
+    }
+
+    const AnimationTable& animations = atlas.getAnimations();
+    const SpriteInstance* instances = list.data();
+    for (uint32_t q = 0u; q < quads; q++) {
+        // a clip's quad is the size of its first frame, the shader swaps in the frame's texture coordinates
+        const uint16_t clip = instances[q].clip;
+        const uint32_t start = instances[q].start;
+        const Sprite& sprite = atlas.getSprite(clip != Clips::NONE ? animations.frame(clip, 0u, 0u) : instances[q].sprite);
+        const glm::vec2 origin = instances[q].position;
+
+        // default size is 16 x 16 px
+        const float width = (float)sprite.getWidth() / 16.0f;
+        const float height = (float)sprite.getHeight() / 16.0f;
+
+        /**
+        * @index 0 - the Top Left of the quad
+        * @index 1 - the Top Right of the quad
+        * @index 2 - the Bottom Left of the quad
+        * @index 3 - the Bottom Right of the quad
+        */
+        mVertices[q * 4 + 0] = { {origin.x, origin.y + height}, {sprite.topLeft}, clip, start };
+        mVertices[q * 4 + 1] = { {origin.x + width, origin.y + height}, {sprite.topRight}, clip, start };
+        mVertices[q * 4 + 2] = { {origin.x, origin.y}, {sprite.bottomLeft}, clip, start };
+        mVertices[q * 4 + 3] = { {origin.x + width, origin.y}, {sprite.bottomRight}, clip, start };
+    }
+
+    mQuadCount = quads;
+    tick = list.tick;
+}
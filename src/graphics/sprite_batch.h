@@ -0,0 +1,47 @@
+#ifndef SPRITE_BATCH_H_
+#define SPRITE_BATCH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "vertex.h"
+#include "render_list.h"
+#include "sprite_atlas.h"
+
+/**
+* The vertices and indices of a RenderList, one textured quad per sprite. Building it is all CPU work,
+* a RenderBackend only has to upload and draw it. The buffers grow to the biggest list seen and are reused after that
+*/
+class SpriteBatch final {
+public:
+
+	/**
+	* @brief Replaces the batch with the quads of every sprite in the list
+	*/
+	void build(const RenderList& list, const SpriteAtlas& atlas);
+
+	inline uint32_t getQuadCount() const noexcept {
+		return mQuadCount;
+	}
+
+	inline const Vertex* getVertices() const noexcept {
+		return mVertices.data();
+	}
+
+	/**
+	* @return 6 indices per quad, the index pattern never changes so only the first getQuadCount() * 6 are meaningful
+	*/
+	inline const uint32_t* getIndices() const noexcept {
+		return mIndices.data();
+	}
+
+	// the tick of the list the batch was built from
+	uint64_t tick{ 0u };
+
+private:
+	std::vector<Vertex> mVertices;
+	std::vector<uint32_t> mIndices;
+	uint32_t mQuadCount{ 0u };
+};
+
+#endif // !SPRITE_BATCH_H_
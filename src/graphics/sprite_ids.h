@@ -0,0 +1,130 @@
+#ifndef SPRITE_IDS_H_
+#define SPRITE_IDS_H_
+
+#include <cstdint>
+
+/**
+* The ids of every sprite in resources/files/texture_atlas.json, so simulation code does not need
+* to go through Renderer::getSpriteID
+* @note - Must be kept in sync with the atlas
+*/
+namespace Sprites {
+
+	enum : uint32_t {
+		NONE = 0,
+		GROUND_1 = 1,
+		STONE = 2,
+		BRICK_TOP = 3,
+		BRICK_BOT = 4,
+		COIN_1 = 5,
+		COIN_2 = 6,
+		COIN_3 = 7,
+		QUESTION_BLOCK_1 = 8,
+		QUESTION_BLOCK_2 = 9,
+		QUESTION_BLOCK_3 = 10,
+		QUESTION_BLOCK_HIT = 11,
+		CLOUD = 12,
+		GROUND_2 = 13,
+		FENCE = 14,
+		BRIDGE_TOP = 15,
+		BRIDGE_BOT = 16,
+		MUSH_PLAT_1_TOP_LEFT = 17,
+		MUSH_PLAT_1_TOP_MID = 18,
+		MUSH_PLAT_1_TOP_RIGHT = 19,
+		MUSH_PLAT_1_SEG_TOP = 20,
+		MUSH_PLAT_1_SEG_BOT = 21,
+		MUSH_PLAT_2_TOP_LEFT = 22,
+		MUSH_PLAT_2_TOP_MID = 23,
+		MUSH_PLAT_2_TOP_RIGHT = 24,
+		MUSH_PLAT_2_SEG = 25,
+		GIRDER_PLAT = 26,
+		CLOUD_PLAT = 27,
+		FLAG_POLE_SEG = 28,
+		FLAG_POLE_CAP = 29,
+		FLAG_POLE_FLAG = 30,
+		PIPE_TOP_LEFT = 31,
+		PIPE_TOP_RIGHT = 32,
+		PIPE_SEG_LEFT = 33,
+		PIPE_SEG_RIGHT = 34,
+		PIPE_INTERSECT_TOP = 35,
+		PIPE_INTERSECT_BOT = 36,
+		CASTLE_TOP_FLAG = 37,
+		CASTLE_AXE_1 = 38,
+		CASTLE_AXE_2 = 39,
+		CASTLE_AXE_3 = 40,
+		WATER = 41,
+		WATER_TOP = 42,
+		GREEN_HILL_SLOPE_LEFT = 43,
+		GREEN_HILL_SLOPE_RIGHT = 44,
+		GREEN_HILL_SMOOTH = 45,
+		GREEN_HILL_TEXTURED = 46,
+		GREEN_HILL_CAP = 47,
+		BUSH_LEFT = 48,
+		BUSH_RIGHT = 49,
+		BUSH_MID = 50,
+		CLOUD_TOP_LEFT = 51,
+		CLOUD_TOP_RIGHT = 52,
+		CLOUD_TOP_MID = 53,
+		CLOUD_BOT_LEFT = 54,
+		CLOUD_BOT_RIGHT = 55,
+		CLOUD_BOT_MID = 56,
+		TREE_SEG = 57,
+		TREE_SMALL_TOP = 58,
+		TREE_LARGE_TOP = 59,
+		TREE_LARGE_BOT = 60,
+		VINE_TOP = 61,
+		VINE_BOT = 62,
+		SPRING_1 = 63,
+		SPRING_2_TOP = 64,
+		SPRING_2_BOT = 65,
+		SPRING_3_TOP = 66,
+		SPRING_3_BOT = 67,
+		BB_LAUNCHER_TOP = 68,
+		BB_LAUNCHER_BOT = 69,
+		BB_LAUNCHER_SEG = 70,
+		COIN_P_1 = 71,
+		COIN_P_2 = 72,
+		COIN_P_3 = 73,
+		COIN_P_4 = 74,
+		GOOMBA_1 = 75,
+		GOOMBA_2 = 76,
+		GOOMBA_STOMPED = 77,
+		CHEEP_RED_1 = 78,
+		CHEEP_RED_2 = 79,
+		CHEEP_GREEN_1 = 80,
+		CHEEP_GREEN_2 = 81,
+		BEETLE_1 = 82,
+		BEETLE_2 = 83,
+		BEETLE_STOMPED = 84,
+		SPINY_1 = 85,
+		SPINY_2 = 86,
+		SPINY_BALL_1 = 87,
+		SPINY_BALL_2 = 88,
+		BLOOPER_1 = 89,
+		BLOOPER_2 = 90,
+		LAKITU_STOMPED = 91,
+		LAKITU = 92,
+		BULLET_BILL = 93,
+		PIRHANA_OPEN = 94,
+		PIRHANA_CLOSED = 95,
+		BOWSER_1 = 96,
+		BOWSER_2 = 97,
+		BOWSER_3 = 98,
+		BOWSER_4 = 99,
+		BOWSER_FIRE_1 = 100,
+		BOWSER_FIRE_2 = 101,
+		MUSHROOM_GREEN = 102,
+		MUSHROOM_RED = 103,
+		FIRE_FLOWER = 104,
+		STARMAN = 105,
+		MARIO_SMALL_STILL = 106,
+		MARIO_SMALL_DEAD = 107,
+		MARIO_SMALL_TURN = 108,
+		MARIO_SMALL_WALK_1 = 109,
+		MARIO_SMALL_WALK_2 = 110,
+		MARIO_SMALL_RUN = 111,
+		MARIO_SMALL_JUMP = 112,
+	};
+}
+
+#endif // !SPRITE_IDS_H_
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <cstdint>
+
 #include <glm/vec2.hpp>
 
 struct Vertex
 {
 	glm::vec2 position;
 	glm::vec2 texCoords;
-};
\ No newline at end of file
+	// the animation clip the quad plays (0 for none, texCoords are used as is) and the tick it started at,
+	// the shader picks the frame's texture coordinates from the clip table
+	uint32_t clip;
+	uint32_t start;
+};
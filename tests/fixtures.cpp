@@ -0,0 +1,36 @@
+#include "fixtures.h"
+
+#include "../src/app/headless.h"
+#include "../src/core/level/level.h"
+#include "../src/graphics/sprite_ids.h"
+
+namespace fixtures {
+
+    void buildGround(Level& level, int width, int height) {
+
+        level.resizeTiles(width, height);
+
+        for (int x = 0; x < width; x++) {
+            level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1), x, 0);
+            level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1), x, 1);
+        }
+    }
+
+    void loadStage(Level& level) {
+        loadHeadlessLevel(level, nullptr);
+        level.play = true;
+        level.getPlayer(0)->position = { 4.0f, 2.0f };
+    }
+
+    std::vector<InputState> scriptedInput(uint32_t ticks) {
+        std::vector<InputState> frames(ticks);
+        for (uint32_t t = 0u; t < ticks; t++) {
+            uint16_t buttons = t % 240u < 200u ? INPUT_RIGHT | INPUT_RUN : INPUT_LEFT;
+            if (t % 45u < 18u) {
+                buttons |= INPUT_JUMP;
+            }
+            frames[t].buttons = buttons;
+        }
+        return frames;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef TEST_FIXTURES_H_
+#define TEST_FIXTURES_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "../src/core/controller.h"
+
+class Level;
+
+/**
+* What the cases run on, built the same way every run
+*/
+namespace fixtures {
+
+    /**
+    * @brief Resizes the level to width x height and lays two rows of ground, the rest is empty
+    */
+    void buildGround(Level& level, int width, int height);
+
+    /**
+    * @brief Loads the generated test stage of headless runs (see loadHeadlessLevel) to play, with the player standing
+    * on the ground at column 4 rather than inside it
+    */
+    void loadStage(Level& level);
+
+    /**
+    * @return Input for that many ticks that gets a player moving : running right, jumping every so often, and a
+    * few stretches back to the left
+    */
+    std::vector<InputState> scriptedInput(uint32_t ticks);
+}
+
+#endif // !TEST_FIXTURES_H_
@@ -0,0 +1,21 @@
+#include "test.h"
+
+#include <cstdio>
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    // platformer_tests [--list] [case...]
+    std::vector<std::string> names;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--list") == 0) {
+            for (const std::string& name : test::caseNames()) {
+                std::printf("%s\n", name.c_str());
+            }
+            return 0;
+        }
+        names.push_back(argv[i]);
+    }
+
+    return test::runCases(names);
+}
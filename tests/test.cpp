@@ -0,0 +1,74 @@
+#include "test.h"
+
+#include <cstdio>
+#include <map>
+
+namespace test {
+
+    namespace {
+
+        std::map<std::string, Case>& cases() {
+            static std::map<std::string, Case> registered;
+            return registered;
+        }
+    }
+
+    bool Context::check(bool condition, const char* expression, const char* file, int line) noexcept {
+        if (!condition) {
+            mFailures++;
+            std::printf("  %s:%d : CHECK(%s) failed\n", file, line, expression);
+            std::fflush(stdout);
+        }
+        return condition;
+    }
+
+    void Context::skip(const char* reason) noexcept {
+        mSkipped = true;
+        std::printf("  skipped : %s\n", reason);
+    }
+
+    int registerCase(const char* name, Case test) noexcept {
+        cases()[name] = test;
+        return static_cast<int>(cases().size());
+    }
+
+    std::vector<std::string> caseNames() {
+        std::vector<std::string> names;
+        for (const auto& registered : cases()) {
+            names.push_back(registered.first);
+        }
+        return names;
+    }
+
+    int runCases(const std::vector<std::string>& names) {
+        const std::vector<std::string> run = names.empty() ? caseNames() : names;
+
+        uint32_t failed = 0u, skipped = 0u;
+        for (const std::string& name : run) {
+            const auto found = cases().find(name);
+            if (found == cases().end()) {
+                std::printf("%-40s unknown case\n", name.c_str());
+                failed++;
+                continue;
+            }
+
+            std::printf("%s\n", name.c_str());
+            std::fflush(stdout);
+
+            Context context;
+            found->second(context);
+            if (context.failed()) { failed++; }
+            else if (context.skipped()) { skipped++; }
+            std::printf("%-40s %s\n", name.c_str(), context.failed() ? "FAILED" : context.skipped() ? "skipped" : "passed");
+            std::fflush(stdout);
+        }
+
+        std::printf("\n%u cases, %u failed, %u skipped\n", static_cast<unsigned>(run.size()), failed, skipped);
+        if (failed > 0u) { return 1; }
+        return skipped == run.size() ? SKIPPED : 0;
+    }
+
+    std::string outputPath(const char* name) {
+        return std::string(PLATFORMER_TEST_OUTPUT_DIR) + "/" + name;
+    }
+}
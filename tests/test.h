@@ -0,0 +1,74 @@
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+* A small test harness : cases register themselves with TEST_CASE, and report through a Context. A failed CHECK is
+* printed and the case carries on, so one run shows everything that is wrong with it
+*/
+namespace test {
+
+    class Context final {
+    public:
+
+        /**
+        * @brief Fails the case if the condition is false, see CHECK
+        * @return The condition, for a case to stop when what follows depends on it
+        */
+        bool check(bool condition, const char* expression, const char* file, int line) noexcept;
+
+        /**
+        * @brief Marks the case as skipped : what it tests is not in this build or on this machine, see SKIP
+        */
+        void skip(const char* reason) noexcept;
+
+        inline bool failed() const noexcept {
+            return mFailures > 0u;
+        }
+
+        inline bool skipped() const noexcept {
+            return mSkipped;
+        }
+
+    private:
+        uint32_t mFailures{ 0u };
+        bool mSkipped{ false };
+    };
+
+    using Case = void(*)(Context& context);
+
+    /**
+    * @brief Adds a case, cases run in the order of their names
+    */
+    int registerCase(const char* name, Case test) noexcept;
+
+    std::vector<std::string> caseNames();
+
+    /**
+    * @brief Runs the cases with the names, or every case when there are none
+    * @return 0 if they all passed, 1 if one failed or does not exist, SKIPPED if every case run was skipped
+    */
+    int runCases(const std::vector<std::string>& names);
+
+    // what a run where everything was skipped exits with, CTest's SKIP_RETURN_CODE
+    static constexpr int SKIPPED = 77;
+
+    /**
+    * @return A path for a file the case writes, in the tests' build directory
+    */
+    std::string outputPath(const char* name);
+}
+
+#define TEST_CASE(name) \
+    static void testCase_##name(test::Context& context); \
+    static const int testCaseRegistered_##name = test::registerCase(#name, &testCase_##name); \
+    static void testCase_##name(test::Context& context)
+
+#define CHECK(condition) context.check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#define SKIP(reason) do { context.skip(reason); return; } while (false)
+
+#endif // !TEST_H_
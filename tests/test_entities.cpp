@@ -0,0 +1,174 @@
+#include "test.h"
+
+#include <cstring>
+#include <random>
+
+#include "../src/core/level/entity/entity_store.h"
+#include "../src/core/level/entity/motion.h"
+
+namespace {
+
+    // kills the entity the way the kernels do, the death clip keeps it around until it is done
+    void kill(EntityStore& store, EntityId id, uint16_t clip = Clips::NONE) {
+        const EntityHandle handle = store.resolve(id);
+        EntityBlock& block = store.block(id.type());
+        block.flags[handle.index()] &= static_cast<uint8_t>(~ENTITY_ALIVE);
+        block.clip[handle.index()] = clip;
+    }
+
+    uint64_t sleepingHash(const EntityBlock& block) {
+        uint64_t h = 0u;
+        for (uint32_t i = block.awake; i < block.size(); i++) {
+            h ^= block.hash(i);
+        }
+        return h;
+    }
+}
+
+TEST_CASE(entity_store_spawn_kill_compact)
+{
+    EntityStore store;
+    EntityId ids[6];
+    for (uint32_t i = 0u; i < 6u; i++) {
+        ids[i] = store.spawn(EntityType::GOOMBA, { static_cast<float>(i), 2.0f });
+        CHECK(!ids[i].null());
+        CHECK(ids[i].type() == EntityType::GOOMBA);
+    }
+    CHECK(store.count() == 6u);
+    CHECK(store.awakeCount() == 6u);
+
+    // 4 and 5 sleep, 1 dies, 3 dies playing its death clip
+    EntityBlock& block = store.block(EntityType::GOOMBA);
+    block.sleep(store.resolve(ids[4]).index());
+    block.sleep(store.resolve(ids[5]).index());
+    kill(store, ids[1]);
+    kill(store, ids[3], Clips::GOOMBA_STOMPED);
+
+    CHECK(store.compact() == 1u);
+    CHECK(store.count() == 5u);
+    CHECK(!store.resolve(ids[1]).valid());
+
+    // the rest keep their ids, their state and whether they sleep
+    for (const uint32_t i : { 0u, 2u, 3u, 4u, 5u }) {
+        const EntityHandle handle = store.resolve(ids[i]);
+        if (!CHECK(handle.valid())) { continue; }
+        CHECK(handle.id() == ids[i]);
+        CHECK(handle.position().x == static_cast<float>(i));
+        CHECK(handle.awake() == (i < 4u));
+    }
+    CHECK(block.awake == 3u);
+    CHECK(block.sleepingHash == sleepingHash(block));
+
+    // once its clip ends the dead entity goes too
+    block.clip[store.resolve(ids[3]).index()] = Clips::NONE;
+    CHECK(store.compact() == 1u);
+    CHECK(!store.resolve(ids[3]).valid());
+    CHECK(store.count() == 4u);
+    CHECK(block.awake == 2u);
+
+    store.clear();
+    CHECK(store.count() == 0u);
+    CHECK(!store.resolve(ids[0]).valid());
+    CHECK(block.sleepingHash == 0u);
+}
+
+TEST_CASE(entity_store_reuses_slots_with_new_generations)
+{
+    EntityStore store;
+    const EntityId first = store.spawn(EntityType::GREEN_KOOPA, { 1.0f, 2.0f });
+    const EntityId other = store.spawn(EntityType::GREEN_KOOPA, { 5.0f, 2.0f });
+
+    // a freed slot is the next one taken, under a generation the old id does not have
+    EntityId previous = first;
+    for (uint32_t round = 0u; round < EntityId::GENERATION_MASK + 5u; round++) {
+        kill(store, previous);
+        store.compact();
+
+        const EntityId next = store.spawn(EntityType::GREEN_KOOPA, { 3.0f, 2.0f });
+        if (!CHECK(next.slot() == first.slot())) { break; }
+        CHECK(next.generation() != previous.generation());
+        CHECK(next.generation() != 0u);
+        CHECK(!store.resolve(previous).valid());
+        CHECK(store.resolve(next).valid());
+        previous = next;
+    }
+
+    // no new slot was made, and the untouched entity never moved slots
+    CHECK(store.block(EntityType::GREEN_KOOPA).generation.size() == 2u);
+    CHECK(store.resolve(other).valid());
+    CHECK(store.resolve(other).position().x == 5.0f);
+
+    // ids of another type never resolve into this one
+    CHECK(!store.resolve(EntityId(EntityType::GOOMBA, other.slot(), other.generation())).valid());
+
+    // spawning below the reserved count does not grow the pool
+    store.reserve(64u);
+    const size_t reserved = store.memoryUsage();
+    for (uint32_t i = 0u; i < 60u; i++) {
+        store.spawn(EntityType::GOOMBA, { 0.0f, 0.0f });
+    }
+    CHECK(store.memoryUsage() == reserved);
+}
+
+TEST_CASE(entity_store_holds_100k_of_one_type)
+{
+    // every slot the id can address is usable, and the pool refuses the one after
+    EntityStore store;
+    EntityBlock& block = store.block(EntityType::GOOMBA);
+    block.reserve(EntityBlock::MAX_SLOTS);
+    CHECK(EntityBlock::MAX_SLOTS >= 100000u);
+
+    EntityId last;
+    for (uint32_t i = 0u; i < EntityBlock::MAX_SLOTS; i++) {
+        last = store.spawn(EntityType::GOOMBA, { static_cast<float>(i), 2.0f });
+    }
+    CHECK(block.size() == EntityBlock::MAX_SLOTS);
+    CHECK(last.slot() == EntityBlock::MAX_SLOTS - 1u);
+    CHECK(store.resolve(last).valid());
+    CHECK(store.resolve(last).position().x == static_cast<float>(EntityBlock::MAX_SLOTS - 1u));
+    CHECK(block.push({ 0.0f, 0.0f }, { 0.0f, 0.0f }, { 1.0f, 1.0f }) == EntityBlock::NO_SLOT);
+}
+
+TEST_CASE(motion_integrate_matches_scalar)
+{
+    const motion::MotionParams params{ 0.02f, 0.5f, 0.9f, false };
+
+    // counts that leave a tail after every vector width
+    for (const uint32_t count : { 1u, 2u, 3u, 5u, 8u, 13u, 1001u }) {
+        std::mt19937 random(count);
+        std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+        std::vector<glm::vec2> positions(count), velocities(count);
+        for (uint32_t i = 0u; i < count; i++) {
+            positions[i] = { value(random) * 100.0f, value(random) * 10.0f };
+            velocities[i] = { value(random), value(random) };
+        }
+
+        motion::setIsa(motion::Isa::SCALAR);
+        std::vector<glm::vec2> scalarPositions = positions, scalarVelocities = velocities;
+        for (int tick = 0; tick < 30; tick++) {
+            motion::integrate(scalarPositions.data(), scalarVelocities.data(), count, params);
+        }
+
+        for (const motion::Isa isa : { motion::Isa::SSE2, motion::Isa::AVX }) {
+            motion::setIsa(isa);
+            if (motion::activeIsa() != isa) { continue; }
+
+            std::vector<glm::vec2> p = positions, v = velocities;
+            for (int tick = 0; tick < 30; tick++) {
+                motion::integrate(p.data(), v.data(), count, params);
+            }
+            // the same operations in the same order, so the same bits
+            CHECK(std::memcmp(p.data(), scalarPositions.data(), count * sizeof(glm::vec2)) == 0);
+            CHECK(std::memcmp(v.data(), scalarVelocities.data(), count * sizeof(glm::vec2)) == 0);
+
+            std::vector<glm::vec2> velocityOnly = velocities;
+            std::vector<glm::vec2> scalarVelocityOnly = velocities;
+            motion::integrateVelocity(velocityOnly.data(), count, params);
+            motion::setIsa(motion::Isa::SCALAR);
+            motion::integrateVelocity(scalarVelocityOnly.data(), count, params);
+            CHECK(std::memcmp(velocityOnly.data(), scalarVelocityOnly.data(), count * sizeof(glm::vec2)) == 0);
+        }
+    }
+
+    motion::setIsa(motion::detectIsa());
+}
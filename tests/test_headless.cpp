@@ -0,0 +1,29 @@
+#include "test.h"
+#include "fixtures.h"
+
+#include "../src/app/headless.h"
+#include "../src/core/profiler/alloc_tracker.h"
+
+TEST_CASE(headless_replay_allocates_nothing)
+{
+#if !ENABLE_ALLOC_TRACKING
+    SKIP("allocations are only counted in builds with -DPLATFORMER_ALLOC_TRACKING=ON");
+#else
+    // the replay --headless 600 --replay plays, recorded the way a player's controller records it
+    const std::string path = test::outputPath("alloc_budget.inp");
+    Controller controller;
+    controller.replay(fixtures::scriptedInput(600u));
+    controller.startRecording();
+    for (int t = 0; t < 600; t++) {
+        controller.poll();
+    }
+    const Controller* controllers[] = { &controller };
+    if (!CHECK(input::saveRecording(path, controllers, 1u) == 0)) { return; }
+
+    // every frame after the warmup, the whole frame and not only the pipeline
+    HeadlessOptions options;
+    options.replayPath = path.c_str();
+    options.allocBudget = 0;
+    CHECK(runHeadless(options) == 0);
+#endif
+}
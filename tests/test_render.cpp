@@ -0,0 +1,77 @@
+#include "test.h"
+
+#include <cstdint>
+
+#include "../src/app/headless.h"
+#include "../src/core/profiler/profiler.h"
+#include "../src/graphics/clip_table.h"
+#include "../src/graphics/gpu_timer.h"
+#include "../src/graphics/recording_backend.h"
+#include "../src/graphics/sprite_atlas.h"
+
+TEST_CASE(clip_table_resolves_like_the_animation_table)
+{
+    SpriteAtlas atlas;
+    loadHeadlessAtlas(atlas);
+    const AnimationTable& animations = atlas.getAnimations();
+    const ClipTable& clips = atlas.getClipTable();
+    if (!CHECK(animations.clipCount() >= Clips::COUNT)) { return; }
+
+    // starts and ticks around 0 and around the wrap of the 32 bit tick, ticks before the start included
+    const uint32_t starts[] = { 0u, 7u, 1000u, UINT32_MAX - 40u, UINT32_MAX };
+    for (uint32_t c = 1u; c < animations.clipCount(); c++) {
+        for (const uint32_t start : starts) {
+            const Vertex vertex{ { 0.0f, 0.0f }, { 0.0f, 0.0f }, c, start };
+            for (uint32_t offset = 0u; offset < 300u; offset++) {
+                const uint32_t tick = start - 50u + offset;
+                const Sprite& sprite = atlas.getSprite(animations.frame(static_cast<uint16_t>(c), start, tick));
+                for (uint32_t corner = 0u; corner < 4u; corner++) {
+                    const glm::vec2 uv = clips.resolve(vertex, corner, tick);
+                    const float x = (corner & 1u) ? sprite.bottomRight.x : sprite.topLeft.x;
+                    const float y = (corner & 2u) ? sprite.bottomRight.y : sprite.topLeft.y;
+                    if (!CHECK(uv.x == x && uv.y == y)) { return; }
+                }
+            }
+        }
+    }
+
+    // vertices playing no clip keep their own texture coordinates
+    const Vertex still{ { 0.0f, 0.0f }, { 0.25f, 0.5f }, Clips::NONE, 0u };
+    CHECK(clips.resolve(still, 3u, 123u).x == 0.25f);
+    CHECK(clips.resolve(still, 3u, 123u).y == 0.5f);
+}
+
+TEST_CASE(null_gpu_timer_records_nothing)
+{
+    // what a headless frame does with its backend's timer, around a scope of the CPU's
+    RecordingBackend backend;
+    GpuTimer& timer = backend.getGpuTimer();
+    profiler::setEnabled(true);
+    profiler::setThreadName("main");
+
+    for (int f = 0; f < 10; f++) {
+        {
+            PROFILE_SCOPE("frame");
+            GpuPass frame(&timer, "frame");
+            GpuPass sprites(&timer, "sprites");
+        }
+        timer.begin("lines");
+        timer.end();
+        timer.endFrame();
+        profiler::endFrame();
+    }
+
+    CHECK(timer.getLastFrameMs() == 0.0);
+    CHECK(profiler::getDroppedCount() == 0u);
+
+    // no track was made for it, and every event of every frame is the CPU's scope
+    for (uint32_t t = 0u; t < profiler::threadCount(); t++) {
+        CHECK(profiler::getThreadName(static_cast<uint16_t>(t)) != "GPU");
+    }
+    if (!CHECK(profiler::frameCount() == 10u)) { return; }
+    for (uint32_t age = 0u; age < profiler::frameCount(); age++) {
+        const profiler::Frame& frame = profiler::getFrame(age);
+        if (!CHECK(frame.events.size() == 1u)) { continue; }
+        CHECK(profiler::getThreadName(frame.events[0].thread) == "main");
+    }
+}
@@ -0,0 +1,157 @@
+#include "test.h"
+#include "fixtures.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "../src/core/level/level.h"
+#include "../src/core/level/entity/entity_pkg.h"
+#include "../src/core/serializer.h"
+#include "../src/graphics/sprite_ids.h"
+
+namespace {
+
+    constexpr int WIDTH = 70;
+    constexpr int HEIGHT = 12;
+
+    // a tile that tells its position apart from every other, and a few solid ones
+    Tile tileAt(int x, int y) {
+        if (y == 0) { return Tile(TC_Type::STRENGTH_3, Sprites::GROUND_1); }
+        if ((x + y) % 9 == 0) { return Tile(TC_Type::STRENGTH_1, Sprites::BRICK_TOP); }
+        if ((x * 3 + y) % 11 == 0) { return Tile(TC_Type::COIN, Sprites::COIN_1); }
+        return Tile();
+    }
+
+    // what versions 1 and 2 wrote : the headers, every tile as 32 bits, and only the count of the entities
+    void writeOldLevel(const std::string& path, uint32_t version) {
+        std::ofstream out(path, std::ios::binary);
+        const serializer::detail::FileHeader fileHeader{ serializer::detail::FILE_IDENTITY, version };
+        const serializer::detail::TileDataHeader tileDataHeader{ WIDTH, HEIGHT };
+        out.write((const char*)&fileHeader, sizeof(fileHeader));
+        out.write((const char*)&tileDataHeader, sizeof(tileDataHeader));
+
+        const bool columnMajor = version >= 2u;
+        const int outer = columnMajor ? WIDTH : HEIGHT;
+        const int inner = columnMajor ? HEIGHT : WIDTH;
+        for (int i = 0; i < outer; i++) {
+            for (int j = 0; j < inner; j++) {
+                const uint32_t packed = columnMajor ? tileAt(i, j).mData : tileAt(j, i).mData;
+                out.write((const char*)&packed, sizeof(packed));
+            }
+        }
+
+        const serializer::detail::EntityDataHeader entityDataHeader{ 3u };
+        out.write((const char*)&entityDataHeader, sizeof(entityDataHeader));
+    }
+
+    bool tilesMatch(const Level& level) {
+        if (level.width != WIDTH || level.height != HEIGHT) { return false; }
+        for (int x = 0; x < WIDTH; x++) {
+            for (int y = 0; y < HEIGHT; y++) {
+                if (level.getTile(x, y).mData != tileAt(x, y).mData) { return false; }
+                if (level.solidMask.test(x, y) != tileAt(x, y).solid()) { return false; }
+            }
+        }
+        return true;
+    }
+
+    uint32_t countOf(Level& level, EntityType type) {
+        return level.entities.block(type).size();
+    }
+}
+
+TEST_CASE(serializer_loads_version_1)
+{
+    const std::string path = test::outputPath("version_1.lvl");
+    writeOldLevel(path, 1u);
+
+    // the file has no entities to give, the level keeps its own
+    Level level;
+    level.addEntity(EntityType::GOOMBA, { 5.0f, 1.0f });
+    CHECK(serializer::loadLevel(&level, path) == 0);
+    CHECK(tilesMatch(level));
+    CHECK(level.getEntityCount() == 1u);
+}
+
+TEST_CASE(serializer_loads_version_2)
+{
+    const std::string path = test::outputPath("version_2.lvl");
+    writeOldLevel(path, 2u);
+
+    Level level;
+    level.addEntity(EntityType::GOOMBA, { 5.0f, 1.0f });
+    CHECK(serializer::loadLevel(&level, path) == 0);
+    CHECK(tilesMatch(level));
+    CHECK(level.getEntityCount() == 1u);
+}
+
+TEST_CASE(serializer_loads_version_3)
+{
+    const std::string path = test::outputPath("version_3.lvl");
+
+    Level saved;
+    saved.resizeTiles(WIDTH, HEIGHT);
+    for (int x = 0; x < WIDTH; x++) {
+        for (int y = 0; y < HEIGHT; y++) {
+            saved.addTile(tileAt(x, y), x, y);
+        }
+    }
+    saved.addEntity(EntityType::GOOMBA, { 4.0f, 1.0f });
+    saved.addEntity(EntityType::GOOMBA, { 9.5f, 3.0f });
+    saved.addEntity(EntityType::GREEN_KOOPA, { 20.0f, 1.0f });
+    if (!CHECK(serializer::saveLevel(&saved, path) == 0)) { return; }
+
+    // the level's own entities are replaced by the file's
+    Level level;
+    level.addEntity(EntityType::RED_KOOPA, { 5.0f, 1.0f });
+    CHECK(serializer::loadLevel(&level, path) == 0);
+    CHECK(tilesMatch(level));
+    CHECK(level.getEntityCount() == 3u);
+    CHECK(countOf(level, EntityType::GOOMBA) == 2u);
+    CHECK(countOf(level, EntityType::GREEN_KOOPA) == 1u);
+    CHECK(countOf(level, EntityType::RED_KOOPA) == 0u);
+
+    const EntityBlock& goombas = level.entities.block(EntityType::GOOMBA);
+    if (CHECK(goombas.size() == 2u)) {
+        CHECK(goombas.position[0].x == 4.0f);
+        CHECK(goombas.position[1].x == 9.5f);
+        CHECK(goombas.position[1].y == 3.0f);
+    }
+
+    // a file that is not a level is refused
+    std::ofstream(test::outputPath("not_a_level.lvl"), std::ios::binary) << "not a level";
+    CHECK(serializer::loadLevel(&level, test::outputPath("not_a_level.lvl")) == -1);
+    CHECK(serializer::loadLevel(&level, test::outputPath("missing.lvl")) == -1);
+}
+
+TEST_CASE(serializer_rejects_bad_level_sizes)
+{
+    // a header alone, with whatever size it claims and none of the tiles
+    const auto writeHeader = [](const std::string& path, uint32_t width, uint32_t height) {
+        std::ofstream out(path, std::ios::binary);
+        const serializer::detail::FileHeader fileHeader{ serializer::detail::FILE_IDENTITY, serializer::detail::FILE_VERSION };
+        const serializer::detail::TileDataHeader tileDataHeader{ width, height };
+        out.write((const char*)&fileHeader, sizeof(fileHeader));
+        out.write((const char*)&tileDataHeader, sizeof(tileDataHeader));
+    };
+
+    Level level;
+    level.resizeTiles(WIDTH, HEIGHT);
+
+    const std::string path = test::outputPath("bad_size.lvl");
+    writeHeader(path, 0u, HEIGHT);
+    CHECK(serializer::loadLevel(&level, path) == -1);
+    writeHeader(path, WIDTH, 0u);
+    CHECK(serializer::loadLevel(&level, path) == -1);
+    writeHeader(path, 0xFFFFFFFFu, HEIGHT);
+    CHECK(serializer::loadLevel(&level, path) == -1);
+    writeHeader(path, 0x7FFFFFFFu, 0x7FFFFFFFu);
+    CHECK(serializer::loadLevel(&level, path) == -1);
+    // a size that fits in memory but not in the file
+    writeHeader(path, WIDTH, HEIGHT);
+    CHECK(serializer::loadLevel(&level, path) == -1);
+
+    // a refused file leaves the level as it was
+    CHECK(level.width == WIDTH);
+    CHECK(level.height == HEIGHT);
+}
@@ -0,0 +1,60 @@
+#include "test.h"
+#include "fixtures.h"
+
+#include <map>
+
+#include "../src/core/level/level.h"
+#include "../src/core/level/snapshot.h"
+
+namespace {
+
+    constexpr uint32_t TICKS = 200u;
+
+    // ticks the level with the scripted input, noting the state hash of every tick it ends on
+    void simulate(Level& level, const std::vector<InputState>& input, uint64_t until, std::map<uint64_t, uint64_t>& hashes) {
+        while (level.tick < until) {
+            level.getPlayer(0)->handleInput(input[level.tick]);
+            level.update();
+            hashes[level.tick] = level.getStateHash().total;
+        }
+    }
+}
+
+TEST_CASE(snapshot_restore_round_trip)
+{
+    Level level;
+    fixtures::loadStage(level);
+
+    SnapshotRing snapshots(TICKS);
+    level.snapshots = &snapshots;
+    snapshots.capture(level);
+
+    const std::vector<InputState> input = fixtures::scriptedInput(TICKS * 2u);
+    std::map<uint64_t, uint64_t> hashes;
+    hashes[level.tick] = level.getStateHash().total;
+    simulate(level, input, TICKS, hashes);
+    CHECK(snapshots.newestTick() == TICKS);
+
+    // a tick just behind, one on a keyframe, one between keyframes and the oldest, each from further back
+    for (const uint32_t back : { 1u, 24u, 45u, TICKS - 1u }) {
+        const uint64_t newest = level.tick;
+        const uint64_t tick = newest - back;
+        if (!CHECK(snapshots.restore(level, tick))) { continue; }
+        CHECK(level.tick == tick);
+        CHECK(level.getStateHash().total == hashes[tick]);
+        CHECK(snapshots.newestTick() == tick);
+
+        // the restored state simulates into the same ticks again
+        std::map<uint64_t, uint64_t> again;
+        simulate(level, input, newest, again);
+        for (const auto& resimulated : again) {
+            if (!CHECK(resimulated.second == hashes[resimulated.first])) { break; }
+        }
+    }
+
+    // restoring outside the ring fails, and leaves the level as it was
+    const uint64_t hash = level.getStateHash().total;
+    CHECK(!snapshots.restore(level, level.tick + 1u));
+    CHECK(!snapshots.restore(level, snapshots.oldestTick() - 1u));
+    CHECK(level.getStateHash().total == hash);
+}
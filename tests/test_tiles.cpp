@@ -0,0 +1,136 @@
+#include "test.h"
+#include "fixtures.h"
+
+#include <random>
+
+#include "../src/core/level/level.h"
+#include "../src/core/level/collider/tile_collision.h"
+#include "../src/graphics/sprite_ids.h"
+
+namespace {
+
+    bool scanSolid(const Level& level, int x0, int y0, int x1, int y1) {
+        bool solid = false;
+        level.forEachTile(x0, y0, x1, y1, [&solid](int, int, const Tile& tile) {
+            solid = solid || tile.solid();
+        });
+        return solid;
+    }
+}
+
+TEST_CASE(solid_mask_matches_tiles)
+{
+    // wider than two words a row, so rectangles start and end inside, across and on the edges of words
+    Level level;
+    level.resizeTiles(200, 20);
+
+    std::mt19937 random(3u);
+    for (int i = 0; i < 300; i++) {
+        const int x = static_cast<int>(random() % 200u);
+        const int y = static_cast<int>(random() % 20u);
+        const uint32_t kind = random() % 3u;
+        level.addTile(kind == 0u ? Tile(TC_Type::STRENGTH_3, Sprites::STONE) : kind == 1u ? Tile(TC_Type::COIN, Sprites::COIN_1) : Tile(), x, y);
+    }
+
+    for (int x = 0; x < 200; x++) {
+        for (int y = 0; y < 20; y++) {
+            CHECK(level.solidMask.test(x, y) == level.getTile(x, y).solid());
+        }
+    }
+
+    // some hang over the level, which both clip
+    for (int i = 0; i < 5000; i++) {
+        const int x0 = static_cast<int>(random() % 210u) - 5;
+        const int y0 = static_cast<int>(random() % 24u) - 2;
+        const int x1 = x0 + static_cast<int>(random() % 80u);
+        const int y1 = y0 + static_cast<int>(random() % 6u);
+        if (!CHECK(level.solidMask.anySolid(x0, y0, x1, y1) == scanSolid(level, x0, y0, x1, y1))) { break; }
+    }
+
+    CHECK(!level.solidMask.test(-1, 0));
+    CHECK(!level.solidMask.test(200, 0));
+    CHECK(!level.solidMask.anySolid(10, 5, 9, 5));
+}
+
+TEST_CASE(sweep_falls_onto_the_ground)
+{
+    Level level;
+    fixtures::buildGround(level, 64, 16);
+
+    glm::vec2 position{ 4.0f, 6.0f };
+    glm::vec2 velocity{ 0.0f, -1.5f };
+    const glm::vec2 dimensions{ 1.0f, 1.0f };
+
+    uint8_t hits = collision::HIT_NONE;
+    for (int i = 0; i < 10 && hits == collision::HIT_NONE; i++) {
+        velocity.y = -1.5f;
+        hits = collision::sweep(level, position, velocity, dimensions);
+    }
+
+    CHECK(hits == collision::HIT_GROUND);
+    CHECK(position.x == 4.0f);
+    CHECK(position.y == 2.0f);
+    CHECK(velocity.y == 0.0f);
+}
+
+TEST_CASE(sweep_stops_fast_movers_at_walls)
+{
+    Level level;
+    fixtures::buildGround(level, 64, 16);
+    for (int y = 2; y < 5; y++) {
+        level.addTile(Tile(TC_Type::STRENGTH_3, Sprites::STONE), 20, y);
+    }
+
+    // 12 tiles in one tick, over the wall's single column
+    collision::TileContactBuffer contacts;
+    glm::vec2 position{ 10.0f, 2.0f };
+    glm::vec2 velocity{ 12.0f, 0.0f };
+    const glm::vec2 dimensions{ 1.0f, 2.0f };
+    const uint8_t hits = collision::sweep(level, position, velocity, dimensions, 7u, &contacts);
+
+    CHECK(hits == collision::HIT_WALL);
+    CHECK(position.x == 19.0f);
+    CHECK(position.y == 2.0f);
+    CHECK(velocity.x == 0.0f);
+
+    // the two tiles of the wall beside the box
+    if (CHECK(contacts.count == 2u)) {
+        for (uint32_t c = 0u; c < contacts.count; c++) {
+            CHECK(contacts.contacts[c].x == 20);
+            CHECK(contacts.contacts[c].side == collision::TileSide::RIGHT);
+            CHECK(contacts.contacts[c].entity == 7u);
+        }
+    }
+
+    // going back left is free, touching the wall is not overlapping it
+    velocity = { -3.0f, 0.0f };
+    CHECK(collision::sweep(level, position, velocity, dimensions) == collision::HIT_NONE);
+    CHECK(position.x == 16.0f);
+}
+
+TEST_CASE(sweep_hits_ceilings_and_ignores_coins)
+{
+    Level level;
+    fixtures::buildGround(level, 64, 16);
+    level.addTile(Tile(TC_Type::STRENGTH_1, Sprites::BRICK_TOP), 8, 6);
+    level.addTile(Tile(TC_Type::COIN, Sprites::COIN_1), 8, 4);
+
+    collision::TileContactBuffer contacts;
+    glm::vec2 position{ 8.0f, 2.0f };
+    glm::vec2 velocity{ 0.0f, 5.0f };
+    const glm::vec2 dimensions{ 1.0f, 1.0f };
+    const uint8_t hits = collision::sweep(level, position, velocity, dimensions, 0u, &contacts);
+
+    CHECK(hits == collision::HIT_CEILING);
+    CHECK(position.y == 5.0f);
+    if (CHECK(contacts.count == 1u)) {
+        CHECK(contacts.contacts[0].type == TC_Type::STRENGTH_1);
+        CHECK(contacts.contacts[0].side == collision::TileSide::TOP);
+    }
+
+    // a box straddling two columns is stopped by either
+    position = { 7.5f, 2.0f };
+    velocity = { 0.0f, 5.0f };
+    CHECK(collision::sweep(level, position, velocity, dimensions) == collision::HIT_CEILING);
+    CHECK(position.y == 5.0f);
+}